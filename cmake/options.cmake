@@ -11,6 +11,7 @@ option(BUILD_AHBOT          "Build Auction House Bot mod"           OFF)
 option(BUILD_METRICS        "Build Metrics, generate data for Grafana" OFF)
 option(BUILD_RECASTDEMOMOD  "Build map/vmap/mmap viewer"            OFF)
 option(BUILD_GIT_ID         "Build git_id"                          OFF)
+option(BUILD_BENCHMARKS     "Build micro-benchmarks"                OFF)
 option(BUILD_DOCS           "Build documentation with doxygen"      OFF)
 
 # TODO: options that should be checked/created:
@@ -37,6 +38,7 @@ message(STATUS
     BUILD_METRICS           Build Metrics, generate data for Grafana
     BUILD_RECASTDEMOMOD     Build map/vmap/mmap viewer
     BUILD_GIT_ID            Build git_id
+    BUILD_BENCHMARKS        Build micro-benchmarks of optimized core code
     BUILD_DOCS              Build documentation with doxygen
 
   To set an option simply type -D<OPTION>=<VALUE> after 'cmake <srcs>'.
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Bounded damerau_levenshtein_distance used by the antispam repetition check against the full matrix
+// version. Messages are random chat-like strings, a part of them edited copies of others so that the
+// threshold is hit as well as missed. Usage: dldist_benchmark [messages] [threshold] [seed]
+
+#include "Anticheat/module/dldist.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string RandomMessage(std::mt19937& rng, size_t minLength, size_t maxLength)
+    {
+        static char const alphabet[] = "abcdefghijklmnopqrstuvwxyz      0123456789!?.,";
+        std::uniform_int_distribution<size_t> length(minLength, maxLength);
+        std::uniform_int_distribution<size_t> letter(0, sizeof(alphabet) - 2);
+
+        std::string message(length(rng), ' ');
+        for (char& c : message)
+            c = alphabet[letter(rng)];
+        return message;
+    }
+
+    // a few insertions, deletions, substitutions and transpositions
+    std::string Edit(std::mt19937& rng, std::string message)
+    {
+        std::uniform_int_distribution<int> edits(1, 6);
+        for (int i = edits(rng); i > 0 && message.size() > 2; --i)
+        {
+            size_t const pos = std::uniform_int_distribution<size_t>(0, message.size() - 2)(rng);
+            switch (std::uniform_int_distribution<int>(0, 3)(rng))
+            {
+                case 0: message.insert(message.begin() + pos, 'x'); break;
+                case 1: message.erase(message.begin() + pos); break;
+                case 2: message[pos] = 'z'; break;
+                default: std::swap(message[pos], message[pos + 1]); break;
+            }
+        }
+        return message;
+    }
+
+    template <typename Function>
+    double Measure(Function const& function)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t const count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    int const threshold = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::mt19937 rng(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1);
+
+    // mostly typical chat lengths, some past 64 characters to cover the row by row version
+    std::vector<std::string> messages;
+    messages.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i && std::uniform_int_distribution<int>(0, 2)(rng) == 0)
+            messages.push_back(Edit(rng, messages[std::uniform_int_distribution<size_t>(0, i - 1)(rng)]));
+        else
+            messages.push_back(RandomMessage(rng, 20, i % 8 ? 80 : 160));
+    }
+
+    std::vector<int> full(count * count);
+    std::vector<int> bounded(count * count);
+
+    double const fullTime = Measure([&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+            for (size_t j = 0; j < count; ++j)
+                full[i * count + j] = nam::damerau_levenshtein_distance(messages[i], messages[j]);
+    });
+
+    double const boundedTime = Measure([&]()
+    {
+        for (size_t i = 0; i < count; ++i)
+            for (size_t j = 0; j < count; ++j)
+                bounded[i * count + j] = nam::damerau_levenshtein_distance(messages[i], messages[j], threshold);
+    });
+
+    size_t mismatches = 0;
+    size_t below = 0;
+    for (size_t i = 0; i < count * count; ++i)
+    {
+        int const expected = std::min(full[i], threshold);
+        if (bounded[i] != expected)
+        {
+            if (++mismatches <= 10)
+                std::printf("mismatch: \"%s\" / \"%s\": full %d, bounded %d, threshold %d\n",
+                            messages[i / count].c_str(), messages[i % count].c_str(), full[i], bounded[i], threshold);
+        }
+        if (full[i] < threshold)
+            ++below;
+    }
+
+    std::printf("%zu pairs, %zu below threshold %d\n", count * count, below, threshold);
+    std::printf("full matrix: %.2f ms, bounded: %.2f ms, %.1fx\n", fullTime, boundedTime, boundedTime > 0.0 ? fullTime / boundedTime : 0.0);
+
+    if (mismatches)
+    {
+        std::printf("%zu mismatches\n", mismatches);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// EventProcessor timing wheel against the multimap based processor it replaced. The first part runs
+// random add, kill, reschedule, update and abort sequences on both and fails on any difference in
+// which events execute or abort, in which order and at which time. The second part times units with
+// periodic events plus spell style one shots and an AI notify style event that is killed and re-added.
+// Usage: eventprocessor_benchmark [differential rounds] [units] [seed]
+
+#include "Utilities/EventProcessor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // the processor as it was before the timing wheel
+    class MultimapEvent
+    {
+        public:
+            MultimapEvent() : to_Abort(false), m_addTime(0), m_execTime(0) {}
+            virtual ~MultimapEvent() {}
+
+            virtual bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) { return true; }
+            virtual bool IsDeletable() const { return true; }
+            virtual void Abort(uint64 /*e_time*/) {}
+
+            bool to_Abort;
+            uint64 m_addTime;
+            uint64 m_execTime;
+    };
+
+    class MultimapEventProcessor
+    {
+        public:
+            MultimapEventProcessor() : m_time(0), m_aborting(false) {}
+            ~MultimapEventProcessor() { KillAllEvents(true); }
+
+            void Update(uint32 p_time)
+            {
+                m_time += p_time;
+
+                EventList::iterator i;
+                while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+                {
+                    MultimapEvent* event = i->second;
+                    m_events.erase(i);
+
+                    if (!event->to_Abort)
+                    {
+                        if (event->Execute(m_time, p_time))
+                            delete event;
+                    }
+                    else
+                    {
+                        event->Abort(m_time);
+                        delete event;
+                    }
+                }
+            }
+
+            void KillAllEvents(bool force)
+            {
+                m_aborting = true;
+
+                for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+                {
+                    EventList::iterator i_old = i;
+                    ++i;
+
+                    i_old->second->to_Abort = true;
+                    i_old->second->Abort(m_time);
+                    if (force || i_old->second->IsDeletable())
+                    {
+                        delete i_old->second;
+
+                        if (!force)
+                            m_events.erase(i_old);
+                    }
+                }
+
+                if (force)
+                    m_events.clear();
+            }
+
+            void KillEvent(MultimapEvent* event)
+            {
+                for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
+                {
+                    if (iter->second == event)
+                    {
+                        delete iter->second;
+                        iter = m_events.erase(iter);
+                    }
+                    else
+                        ++iter;
+                }
+            }
+
+            void AddEvent(MultimapEvent* event, uint64 e_time, bool set_addtime = true)
+            {
+                if (set_addtime)
+                    event->m_addTime = m_time;
+
+                event->m_execTime = e_time;
+                m_events.insert(std::pair<uint64, MultimapEvent*>(e_time, event));
+            }
+
+            void ModifyEventTime(MultimapEvent* event, uint64 msTime)
+            {
+                for (EventList::iterator itr = m_events.begin(); itr != m_events.end(); ++itr)
+                {
+                    if (itr->second != event)
+                        continue;
+
+                    event->m_execTime = msTime;
+                    m_events.erase(itr);
+                    m_events.insert(std::pair<uint64, MultimapEvent*>(msTime, event));
+                    break;
+                }
+            }
+
+            uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+
+        private:
+            typedef std::multimap<uint64, MultimapEvent*> EventList;
+
+            uint64 m_time;
+            EventList m_events;
+            bool m_aborting;
+    };
+
+    typedef std::vector<std::pair<int, uint64> > EventLog;  // event id, negative when aborted, and time
+
+    // logs execution and abort, re-adds itself 'repeats' times like periodic events do
+    template<class Base, class Processor>
+    class LoggedEvent : public Base
+    {
+        public:
+            LoggedEvent(int id, Processor& processor, EventLog& log, std::set<int>& live, int repeats)
+                : m_id(id), m_processor(processor), m_log(log), m_live(live), m_repeats(repeats) { m_live.insert(m_id); }
+            ~LoggedEvent() { m_live.erase(m_id); }
+
+            bool Execute(uint64 e_time, uint32 /*p_time*/) override
+            {
+                m_log.push_back(std::make_pair(m_id, e_time));
+                if (m_repeats <= 0)
+                    return true;
+
+                --m_repeats;
+                m_processor.AddEvent(this, m_processor.CalculateTime(1 + m_id * 7919u % 300));
+                return false;
+            }
+
+            void Abort(uint64 e_time) override { m_log.push_back(std::make_pair(-m_id, e_time)); }
+
+        private:
+            int m_id;
+            Processor& m_processor;
+            EventLog& m_log;
+            std::set<int>& m_live;
+            int m_repeats;
+    };
+
+    template<class Base, class Processor>
+    struct Side
+    {
+        typedef LoggedEvent<Base, Processor> Event;
+
+        // declared first so the processor deletes its events while they can still log
+        EventLog log;
+        std::set<int> live;
+        std::map<int, Event*> events;
+        Processor processor;
+    };
+
+    // returns false and prints the first difference on mismatch
+    bool RunDifferentialRound(std::mt19937& rng, int round)
+    {
+        Side<BasicEvent, EventProcessor> wheel;
+        Side<MultimapEvent, MultimapEventProcessor> multimap;
+
+        // start at some arbitrary point of the wheel
+        uint32 const start = rng() % 100000;
+        wheel.processor.Update(start);
+        multimap.processor.Update(start);
+
+        int nextId = 1;
+        for (int step = 0; step < 3000; ++step)
+        {
+            uint32 const op = rng() % 9;
+            if (op < 5)
+            {
+                // mostly within the first wheel levels, some beyond the wheel span into the overflow list
+                uint32 const kind = rng() % 20;
+                uint64 const delay = kind < 2 ? 0 : kind < 15 ? rng() % 400 : kind < 18 ? rng() % 70000 : rng() % 300000;
+                int const repeats = rng() % 4 == 0 ? int(rng() % 3) : 0;
+                int const id = nextId++;
+
+                auto* a = new Side<BasicEvent, EventProcessor>::Event(id, wheel.processor, wheel.log, wheel.live, repeats);
+                auto* b = new Side<MultimapEvent, MultimapEventProcessor>::Event(id, multimap.processor, multimap.log, multimap.live, repeats);
+                wheel.processor.AddEvent(a, wheel.processor.CalculateTime(delay));
+                multimap.processor.AddEvent(b, multimap.processor.CalculateTime(delay));
+                wheel.events[id] = a;
+                multimap.events[id] = b;
+            }
+            else if (op < 7)
+            {
+                uint32 const diff = rng() % 8 == 0 ? rng() % 100000 : rng() % 120;
+                wheel.processor.Update(diff);
+                multimap.processor.Update(diff);
+            }
+            else
+            {
+                if (wheel.events.empty())
+                    continue;
+
+                auto itr = wheel.events.begin();
+                std::advance(itr, rng() % wheel.events.size());
+                int const id = itr->first;
+
+                bool const queued = wheel.live.count(id) != 0;
+                if (queued != (multimap.live.count(id) != 0))
+                {
+                    std::printf("round %d: event %d alive in only one processor\n", round, id);
+                    return false;
+                }
+
+                if (!queued)
+                {
+                    wheel.events.erase(id);
+                    multimap.events.erase(id);
+                    continue;
+                }
+
+                if (op == 7)
+                {
+                    wheel.processor.KillEvent(wheel.events[id]);
+                    multimap.processor.KillEvent(multimap.events[id]);
+                    wheel.events.erase(id);
+                    multimap.events.erase(id);
+                }
+                else
+                {
+                    uint64 const delay = rng() % 5000;
+                    wheel.processor.ModifyEventTime(wheel.events[id], wheel.processor.CalculateTime(delay));
+                    multimap.processor.ModifyEventTime(multimap.events[id], multimap.processor.CalculateTime(delay));
+                }
+            }
+        }
+
+        // run out everything, every other round abort what is left instead
+        if (round % 2)
+        {
+            wheel.processor.KillAllEvents(false);
+            multimap.processor.KillAllEvents(false);
+        }
+        else
+        {
+            wheel.processor.Update(400000);
+            multimap.processor.Update(400000);
+        }
+
+        if (wheel.log == multimap.log)
+            return true;
+
+        std::printf("round %d: %zu events logged, expected %zu\n", round, wheel.log.size(), multimap.log.size());
+        for (size_t i = 0; i < std::min(wheel.log.size(), multimap.log.size()); ++i)
+        {
+            if (wheel.log[i] != multimap.log[i])
+            {
+                std::printf("first difference at %zu: %d at %llu, expected %d at %llu\n", i,
+                            wheel.log[i].first, (unsigned long long)wheel.log[i].second,
+                            multimap.log[i].first, (unsigned long long)multimap.log[i].second);
+                break;
+            }
+        }
+        return false;
+    }
+
+    template<class Base, class Processor>
+    class PeriodicEvent : public Base
+    {
+        public:
+            PeriodicEvent(Processor& processor, uint32 period) : m_processor(processor), m_period(period) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                m_processor.AddEvent(this, m_processor.CalculateTime(m_period));
+                return false;
+            }
+
+        private:
+            Processor& m_processor;
+            uint32 m_period;
+    };
+
+    template<class Base>
+    class OneShotEvent : public Base
+    {
+        public:
+            explicit OneShotEvent(char* alive = nullptr) : m_alive(alive) { if (m_alive) *m_alive = 1; }
+            ~OneShotEvent() { if (m_alive) *m_alive = 0; }
+
+        private:
+            char* m_alive;
+    };
+
+    // 'units' processors updated every 50ms for 1000 ticks
+    template<class Base, class Processor>
+    double RunBenchmark(size_t units, uint32 eventsPerUnit, std::vector<uint32> const& random)
+    {
+        std::vector<char> notifyAlive(units, 0);            // outlives the processors, their events clear it
+        std::vector<Base*> notify(units, nullptr);
+        std::vector<Processor> processors(units);
+        size_t next = 0;
+        auto roll = [&]() { return random[next++ % random.size()]; };
+
+        for (size_t u = 0; u < units; ++u)
+            for (uint32 e = 0; e < eventsPerUnit; ++e)
+                processors[u].AddEvent(new PeriodicEvent<Base, Processor>(processors[u], 200 + roll() % 5000), processors[u].CalculateTime(roll() % 5000));
+
+        auto const start = std::chrono::steady_clock::now();
+        for (uint32 tick = 0; tick < 1000; ++tick)
+        {
+            for (size_t u = 0; u < units; ++u)
+            {
+                Processor& processor = processors[u];
+                uint32 const r = roll();
+
+                // spell travel and delayed effects
+                if (r % 3 == 0)
+                    processor.AddEvent(new OneShotEvent<Base>(), processor.CalculateTime(roll() % 2500));
+
+                // forced AI notify, the pending one is dropped and re-added
+                if (r % 5 == 0)
+                {
+                    if (notifyAlive[u])
+                        processor.KillEvent(notify[u]);
+                    notify[u] = new OneShotEvent<Base>(&notifyAlive[u]);
+                    processor.AddEvent(notify[u], processor.CalculateTime(1000));
+                }
+
+                processor.Update(50);
+            }
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int const rounds = argc > 1 ? std::atoi(argv[1]) : 100;
+    size_t const units = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    std::mt19937 rng(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 7);
+
+    for (int round = 0; round < rounds; ++round)
+        if (!RunDifferentialRound(rng, round))
+            return 1;
+
+    std::printf("%d differential rounds, no difference\n", rounds);
+
+    std::vector<uint32> random(1 << 20);
+    for (uint32& value : random)
+        value = rng();
+
+    for (uint32 events : { 2, 8, 32 })
+    {
+        double const wheelTime = RunBenchmark<BasicEvent, EventProcessor>(units, events, random);
+        double const multimapTime = RunBenchmark<MultimapEvent, MultimapEventProcessor>(units, events, random);
+        std::printf("%zu units, %u periodic events each: wheel %.2f ms, multimap %.2f ms, %.1fx\n",
+                    units, events, wheelTime, multimapTime, wheelTime > 0.0 ? multimapTime / wheelTime : 0.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// GridPackedFilter prefilter followed by the exact check against the exact check alone on every
+// object, the way grid searches ran before. Positions are synthetic, spread over one cell with a
+// crowded center, queries are circles and front and back cones of varying size. Every object the
+// exact check accepts must also pass the filter.
+// Usage: packedfilter_benchmark [objects per cell] [queries] [seed]
+
+#define _USE_MATH_DEFINES
+
+#include "GameSystem/GridPackedFilter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    float const CELL_SIZE = 66.6666f;
+
+    struct TestObject
+    {
+        float x, y, z;
+        float reach;
+        GridPackedSlot slot;
+
+        GridPackedSlot& GetPackedSlot() { return slot; }
+        float GetPositionX() const { return x; }
+        float GetPositionY() const { return y; }
+        float GetPositionZ() const { return z; }
+        float GetCombatReach() const { return reach; }
+    };
+
+    struct Query
+    {
+        float x, y, orientation;
+        float range;                                        // without the searcher combat reach
+        float reach;                                        // searcher combat reach
+        float arc;                                          // 0 for circles, negative for back cones like isInBack
+    };
+
+    float NormalizeOrientation(float o)
+    {
+        float const mod = std::fmod(o, 2.0f * float(M_PI));
+        return mod < 0.0f ? mod + 2.0f * float(M_PI) : mod;
+    }
+
+    // WorldObject::IsWithinDist with combat reach of both sides and HasInArc, in double so float
+    // rounding of the filter is caught as well
+    bool ExactCheck(Query const& query, TestObject const& object)
+    {
+        double const dx = double(object.x) - query.x;
+        double const dy = double(object.y) - query.y;
+        double const dist = std::sqrt(dx * dx + dy * dy) - object.reach - query.reach;
+        if (dist > query.range)
+            return false;
+
+        if (query.arc == 0.0f || (dx == 0.0 && dy == 0.0))
+            return true;
+
+        double angle = std::atan2(dy, dx) - query.orientation;
+        while (angle > M_PI)
+            angle -= 2 * M_PI;
+        while (angle < -M_PI)
+            angle += 2 * M_PI;
+
+        // isInBack(target, distance, -arc) is !HasInArc(target, 2 * pi + arc)
+        if (query.arc > 0.0f)
+            return std::fabs(angle) <= NormalizeOrientation(query.arc) / 2.0;
+        return std::fabs(angle) > NormalizeOrientation(2.0f * float(M_PI) + query.arc) / 2.0;
+    }
+
+    // same setup as SpellNotifierCreatureAndPlayer::GetPackedFilter
+    GridPackedFilter MakeFilter(Query const& query)
+    {
+        GridPackedFilter filter(query.x, query.y, query.range + query.reach);
+        if (query.arc > 0.0f)
+            filter.SetCone(query.orientation, NormalizeOrientation(query.arc) / 2.0f);
+        else if (query.arc < 0.0f)
+            filter.SetCone(query.orientation + float(M_PI), float(M_PI) - NormalizeOrientation(2.0f * float(M_PI) + query.arc) / 2.0f);
+        return filter;
+    }
+
+    template <typename Function>
+    double Measure(Function const& function)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t const count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    size_t const queryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    std::mt19937 rng(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1);
+
+    std::uniform_real_distribution<float> cell(0.0f, CELL_SIZE);
+    std::normal_distribution<float> crowd(CELL_SIZE / 2, 4.0f);
+    std::uniform_real_distribution<float> reach(0.3f, 5.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 2.0f * float(M_PI));
+
+    // objects are allocated apart like real creatures, the list walk of the old search chases pointers
+    std::vector<std::unique_ptr<TestObject> > objects;
+    GridPackedStore<TestObject> store;
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects.emplace_back(new TestObject());
+        TestObject& object = *objects.back();
+        bool const crowded = i % 3 == 0;
+        object.x = crowded ? crowd(rng) : cell(rng);
+        object.y = crowded ? crowd(rng) : cell(rng);
+        object.z = 0.0f;
+        object.reach = reach(rng);
+        store.insert(&object);
+    }
+
+    std::vector<TestObject*> list;
+    for (auto const& object : objects)
+        list.push_back(object.get());
+    std::shuffle(list.begin(), list.end(), rng);
+
+    // an object on the query center too, the cone filter must keep it
+    std::vector<Query> queries(queryCount);
+    for (size_t i = 0; i < queryCount; ++i)
+    {
+        Query& query = queries[i];
+        TestObject const& center = *objects[std::uniform_int_distribution<size_t>(0, count - 1)(rng)];
+        bool const onObject = i % 4 == 0;
+        query.x = onObject ? center.x : cell(rng);
+        query.y = onObject ? center.y : cell(rng);
+        query.orientation = angle(rng);
+        query.range = std::uniform_real_distribution<float>(2.0f, 30.0f)(rng);
+        query.reach = reach(rng);
+        switch (i % 4)
+        {
+            case 0: query.arc = 0.0f; break;
+            case 1: query.arc = std::uniform_real_distribution<float>(0.2f, 2.0f * float(M_PI))(rng); break;
+            case 2: query.arc = -std::uniform_real_distribution<float>(0.2f, 2.0f * float(M_PI))(rng); break;
+            default: query.arc = std::uniform_real_distribution<float>(0.2f, 1.0f)(rng); break;
+        }
+    }
+
+    std::vector<uint32> exact(queryCount);
+    std::vector<uint32> filtered(queryCount);
+    size_t candidates = 0;
+
+    double const exactTime = Measure([&]()
+    {
+        for (size_t i = 0; i < queryCount; ++i)
+            for (TestObject const* object : list)
+                if (ExactCheck(queries[i], *object))
+                    ++exact[i];
+    });
+
+    double const filterTime = Measure([&]()
+    {
+        for (size_t i = 0; i < queryCount; ++i)
+        {
+            Query const& query = queries[i];
+            MakeFilter(query).ForEach(store, [&](uint32 index)
+            {
+                ++candidates;
+                if (ExactCheck(query, *store.object(index)))
+                    ++filtered[i];
+            });
+        }
+    });
+
+    // the filter must never drop an object the exact check accepts
+    size_t mismatches = 0;
+    size_t matches = 0;
+    for (size_t i = 0; i < queryCount; ++i)
+    {
+        matches += exact[i];
+        if (exact[i] != filtered[i] && ++mismatches <= 10)
+            std::printf("mismatch: query %zu (%.3f, %.3f) range %.3f reach %.3f arc %.3f: exact %u, filtered %u\n",
+                        i, queries[i].x, queries[i].y, queries[i].range, queries[i].reach, queries[i].arc, exact[i], filtered[i]);
+    }
+
+    std::printf("%zu objects, %zu queries, %zu matches, %zu filter candidates\n", count, queryCount, matches, candidates);
+    std::printf("exact check only: %.2f ms, filter + exact check: %.2f ms, %.1fx\n", exactTime, filterTime, filterTime > 0.0 ? exactTime / filterTime : 0.0);
+
+    if (mismatches)
+    {
+        std::printf("%zu mismatches\n", mismatches);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GRIDPACKEDFILTER_H
+#define _GRIDPACKEDFILTER_H
+
+#include "GameSystem/GridPackedStore.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GRID_PACKED_FILTER_AVX
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GRID_PACKED_FILTER_SSE
+#endif
+
+/*
+  First stage of range searches over a GridPackedStore. An entry passes when its 2d distance to the
+  center is within range plus its own combat reach and, for cones, its direction lies within the arc.
+  The filter is conservative: it may let through entries the exact check rejects, never the reverse,
+  so the exact check still has to run on every entry passed to the callback.
+*/
+class GridPackedFilter
+{
+    public:
+        GridPackedFilter(float x, float y, float range)
+            : m_x(x), m_y(y), m_range(range * 1.0001f + 0.01f), m_cone(false), m_dirX(0.0f), m_dirY(0.0f), m_cosHalfArc(-1.0f) {}
+
+        // only entries within halfArc of direction 'orientation' pass, halfArc >= pi keeps the full circle
+        void SetCone(float orientation, float halfArc)
+        {
+            halfArc += 0.01f;
+            if (halfArc >= float(M_PI))
+            {
+                m_cone = false;
+                return;
+            }
+
+            m_cone = true;
+            m_dirX = std::cos(orientation);
+            m_dirY = std::sin(orientation);
+            m_cosHalfArc = std::cos(halfArc);
+        }
+
+        // calls f(index) for every entry of 'store' that may pass the exact check, f must not modify the store
+        template<class F>
+        void ForEach(GridPackedPositions const& store, F&& f) const
+        {
+            uint32 const count = store.size();
+            uint32 i = 0;
+
+#ifdef GRID_PACKED_FILTER_AVX
+            for (; i + 8 <= count; i += 8)
+                for (uint32 mask = Mask8(store, i), bit = 0; mask; mask >>= 1, ++bit)
+                    if (mask & 1)
+                        f(i + bit);
+#endif
+#ifdef GRID_PACKED_FILTER_SSE
+            for (; i + 4 <= count; i += 4)
+                for (uint32 mask = Mask4(store, i), bit = 0; mask; mask >>= 1, ++bit)
+                    if (mask & 1)
+                        f(i + bit);
+#endif
+            for (; i < count; ++i)
+                if (Passes(store, i))
+                    f(i);
+        }
+
+    private:
+        static constexpr float SELF_DISTANCE_SQ = 0.0001f;  // always passes, the angle to itself is undefined
+
+        bool Passes(GridPackedPositions const& store, uint32 i) const
+        {
+            float const dx = store.X()[i] - m_x;
+            float const dy = store.Y()[i] - m_y;
+            float const distSq = dx * dx + dy * dy;
+            float const range = m_range + store.Reach()[i];
+            if (distSq > range * range)
+                return false;
+
+            if (!m_cone || distSq < SELF_DISTANCE_SQ)
+                return true;
+
+            return dx * m_dirX + dy * m_dirY >= m_cosHalfArc * std::sqrt(distSq);
+        }
+
+#ifdef GRID_PACKED_FILTER_SSE
+        uint32 Mask4(GridPackedPositions const& store, uint32 i) const
+        {
+            __m128 const dx = _mm_sub_ps(_mm_loadu_ps(store.X() + i), _mm_set1_ps(m_x));
+            __m128 const dy = _mm_sub_ps(_mm_loadu_ps(store.Y() + i), _mm_set1_ps(m_y));
+            __m128 const distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 const range = _mm_add_ps(_mm_loadu_ps(store.Reach() + i), _mm_set1_ps(m_range));
+            __m128 pass = _mm_cmple_ps(distSq, _mm_mul_ps(range, range));
+
+            if (m_cone)
+            {
+                __m128 const dot = _mm_add_ps(_mm_mul_ps(dx, _mm_set1_ps(m_dirX)), _mm_mul_ps(dy, _mm_set1_ps(m_dirY)));
+                __m128 const inArc = _mm_cmpge_ps(dot, _mm_mul_ps(_mm_set1_ps(m_cosHalfArc), _mm_sqrt_ps(distSq)));
+                __m128 const self = _mm_cmplt_ps(distSq, _mm_set1_ps(SELF_DISTANCE_SQ));
+                pass = _mm_and_ps(pass, _mm_or_ps(inArc, self));
+            }
+
+            return uint32(_mm_movemask_ps(pass));
+        }
+#endif
+
+#ifdef GRID_PACKED_FILTER_AVX
+        uint32 Mask8(GridPackedPositions const& store, uint32 i) const
+        {
+            __m256 const dx = _mm256_sub_ps(_mm256_loadu_ps(store.X() + i), _mm256_set1_ps(m_x));
+            __m256 const dy = _mm256_sub_ps(_mm256_loadu_ps(store.Y() + i), _mm256_set1_ps(m_y));
+            __m256 const distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 const range = _mm256_add_ps(_mm256_loadu_ps(store.Reach() + i), _mm256_set1_ps(m_range));
+            __m256 pass = _mm256_cmp_ps(distSq, _mm256_mul_ps(range, range), _CMP_LE_OQ);
+
+            if (m_cone)
+            {
+                __m256 const dot = _mm256_add_ps(_mm256_mul_ps(dx, _mm256_set1_ps(m_dirX)), _mm256_mul_ps(dy, _mm256_set1_ps(m_dirY)));
+                __m256 const inArc = _mm256_cmp_ps(dot, _mm256_mul_ps(_mm256_set1_ps(m_cosHalfArc), _mm256_sqrt_ps(distSq)), _CMP_GE_OQ);
+                __m256 const self = _mm256_cmp_ps(distSq, _mm256_set1_ps(SELF_DISTANCE_SQ), _CMP_LT_OQ);
+                pass = _mm256_and_ps(pass, _mm256_or_ps(inArc, self));
+            }
+
+            return uint32(_mm256_movemask_ps(pass));
+        }
+#endif
+
+        float m_x;
+        float m_y;
+        float m_range;                                      // widened slightly, float rounding must never reject
+        bool m_cone;
+        float m_dirX;
+        float m_dirY;
+        float m_cosHalfArc;
+};
+
+#endif
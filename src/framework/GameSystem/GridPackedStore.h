@@ -0,0 +1,200 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _GRIDPACKEDSTORE_H
+#define _GRIDPACKEDSTORE_H
+
+#include "Platform/Define.h"
+
+#include <type_traits>
+#include <vector>
+
+/*
+  Contiguous companion of a GridRefManager. Holds the objects of one type in one cell together with
+  their cached positions and combat reach as parallel arrays, so range checks can scan packed floats
+  before touching any object. Removal swaps the last entry into the hole; every object owns a GridPackedSlot that
+  always knows its current index.
+*/
+
+// enabled per object type, the type then must provide GetPackedSlot(), GetPositionX/Y/Z() and GetCombatReach()
+template<class OBJECT>
+struct GridPackedTraits
+{
+    static constexpr bool enabled = false;
+};
+
+class GridPackedPositions;
+
+// back reference from an object to its entry, kept up to date by the store
+class GridPackedSlot
+{
+        friend class GridPackedPositions;
+
+    public:
+        GridPackedSlot() : m_store(nullptr), m_index(0) {}
+        ~GridPackedSlot() { Unlink(); }
+
+        GridPackedSlot(GridPackedSlot const&) = delete;
+        GridPackedSlot& operator=(GridPackedSlot const&) = delete;
+
+        bool IsLinked() const { return m_store != nullptr; }
+        inline void UpdatePosition(float x, float y, float z, float reach);
+        inline void UpdateReach(float reach);
+        inline void Unlink();
+
+    private:
+        GridPackedPositions* m_store;
+        uint32 m_index;
+};
+
+class GridPackedPositions
+{
+        friend class GridPackedSlot;
+
+    public:
+        GridPackedPositions() {}
+        ~GridPackedPositions()
+        {
+            for (GridPackedSlot* slot : m_slots)
+                slot->m_store = nullptr;
+        }
+
+        GridPackedPositions(GridPackedPositions const&) = delete;
+        GridPackedPositions& operator=(GridPackedPositions const&) = delete;
+
+        uint32 size() const { return uint32(m_x.size()); }
+        bool empty() const { return m_x.empty(); }
+
+        float const* X() const { return m_x.data(); }
+        float const* Y() const { return m_y.data(); }
+        float const* Z() const { return m_z.data(); }
+        float const* Reach() const { return m_reach.data(); }
+
+        // calls f(index) for every entry within 2d 'range' of (x, y)
+        template<class F>
+        void ForEachWithin2d(float x, float y, float range, F&& f) const
+        {
+            float const rangeSq = range * range;
+            for (uint32 i = 0; i < size(); ++i)
+            {
+                float const dx = m_x[i] - x;
+                float const dy = m_y[i] - y;
+                if (dx * dx + dy * dy <= rangeSq)
+                    f(i);
+            }
+        }
+
+    protected:
+        void Append(GridPackedSlot& slot, void* handle, float x, float y, float z, float reach)
+        {
+            if (slot.m_store)
+                slot.Unlink();
+
+            slot.m_store = this;
+            slot.m_index = size();
+            m_x.push_back(x);
+            m_y.push_back(y);
+            m_z.push_back(z);
+            m_reach.push_back(reach);
+            m_handles.push_back(handle);
+            m_slots.push_back(&slot);
+        }
+
+        void RemoveAt(uint32 index)
+        {
+            uint32 const last = size() - 1;
+            m_slots[index]->m_store = nullptr;
+            if (index != last)
+            {
+                m_x[index] = m_x[last];
+                m_y[index] = m_y[last];
+                m_z[index] = m_z[last];
+                m_reach[index] = m_reach[last];
+                m_handles[index] = m_handles[last];
+                m_slots[index] = m_slots[last];
+                m_slots[index]->m_index = index;
+            }
+
+            m_x.pop_back();
+            m_y.pop_back();
+            m_z.pop_back();
+            m_reach.pop_back();
+            m_handles.pop_back();
+            m_slots.pop_back();
+        }
+
+        void* Handle(uint32 index) const { return m_handles[index]; }
+
+    private:
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_reach;
+        std::vector<void*> m_handles;
+        std::vector<GridPackedSlot*> m_slots;
+};
+
+inline void GridPackedSlot::UpdatePosition(float x, float y, float z, float reach)
+{
+    if (!m_store)
+        return;
+
+    m_store->m_x[m_index] = x;
+    m_store->m_y[m_index] = y;
+    m_store->m_z[m_index] = z;
+    m_store->m_reach[m_index] = reach;
+}
+
+inline void GridPackedSlot::UpdateReach(float reach)
+{
+    if (m_store)
+        m_store->m_reach[m_index] = reach;
+}
+
+inline void GridPackedSlot::Unlink()
+{
+    if (m_store)
+        m_store->RemoveAt(m_index);
+}
+
+template<class OBJECT>
+class GridPackedStore : public GridPackedPositions
+{
+    public:
+        void insert(OBJECT* obj)
+        {
+            Append(obj->GetPackedSlot(), obj, obj->GetPositionX(), obj->GetPositionY(), obj->GetPositionZ(), obj->GetCombatReach());
+        }
+
+        void remove(OBJECT* obj)
+        {
+            obj->GetPackedSlot().Unlink();
+        }
+
+        OBJECT* object(uint32 index) const { return static_cast<OBJECT*>(Handle(index)); }
+};
+
+// placeholder for types without packed storage
+struct GridPackedNone
+{
+};
+
+template<class OBJECT>
+using GridPackedStoreFor = typename std::conditional<GridPackedTraits<OBJECT>::enabled, GridPackedStore<OBJECT>, GridPackedNone>::type;
+
+#endif
@@ -20,6 +20,7 @@
 #define _GRIDREFMANAGER
 
 #include "Utilities/LinkedReference/RefManager.h"
+#include "GameSystem/GridPackedStore.h"
 
 template<class OBJECT> class GridReference;
 
@@ -44,5 +45,12 @@ class GridRefManager : public RefManager<GridRefManager<OBJECT>, OBJECT>
         iterator end() { return iterator(nullptr); }
         iterator rbegin() { return iterator(getLast()); }
         iterator rend() { return iterator(nullptr); }
+
+        // same objects as the list, packed with their positions, see GridPackedStore
+        GridPackedStoreFor<OBJECT>& getPacked() { return m_packed; }
+        GridPackedStoreFor<OBJECT> const& getPacked() const { return m_packed; }
+
+    private:
+        GridPackedStoreFor<OBJECT> m_packed;
 };
 #endif
@@ -20,6 +20,7 @@
 #define _GRIDREFERENCE_H
 
 #include "Utilities/LinkedReference/Reference.h"
+#include "GameSystem/GridPackedStore.h"
 
 template<class OBJECT> class GridRefManager;
 
@@ -33,13 +34,19 @@ class GridReference : public Reference<GridRefManager<OBJECT>, OBJECT>
             // called from link()
             this->getTarget()->insertFirst(this);
             this->getTarget()->incSize();
+            if constexpr (GridPackedTraits<OBJECT>::enabled)
+                this->getTarget()->getPacked().insert(this->getSource());
         }
 
         void targetObjectDestroyLink() override
         {
             // called from unlink()
             if (this->isValid())
+            {
                 this->getTarget()->decSize();
+                if constexpr (GridPackedTraits<OBJECT>::enabled)
+                    this->getTarget()->getPacked().remove(this->getSource());
+            }
         }
 
         void sourceObjectDestroyLink() override
@@ -18,9 +18,50 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    uint32 LowestSetBit(uint64 mask)
+    {
+#if defined(__GNUC__)
+        return uint32(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long bit;
+        _BitScanForward64(&bit, mask);
+        return uint32(bit);
+#else
+        uint32 bit = 0;
+        while (!(mask & 1))
+        {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    // sequence numbers wrap around, a node added later always compares greater
+    bool AddedBefore(uint32 a, uint32 b)
+    {
+        return int32(a - b) < 0;
+    }
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_cursor = 1;
+    m_freeNode = NO_NODE;
+    m_queued = 0;
+    m_sequence = 0;
+    std::fill(std::begin(m_heads), std::end(m_heads), NO_NODE);
+    m_dueTail = NO_NODE;
+    std::fill(std::begin(m_occupied), std::end(m_occupied), 0);
     m_aborting = false;
 }
 
@@ -35,26 +76,39 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    for (;;)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        ExecuteDue(p_time);
 
-        if (!Event->to_Abort)
+        // nothing queued, the wheel can jump straight to the new time
+        if (!m_queued)
         {
-            if (Event->Execute(m_time, p_time))
-            {
-                // completely destroy event if it is not re-added
-                delete Event;
-            }
+            m_cursor = m_time + 1;
+            return;
         }
-        else
+
+        uint64 next = GetNextWheelTime();
+        if (next > m_time + 1)
         {
-            Event->Abort(m_time);
-            delete Event;
+            // no slot to take and no level to cascade until after the new time
+            m_cursor = m_time + 1;
+            return;
         }
+
+        m_cursor = next;
+        if (!(m_cursor & WHEEL_SLOT_MASK))
+            Cascade();
+
+        if (m_cursor > m_time)
+            return;
+
+        uint32 slot = uint32(m_cursor & WHEEL_SLOT_MASK);
+        if (m_occupied[0] & (uint64(1) << slot))
+            MoveToDue(slot);
+
+        ++m_cursor;
+        if (!(m_cursor & WHEEL_SLOT_MASK))
+            Cascade();
     }
 }
 
@@ -64,38 +118,61 @@ void EventProcessor::KillAllEvents(bool force)
     m_aborting = true;
 
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    std::vector<uint32> queued;
+    queued.reserve(m_queued);
+    for (uint32 slot = 0; slot < SLOT_COUNT; ++slot)
+        for (uint32 index = m_heads[slot]; index != NO_NODE; index = m_nodes[index].next)
+            queued.push_back(index);
+
+    std::sort(queued.begin(), queued.end(), [this](uint32 a, uint32 b)
     {
-        EventList::iterator i_old = i;
-        ++i;
+        EventNode const& left = m_nodes[a];
+        EventNode const& right = m_nodes[b];
+        return left.time != right.time ? left.time < right.time : AddedBefore(left.sequence, right.sequence);
+    });
 
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+    for (uint32 index : queued)
+    {
+        // killed by the abort of another event
+        BasicEvent* event = m_nodes[index].event;
+        if (!event)
+            continue;
+
+        event->to_Abort = true;
+        event->Abort(m_time);
+        if (force || event->IsDeletable())
         {
-            delete i_old->second;
+            delete event;
 
             if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            {
+                Unlink(index);
+                FreeNode(index);
+            }
         }
     }
 
     // fast clear event list (in force case)
     if (force)
-        m_events.clear();
+    {
+        m_nodes.clear();
+        m_freeNode = NO_NODE;
+        m_queued = 0;
+        std::fill(std::begin(m_heads), std::end(m_heads), NO_NODE);
+        m_dueTail = NO_NODE;
+        std::fill(std::begin(m_occupied), std::end(m_occupied), 0);
+    }
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    if (!IsQueued(event))
+        return;
+
+    uint32 index = event->m_node;
+    Unlink(index);
+    FreeNode(index);
+    delete event;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,24 +181,220 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+
+    uint32 index = AllocateNode();
+    EventNode& node = m_nodes[index];
+    node.event = Event;
+    node.time = e_time;
+    node.sequence = m_sequence++;
+    Event->m_node = index;
+    Link(index);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != Event)
-            continue;
+    if (!IsQueued(Event))
+        return;
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
-    }
+    Event->m_execTime = msTime;
+
+    uint32 index = Event->m_node;
+    Unlink(index);
+    m_nodes[index].time = msTime;
+    m_nodes[index].sequence = m_sequence++;
+    Link(index);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::GetEvents(std::vector<BasicEvent*>& events) const
+{
+    for (uint32 slot = 0; slot < SLOT_COUNT; ++slot)
+        for (uint32 index = m_heads[slot]; index != NO_NODE; index = m_nodes[index].next)
+            events.push_back(m_nodes[index].event);
+}
+
+uint32 EventProcessor::AllocateNode()
+{
+    ++m_queued;
+
+    if (m_freeNode == NO_NODE)
+    {
+        m_nodes.emplace_back();
+        return uint32(m_nodes.size() - 1);
+    }
+
+    uint32 index = m_freeNode;
+    m_freeNode = m_nodes[index].next;
+    return index;
+}
+
+void EventProcessor::FreeNode(uint32 index)
+{
+    --m_queued;
+
+    m_nodes[index].event = nullptr;
+    m_nodes[index].next = m_freeNode;
+    m_freeNode = index;
+}
+
+void EventProcessor::Link(uint32 index)
+{
+    EventNode& node = m_nodes[index];
+
+    // passed already, executed in order of addition
+    if (node.time < m_cursor)
+    {
+        LinkDue(index);
+        return;
+    }
+
+    // the level is given by the highest bit the time differs in from the cursor
+    uint64 differ = node.time ^ m_cursor;
+    uint32 level = 0;
+    while (level < WHEEL_LEVELS && (differ >> ((level + 1) * WHEEL_SLOT_BITS)))
+        ++level;
+
+    if (level < WHEEL_LEVELS)
+    {
+        uint32 slot = uint32(node.time >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+        node.slot = level * WHEEL_SLOTS + slot;
+        m_occupied[level] |= uint64(1) << slot;
+    }
+    else
+        node.slot = SLOT_OVERFLOW;
+
+    node.prev = NO_NODE;
+    node.next = m_heads[node.slot];
+    if (node.next != NO_NODE)
+        m_nodes[node.next].prev = index;
+    m_heads[node.slot] = index;
+}
+
+void EventProcessor::LinkDue(uint32 index)
+{
+    EventNode& node = m_nodes[index];
+    node.slot = SLOT_DUE;
+    node.prev = m_dueTail;
+    node.next = NO_NODE;
+    if (m_dueTail != NO_NODE)
+        m_nodes[m_dueTail].next = index;
+    else
+        m_heads[SLOT_DUE] = index;
+    m_dueTail = index;
+}
+
+void EventProcessor::Unlink(uint32 index)
+{
+    EventNode& node = m_nodes[index];
+
+    if (node.prev != NO_NODE)
+        m_nodes[node.prev].next = node.next;
+    else
+        m_heads[node.slot] = node.next;
+
+    if (node.next != NO_NODE)
+        m_nodes[node.next].prev = node.prev;
+    else if (node.slot == SLOT_DUE)
+        m_dueTail = node.prev;
+
+    if (node.slot < SLOT_DUE && m_heads[node.slot] == NO_NODE)
+        m_occupied[node.slot / WHEEL_SLOTS] &= ~(uint64(1) << (node.slot % WHEEL_SLOTS));
+}
+
+void EventProcessor::Relink(uint32 slot)
+{
+    uint32 index = m_heads[slot];
+    m_heads[slot] = NO_NODE;
+    if (slot < SLOT_DUE)
+        m_occupied[slot / WHEEL_SLOTS] &= ~(uint64(1) << (slot % WHEEL_SLOTS));
+
+    while (index != NO_NODE)
+    {
+        uint32 next = m_nodes[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+void EventProcessor::Cascade()
+{
+    // highest level first, its nodes can land in a lower level slot cascaded right after
+    if (!(m_cursor & ((uint64(1) << WHEEL_SPAN_BITS) - 1)))
+        Relink(SLOT_OVERFLOW);
+
+    for (uint32 level = WHEEL_LEVELS - 1; level > 0; --level)
+    {
+        uint32 shift = level * WHEEL_SLOT_BITS;
+        if (!(m_cursor & ((uint64(1) << shift) - 1)))
+            Relink(level * WHEEL_SLOTS + (uint32(m_cursor >> shift) & WHEEL_SLOT_MASK));
+    }
+}
+
+void EventProcessor::MoveToDue(uint32 slot)
+{
+    static thread_local std::vector<uint32> nodes;
+
+    for (uint32 index = m_heads[slot]; index != NO_NODE; index = m_nodes[index].next)
+        nodes.push_back(index);
+
+    m_heads[slot] = NO_NODE;
+    m_occupied[0] &= ~(uint64(1) << slot);
+
+    // slots are filled at the front and by cascading, restore the order of addition
+    std::sort(nodes.begin(), nodes.end(), [this](uint32 a, uint32 b) { return AddedBefore(m_nodes[a].sequence, m_nodes[b].sequence); });
+
+    for (uint32 index : nodes)
+        LinkDue(index);
+
+    nodes.clear();
+}
+
+void EventProcessor::ExecuteDue(uint32 p_time)
+{
+    while (m_heads[SLOT_DUE] != NO_NODE)
+    {
+        // get and remove event from queue
+        uint32 index = m_heads[SLOT_DUE];
+        BasicEvent* Event = m_nodes[index].event;
+        Unlink(index);
+        FreeNode(index);
+
+        if (!Event->to_Abort)
+        {
+            if (Event->Execute(m_time, p_time))
+            {
+                // completely destroy event if it is not re-added
+                delete Event;
+            }
+        }
+        else
+        {
+            Event->Abort(m_time);
+            delete Event;
+        }
+    }
+}
+
+uint64 EventProcessor::GetNextWheelTime() const
+{
+    // level 0 gives the time of its next slot, higher levels the start of their next slot where it has to cascade
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        uint32 shift = level * WHEEL_SLOT_BITS;
+        uint64 pending = m_occupied[level] >> ((m_cursor >> shift) & WHEEL_SLOT_MASK);
+        if (pending)
+            return ((m_cursor >> shift) + LowestSetBit(pending)) << shift;
+    }
+
+    // only the overflow is left, it is looked at when the wheel wraps around
+    return ((m_cursor >> WHEEL_SPAN_BITS) + 1) << WHEEL_SPAN_BITS;
+}
+
+bool EventProcessor::IsQueued(BasicEvent const* event) const
+{
+    return event->m_node < m_nodes.size() && m_nodes[event->m_node].event == event;
+}
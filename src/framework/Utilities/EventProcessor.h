@@ -21,16 +21,18 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
 class BasicEvent
 {
+    friend class EventProcessor;
+
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_node(0xFFFFFFFF)
         {
         }
 
@@ -53,10 +55,18 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
-};
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+    private:
+        uint32 m_node;                                      // queue node while queued, filled by event handler
+};
 
+/*
+  Events are queued in a hierarchical timing wheel: WHEEL_LEVELS levels of WHEEL_SLOTS slots, level 0 slots are 1ms
+  wide and each next level's slots span a whole lower level. Nodes are moved one level down when the wheel reaches
+  their slot, events further away than the wheel spans wait in an overflow list. Adding and killing an event is
+  constant time, nodes are kept in a per processor pool and reused. Events due at the same time execute in the
+  order they were added.
+*/
 class EventProcessor
 {
     public:
@@ -70,12 +80,51 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* event, uint64 msTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
+        void GetEvents(std::vector<BasicEvent*>& events) const;
 
     protected:
 
+        static constexpr uint32 WHEEL_LEVELS    = 3;
+        static constexpr uint32 WHEEL_SLOT_BITS = 6;
+        static constexpr uint32 WHEEL_SLOTS     = 1 << WHEEL_SLOT_BITS;
+        static constexpr uint32 WHEEL_SLOT_MASK = WHEEL_SLOTS - 1;
+        static constexpr uint32 WHEEL_SPAN_BITS = WHEEL_LEVELS * WHEEL_SLOT_BITS;
+        static constexpr uint32 SLOT_DUE        = WHEEL_LEVELS * WHEEL_SLOTS;  // passed, executed at once
+        static constexpr uint32 SLOT_OVERFLOW   = SLOT_DUE + 1;                // beyond the wheel span
+        static constexpr uint32 SLOT_COUNT      = SLOT_OVERFLOW + 1;
+        static constexpr uint32 NO_NODE         = 0xFFFFFFFF;
+
+        struct EventNode
+        {
+            BasicEvent* event;
+            uint64 time;
+            uint32 sequence;                                // add order, for events due at the same time
+            uint32 slot;
+            uint32 prev;
+            uint32 next;                                    // also links the free nodes
+        };
+
+        uint32 AllocateNode();
+        void FreeNode(uint32 index);
+        void Link(uint32 index);
+        void LinkDue(uint32 index);
+        void Unlink(uint32 index);
+        void Relink(uint32 slot);
+        void Cascade();
+        void MoveToDue(uint32 slot);
+        void ExecuteDue(uint32 p_time);
+        uint64 GetNextWheelTime() const;
+        bool IsQueued(BasicEvent const* event) const;
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_cursor;                                    // first time not handled by the wheel yet
+        std::vector<EventNode> m_nodes;
+        uint32 m_freeNode;
+        uint32 m_queued;
+        uint32 m_sequence;
+        uint32 m_heads[SLOT_COUNT];
+        uint32 m_dueTail;
+        uint64 m_occupied[WHEEL_LEVELS];                    // non empty slots per level
         bool m_aborting;
 };
 
@@ -519,14 +519,16 @@ void Antispam::Analyze()
     {
         // first see if the message is similar to previously observed unique messages
         bool found = false;
+        auto const threshold = static_cast<int>(sAnticheatConfig.GetAntispamUniquenessThreshold());
         for (auto i = 0u; i < _uniqueMessages.size(); ++i)
         {
             auto &u = _uniqueMessages[i];
 
-            auto const distance = static_cast<uint32>(nam::damerau_levenshtein_distance(msg, u.second));
+            // only need to know whether the distance is below the threshold
+            auto const distance = nam::damerau_levenshtein_distance(msg, u.second, threshold);
 
             // if these two messages are the same, increase the count
-            if (distance < sAnticheatConfig.GetAntispamUniquenessThreshold())
+            if (distance < threshold)
             {
                 ++u.first;
                 found = true;
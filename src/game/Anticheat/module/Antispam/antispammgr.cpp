@@ -26,6 +26,7 @@
 #include <thread>
 #include <chrono>
 #include <array>
+#include <map>
 
 INSTANTIATE_SINGLETON_1(NamreebAnticheat::AntispamMgr);
 
@@ -40,16 +41,6 @@ void ReplaceAll(std::string &str, const std::string& from, const std::string& to
         startPos += to.length();
     }
 }
-
-void ReplaceAllW(std::wstring &str, const std::wstring& from, const std::wstring& to)
-{
-    size_t startPos = 0;
-    while ((startPos = str.find(from, startPos)) != std::wstring::npos)
-    {
-        str.replace(startPos, from.length(), to);
-        startPos += to.length();
-    }
-}
 }
 
 namespace NamreebAnticheat
@@ -111,8 +102,12 @@ std::string AntispamMgr::NormalizeStringInternal(const std::string &string, uint
 
         if (!isBasicLatinString(w_tempMsg, true))
         {
-            for (auto const& s : _unicodeReplace)
-                ReplaceAllW(w_tempMsg, s.first, s.second);
+            for (auto& c : w_tempMsg)
+            {
+                auto const r = _unicodeReplaceMap.find(c);
+                if (r != _unicodeReplaceMap.end())
+                    c = r->second;
+            }
 
             if (mask & NF_REMOVE_NON_LATIN)
             {
@@ -229,6 +224,8 @@ void AntispamMgr::LoadFromDB()
             _blacklist.emplace_back(entry, normEntry);
         } while (result->NextRow());
 
+    BuildBlacklistMatcher();
+
     sLog.outString(">> %lu blacklist entries loaded and normalized", uint64(_blacklist.size()));
 
     result.reset(LoginDatabase.Query("SELECT `from`, `to` FROM antispam_replacement"));
@@ -266,9 +263,42 @@ void AntispamMgr::LoadFromDB()
             _unicodeReplace.emplace_back(key, value);
         } while (result->NextRow());
 
+    BuildUnicodeReplaceMap();
+
     sLog.outString(">> %lu unicode character replacements loaded", uint64(_unicodeReplace.size()));
 }
 
+void AntispamMgr::BuildBlacklistMatcher()
+{
+    _blacklistOriginal.clear();
+    _blacklistNormalized.clear();
+
+    for (size_t i = 0; i < _blacklist.size(); ++i)
+    {
+        _blacklistOriginal.add(_blacklist[i].first, static_cast<uint32>(i));
+        _blacklistNormalized.add(_blacklist[i].second, static_cast<uint32>(i));
+    }
+
+    _blacklistOriginal.build();
+    _blacklistNormalized.build();
+}
+
+void AntispamMgr::BuildUnicodeReplaceMap()
+{
+    _unicodeReplaceMap.clear();
+
+    // the replacements used to be applied one after another to the whole message, so a character
+    // replaced by an earlier entry may be replaced again by a later one.  fold them in the same order.
+    for (auto const& r : _unicodeReplace)
+        if (!r.first.empty())
+            _unicodeReplaceMap.emplace(r.first[0], r.first[0]);
+
+    for (auto& m : _unicodeReplaceMap)
+        for (auto const& r : _unicodeReplace)
+            if (!r.first.empty() && !r.second.empty() && m.second == r.first[0])
+                m.second = r.second[0];
+}
+
 void AntispamMgr::BlacklistAdd(const std::string &string_)
 {
     std::lock_guard<std::mutex> guard(_mutex);
@@ -300,6 +330,8 @@ void AntispamMgr::BlacklistAdd(const std::string &string_)
     LoginDatabase.CommitTransaction();
 
     _blacklist.emplace_back(entry, normEntry);
+
+    BuildBlacklistMatcher();
 }
 
 uint32 AntispamMgr::CheckBlacklist(const std::string &string, std::string &log) const
@@ -314,28 +346,49 @@ uint32 AntispamMgr::CheckBlacklist(const std::string &string, std::string &log)
 
     uint32 result = 0;
 
-    // for each entry, search the given string for multiple occurrences of both the original and normalized form of the entry
-    for (auto const& entry : _blacklist)
+    // occurrences of each entry are counted without overlap, the same way std::string::find would find them
+    struct Hits
     {
-        // search the original string for the original blacklist entry
-        if (!entry.first.empty())
-        {
-            for (auto pos = string.find(entry.first); pos != std::string::npos; pos = string.find(entry.first, pos + entry.first.length()))
-            {
-                logstr << "\nOriginal: \"" << entry.first << "\"";
-                ++result;
-            }
-        }
+        uint32 original = 0;
+        uint32 normalized = 0;
+        size_t originalEnd = 0;
+        size_t normalizedEnd = 0;
+    };
 
-        // search for the normalized blacklist entry
-        if (!entry.second.empty())
-        {
-            for (auto pos = msg.find(entry.second); pos != std::string::npos; pos = msg.find(entry.second, pos + entry.second.length()))
-            {
-                logstr << "\nNormalized: \"" << entry.second << "\"";
-                ++result;
-            }
-        }
+    std::map<uint32, Hits> hits;
+
+    _blacklistOriginal.match(string, [&hits, this](uint32 id, size_t pos)
+    {
+        auto& hit = hits[id];
+        if (pos < hit.originalEnd)
+            return;
+
+        ++hit.original;
+        hit.originalEnd = pos + _blacklist[id].first.length();
+    });
+
+    _blacklistNormalized.match(msg, [&hits, this](uint32 id, size_t pos)
+    {
+        auto& hit = hits[id];
+        if (pos < hit.normalizedEnd)
+            return;
+
+        ++hit.normalized;
+        hit.normalizedEnd = pos + _blacklist[id].second.length();
+    });
+
+    // report in blacklist order
+    for (auto const& hit : hits)
+    {
+        auto const& entry = _blacklist[hit.first];
+
+        for (uint32 i = 0; i < hit.second.original; ++i)
+            logstr << "\nOriginal: \"" << entry.first << "\"";
+
+        for (uint32 i = 0; i < hit.second.normalized; ++i)
+            logstr << "\nNormalized: \"" << entry.second << "\"";
+
+        result += hit.second.original + hit.second.normalized;
     }
 
     logstr << "\n";
@@ -9,6 +9,7 @@
 #define __ANTISPAMMGR_HPP_
 
 #include "Policies/Singleton.h"
+#include "../ahocorasick.hpp"
 
 #include <string>
 #include <vector>
@@ -37,11 +38,16 @@ class AntispamMgr
         // this collection contains a pair of strings, the original entry and the normalized version based on current settings
         std::vector<std::pair<std::string, std::string> > _blacklist;
 
+        // blacklist compiled for single pass matching, pattern id is the index in _blacklist.  rebuilt when it changes
+        nam::aho_corasick _blacklistOriginal;
+        nam::aho_corasick _blacklistNormalized;
+
         // NOTE: _asciiReplace and _unicodeReplace are not protected by _mutex, because it would make the code much more complicated
         // and they should never be changing once the world server has started.
 
         std::vector<std::pair<std::string, std::string> > _asciiReplace;        // replacements for ascii strings (for things like @ -> A or \/\/ -> W etc.)
         std::vector<std::pair<std::wstring, std::wstring> > _unicodeReplace;    // replacements for individual unicode characters
+        std::unordered_map<wchar_t, wchar_t> _unicodeReplaceMap;                // _unicodeReplace folded into a single lookup per character
 
         // set of sessions to analyze in the next tick of the antispam worker thread
         std::unordered_set<std::shared_ptr<Antispam> > _workQueue;
@@ -57,6 +63,10 @@ class AntispamMgr
 
         void WorkerLoop();
 
+        // assumes that the mutex is already locked
+        void BuildBlacklistMatcher();
+        void BuildUnicodeReplaceMap();
+
     public:
         AntispamMgr();
         ~AntispamMgr();
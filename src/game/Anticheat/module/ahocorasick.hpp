@@ -0,0 +1,164 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// nam::aho_corasick finds every occurrence of a set of patterns in a single pass over the text
+
+#ifndef __AHOCORASICK_HPP_
+#define __AHOCORASICK_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace nam
+{
+class aho_corasick
+{
+    private:
+        static constexpr std::uint32_t none = 0xFFFFFFFF;
+
+        struct node
+        {
+            // sorted by character, most nodes have one or two children
+            std::vector<std::pair<unsigned char, std::uint32_t> > children;
+            std::vector<std::uint32_t> patterns;        // ids of patterns ending in this node
+            std::uint32_t fail = 0;
+            std::uint32_t output = none;                // closest node in fail chain with patterns
+        };
+
+        std::vector<node> _nodes;
+        std::vector<std::size_t> _lengths;              // indexed by pattern id
+
+        std::uint32_t child(std::uint32_t n, unsigned char c) const
+        {
+            auto const &children = _nodes[n].children;
+            auto const i = std::lower_bound(children.begin(), children.end(), c,
+                [](const std::pair<unsigned char, std::uint32_t> &e, unsigned char v) { return e.first < v; });
+
+            return i != children.end() && i->first == c ? i->second : none;
+        }
+
+    public:
+        aho_corasick() : _nodes(1) {}
+
+        void clear()
+        {
+            _nodes.assign(1, node());
+            _lengths.clear();
+        }
+
+        bool empty() const { return _lengths.empty(); }
+
+        // empty patterns are ignored.  call build() after all patterns have been added
+        void add(const std::string &pattern, std::uint32_t id)
+        {
+            if (pattern.empty())
+                return;
+
+            std::uint32_t n = 0;
+            for (auto const ch : pattern)
+            {
+                auto const c = static_cast<unsigned char>(ch);
+                auto next = child(n, c);
+
+                if (next == none)
+                {
+                    next = static_cast<std::uint32_t>(_nodes.size());
+                    auto &children = _nodes[n].children;
+                    children.insert(std::upper_bound(children.begin(), children.end(), std::make_pair(c, std::uint32_t(0))), std::make_pair(c, next));
+                    _nodes.emplace_back();
+                }
+
+                n = next;
+            }
+
+            _nodes[n].patterns.push_back(id);
+
+            if (_lengths.size() <= id)
+                _lengths.resize(id + 1, 0);
+            _lengths[id] = pattern.length();
+        }
+
+        // computes failure and output links breadth first
+        void build()
+        {
+            std::deque<std::uint32_t> queue;
+
+            for (auto const &c : _nodes[0].children)
+            {
+                _nodes[c.second].fail = 0;
+                _nodes[c.second].output = none;
+                queue.push_back(c.second);
+            }
+
+            while (!queue.empty())
+            {
+                auto const n = queue.front();
+                queue.pop_front();
+
+                for (auto const &c : _nodes[n].children)
+                {
+                    auto f = _nodes[n].fail;
+                    auto next = child(f, c.first);
+                    while (next == none && f != 0)
+                    {
+                        f = _nodes[f].fail;
+                        next = child(f, c.first);
+                    }
+
+                    auto &target = _nodes[c.second];
+                    target.fail = next == none ? 0 : next;
+                    target.output = _nodes[target.fail].patterns.empty() ? _nodes[target.fail].output : target.fail;
+
+                    queue.push_back(c.second);
+                }
+            }
+        }
+
+        // calls callback(pattern id, start position) for every occurrence, ordered by end position
+        template <typename F>
+        void match(const std::string &text, F &&callback) const
+        {
+            if (empty())
+                return;
+
+            std::uint32_t n = 0;
+            for (std::size_t i = 0; i < text.length(); ++i)
+            {
+                auto const c = static_cast<unsigned char>(text[i]);
+
+                auto next = child(n, c);
+                while (next == none && n != 0)
+                {
+                    n = _nodes[n].fail;
+                    next = child(n, c);
+                }
+                n = next == none ? 0 : next;
+
+                for (auto out = _nodes[n].patterns.empty() ? _nodes[n].output : n; out != none; out = _nodes[out].output)
+                    for (auto const id : _nodes[out].patterns)
+                        callback(id, i + 1 - _lengths[id]);
+            }
+        }
+};
+}
+
+#endif /* !__AHOCORASICK_HPP_ */
@@ -29,6 +29,8 @@
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <array>
+#include <cstdint>
 
 namespace nam
 {
@@ -94,5 +96,140 @@ int damerau_levenshtein_distance(const std::string &string1, const std::string &
 
     return dist[get_index(columns, static_cast<int>(string1_length), static_cast<int>(string2_length))];
 }
+
+namespace detail
+{
+// Hyyro's bit-parallel optimal string alignment distance, pattern must be 1..64 characters long
+inline int damerau_levenshtein_bitparallel(const std::string &pattern, const std::string &text, int max_distance)
+{
+    static thread_local std::array<std::uint64_t, 256> peq {};
+
+    auto const m = static_cast<int>(pattern.length());
+    auto const n = static_cast<int>(text.length());
+
+    for (auto i = 0; i < m; ++i)
+        peq[static_cast<unsigned char>(pattern[i])] |= std::uint64_t(1) << i;
+
+    auto const last = std::uint64_t(1) << (m - 1);
+
+    std::uint64_t vp = m == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << m) - 1;
+    std::uint64_t vn = 0;
+    std::uint64_t d0 = 0;
+    std::uint64_t pm_old = 0;
+
+    auto dist = m;
+
+    for (auto j = 0; j < n; ++j)
+    {
+        auto const pm = peq[static_cast<unsigned char>(text[j])];
+
+        auto const tr = (((~d0) & pm) << 1) & pm_old;
+        d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+
+        auto hp = vn | ~(d0 | vp);
+        auto hn = d0 & vp;
+
+        if (hp & last)
+            ++dist;
+        else if (hn & last)
+            --dist;
+
+        // the remaining columns can lower the distance by one each at most
+        if (dist - (n - j - 1) >= max_distance)
+        {
+            dist = max_distance;
+            break;
+        }
+
+        hp = (hp << 1) | 1;
+        hn = hn << 1;
+
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        pm_old = pm;
+    }
+
+    for (auto i = 0; i < m; ++i)
+        peq[static_cast<unsigned char>(pattern[i])] = 0;
+
+    return std::min(dist, max_distance);
+}
+
+// row by row version of damerau_levenshtein_distance for long strings, keeping only three rows
+inline int damerau_levenshtein_rows(const std::string &string1, const std::string &string2, int max_distance)
+{
+    static thread_local std::vector<int> rows[3];
+
+    auto const length1 = static_cast<int>(string1.length());
+    auto const length2 = static_cast<int>(string2.length());
+
+    for (auto &row : rows)
+        if (static_cast<int>(row.size()) < length2 + 1)
+            row.resize(length2 + 1);
+
+    auto *prev2 = &rows[0];
+    auto *prev = &rows[1];
+    auto *curr = &rows[2];
+
+    for (auto j = 0; j <= length2; ++j)
+        (*prev)[j] = j;
+
+    auto prev_min = 0;
+
+    for (auto i = 1; i <= length1; ++i)
+    {
+        (*curr)[0] = i;
+        auto curr_min = i;
+
+        for (auto j = 1; j <= length2; ++j)
+        {
+            auto const cost = string1[i - 1] == string2[j - 1] ? 0 : 1;
+
+            auto value = std::min((*prev)[j] + 1, std::min((*curr)[j - 1] + 1, (*prev)[j - 1] + cost));
+
+            if (i > 1 && j > 1 &&
+                string1[i - 1] == string2[j - 2] &&
+                string1[i - 2] == string2[j - 1])
+                value = std::min(value, (*prev2)[j - 2] + cost);
+
+            (*curr)[j] = value;
+            curr_min = std::min(curr_min, value);
+        }
+
+        // no later row can get below the threshold again
+        if (std::min(curr_min, prev_min + 1) >= max_distance)
+            return max_distance;
+
+        prev_min = curr_min;
+        std::swap(prev2, prev);
+        std::swap(prev, curr);
+    }
+
+    return std::min((*prev)[length2], max_distance);
+}
+}
+
+// same result as damerau_levenshtein_distance when it is below max_distance, otherwise returns max_distance.
+// does not allocate per call and stops as soon as the distance is known to reach max_distance.
+inline int damerau_levenshtein_distance(const std::string &string1, const std::string &string2, int max_distance)
+{
+    auto const &pattern = string1.length() <= string2.length() ? string1 : string2;
+    auto const &text = string1.length() <= string2.length() ? string2 : string1;
+
+    if (max_distance <= 0)
+        return 0;
+
+    // every extra character costs an insertion
+    if (static_cast<int>(text.length() - pattern.length()) >= max_distance)
+        return max_distance;
+
+    if (pattern.empty())
+        return std::min(static_cast<int>(text.length()), max_distance);
+
+    if (pattern.length() <= 64)
+        return detail::damerau_levenshtein_bitparallel(pattern, text, max_distance);
+
+    return detail::damerau_levenshtein_rows(pattern, text, max_distance);
+}
 }
 #endif /* !__DLDIST_HPP_ */
\ No newline at end of file
@@ -348,6 +348,13 @@ void WorldSession::HandleAuctionPlaceBid(WorldPacket& recv_data)
     AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
     Player* pl = GetPlayer();
 
+    if (auction && auction->pendingExpire)
+    {
+        // auction already ended, only waiting for expiry to be applied
+        SendAuctionCommandResult(nullptr, AUCTION_BID_PLACED, AUCTION_ERR_ITEM_NOT_FOUND);
+        return;
+    }
+
     if (!auction || auction->owner == pl->GetGUIDLow())
     {
         // you cannot bid your own auction:
@@ -427,6 +434,13 @@ void WorldSession::HandleAuctionRemoveItem(WorldPacket& recv_data)
         return;
     }
 
+    if (auction->pendingExpire)
+    {
+        // auction already ended, only waiting for expiry to be applied
+        SendAuctionCommandResult(nullptr, AUCTION_REMOVED, AUCTION_ERR_ITEM_NOT_FOUND);
+        return;
+    }
+
     Item* pItem = sAuctionMgr.GetAItem(auction->itemGuidLow);
     if (!pItem)
     {
@@ -38,12 +38,14 @@
 
 INSTANTIATE_SINGLETON_1(AuctionHouseMgr);
 
-AuctionHouseMgr::AuctionHouseMgr()
+AuctionHouseMgr::AuctionHouseMgr() : m_workerStop(false)
 {
 }
 
 AuctionHouseMgr::~AuctionHouseMgr()
 {
+    StopWorker();
+
     for (ItemMap::const_iterator itr = mAitems.begin(); itr != mAitems.end(); ++itr)
         delete itr->second;
 }
@@ -102,7 +104,7 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
         }
         else
         {
-            bidder_accId = sObjectMgr.GetPlayerAccountIdByGUID(bidder_guid);
+            bidder_accId = auction->GetBidderAccountId();
             bidder_security = bidder_accId ? sAccountMgr.GetSecurity(bidder_accId) : SEC_PLAYER;
 
             if (bidder_security > SEC_PLAYER)               // not do redundant DB requests
@@ -118,14 +120,14 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
             if (ownerGuid && !sObjectMgr.GetPlayerNameByGUID(ownerGuid, owner_name))
                 owner_name = sObjectMgr.GetMangosStringForDbcLocale(LANG_UNKNOWN);
 
-            uint32 owner_accid = sObjectMgr.GetPlayerAccountIdByGUID(ownerGuid);
+            uint32 owner_accid = auction->GetOwnerAccountId();
 
             sLog.outCommand(bidder_accId, "GM %s (Account: %u) won item in auction (Entry: %u Count: %u) and pay money: %u. Original owner %s (Account: %u)",
                             bidder_name.c_str(), bidder_accId, auction->itemTemplate, auction->itemCount, auction->bid, owner_name.c_str(), owner_accid);
         }
     }
     else if (!bidder)
-        bidder_accId = sObjectMgr.GetPlayerAccountIdByGUID(bidder_guid);
+        bidder_accId = auction->GetBidderAccountId();
 
     // receiver exist
     if (bidder || bidder_accId)
@@ -170,7 +172,7 @@ void AuctionHouseMgr::SendAuctionSalePendingMail(AuctionEntry* auction)
     Player* owner = sObjectMgr.GetPlayer(owner_guid);
 
     // owner exist (online or offline)
-    if (owner || (owner_guid && sObjectMgr.GetPlayerAccountIdByGUID(owner_guid)))
+    if (owner || auction->GetOwnerAccountId())
     {
         std::ostringstream msgAuctionSalePendingSubject;
         msgAuctionSalePendingSubject << auction->itemTemplate << ":" << auction->itemRandomPropertyId << ":" << AUCTION_SALE_PENDING;
@@ -201,7 +203,7 @@ void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
 
     uint32 owner_accId = 0;
     if (!owner)
-        owner_accId = sObjectMgr.GetPlayerAccountIdByGUID(owner_guid);
+        owner_accId = auction->GetOwnerAccountId();
 
     // owner exist
     if (owner || owner_accId)
@@ -249,7 +251,7 @@ void AuctionHouseMgr::SendAuctionExpiredMail(AuctionEntry* auction)
 
     uint32 owner_accId = 0;
     if (!owner)
-        owner_accId = sObjectMgr.GetPlayerAccountIdByGUID(owner_guid);
+        owner_accId = auction->GetOwnerAccountId();
 
     // owner exist
     if (owner || owner_accId)
@@ -491,6 +493,119 @@ void AuctionHouseMgr::Update()
         mAuction.Update();
 }
 
+void AuctionHouseMgr::StartWorker()
+{
+    if (m_worker.joinable())
+        return;
+
+    m_workerStop = false;
+    m_worker = std::thread(&AuctionHouseMgr::WorkerLoop, this);
+}
+
+void AuctionHouseMgr::StopWorker()
+{
+    if (!m_worker.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_workerMutex);
+        m_workerStop = true;
+    }
+    m_workerCondition.notify_one();
+    m_worker.join();
+
+    // worker finished all queued tasks, apply what they produced while we still can
+    ProcessMutations(true);
+}
+
+void AuctionHouseMgr::QueueWorkerTask(std::function<void()>&& task)
+{
+    // no worker (startup or shutdown), do it in place
+    if (!m_worker.joinable())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_workerMutex);
+        m_workerTasks.push_back(std::move(task));
+    }
+    m_workerCondition.notify_one();
+}
+
+void AuctionHouseMgr::WorkerLoop()
+{
+    CharacterDatabase.ThreadStart();
+    WorldDatabase.ThreadStart();
+
+    while (true)
+    {
+        std::deque<std::function<void()>> tasks;
+        {
+            std::unique_lock<std::mutex> lock(m_workerMutex);
+            m_workerCondition.wait(lock, [this] { return m_workerStop || !m_workerTasks.empty(); });
+            if (m_workerTasks.empty())
+                break;                                      // stop requested and nothing left to do
+
+            std::swap(tasks, m_workerTasks);
+        }
+
+        for (auto& task : tasks)
+            task();
+    }
+
+    WorldDatabase.ThreadEnd();
+    CharacterDatabase.ThreadEnd();
+}
+
+void AuctionHouseMgr::AddMutation(std::function<void()>&& mutation)
+{
+    std::lock_guard<std::mutex> guard(m_mutationMutex);
+    m_mutations.push_back(std::move(mutation));
+}
+
+void AuctionHouseMgr::ProcessMutations(bool all /*= false*/)
+{
+    std::deque<std::function<void()>> mutations;
+    {
+        std::lock_guard<std::mutex> guard(m_mutationMutex);
+        uint32 budget = all ? 0 : sWorld.getConfig(CONFIG_UINT32_AUCTION_MUTATIONS_PER_TICK);
+        if (!budget || budget >= m_mutations.size())
+            std::swap(mutations, m_mutations);
+        else
+        {
+            auto last = m_mutations.begin() + budget;
+            std::move(m_mutations.begin(), last, std::back_inserter(mutations));
+            m_mutations.erase(m_mutations.begin(), last);
+        }
+    }
+
+    for (auto& mutation : mutations)
+        mutation();
+}
+
+size_t AuctionHouseMgr::GetPendingMutationsCount() const
+{
+    std::lock_guard<std::mutex> guard(m_mutationMutex);
+    return m_mutations.size();
+}
+
+uint32 AuctionHouseMgr::LoadAccountIdFromDB(uint32 lowguid)
+{
+    if (!lowguid)
+        return 0;
+
+    // account of character never change, so no need to look for online player here
+    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE guid = '%u'", lowguid);
+    if (!result)
+        return 0;
+
+    uint32 accountId = (*result)[0].GetUInt32();
+    delete result;
+    return accountId;
+}
+
 uint32 AuctionHouseMgr::GetAuctionHouseTeam(AuctionHouseEntry const* house)
 {
     // auction houses have faction field pointing to PLAYER,* factions,
@@ -573,28 +688,59 @@ void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
     ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    for (auto& itr : AuctionsMap)
     {
-        if (curTime < itr->second->expireTime)
-        {
-            itr++;
+        AuctionEntry* auction = itr.second;
+        if (auction->pendingExpire || curTime < auction->expireTime)
             continue;
-        }
 
-        ///- perform the transaction if there was bidder.  this will alyways have the side effect of
-        ///- removing the auction from the collection.  therefore we must increment the iterator here.
-        if (itr->second->bid)
-            (itr++)->second->AuctionBidWinning();
-        ///- cancel the auction if there was no bidder and clear the auction
-        else
+        ///- resolve owner and bidder accounts in auction worker, mails are sent when the result is applied
+        auction->pendingExpire = true;
+
+        AuctionHouseObject* house = this;
+        uint32 auctionId = auction->Id;
+        uint32 owner = auction->owner;
+        uint32 bidder = auction->bid ? auction->bidder : 0;
+        sAuctionMgr.QueueWorkerTask([house, auctionId, owner, bidder]()
         {
-            sAuctionMgr.SendAuctionExpiredMail(itr->second);
+            uint32 ownerAccId = AuctionHouseMgr::LoadAccountIdFromDB(owner);
+            uint32 bidderAccId = AuctionHouseMgr::LoadAccountIdFromDB(bidder);
+            sAuctionMgr.AddMutation([house, auctionId, owner, bidder, ownerAccId, bidderAccId]()
+            {
+                house->ExpireAuction(auctionId, owner, bidder, ownerAccId, bidderAccId);
+            });
+        });
+    }
+}
 
-            itr->second->DeleteFromDB();
-            sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
-            delete itr->second;
-            AuctionsMap.erase(itr++);
-        }
+void AuctionHouseObject::ExpireAuction(uint32 auctionId, uint32 owner, uint32 bidder, uint32 ownerAccId, uint32 bidderAccId)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(auctionId);
+    if (itr == AuctionsMap.end())
+        return;                                             // cancelled by owner meanwhile
+
+    AuctionEntry* auction = itr->second;
+
+    // lookup result is only usable if nobody changed the auction meanwhile
+    if (auction->owner == owner && (auction->bid ? auction->bidder : 0) == bidder)
+    {
+        auction->ownerAccId = ownerAccId;
+        auction->bidderAccId = bidderAccId;
+        auction->accountsResolved = true;
+    }
+
+    ///- perform the transaction if there was bidder, this will remove and delete the auction
+    if (auction->bid)
+        auction->AuctionBidWinning();
+    ///- cancel the auction if there was no bidder and clear the auction
+    else
+    {
+        sAuctionMgr.SendAuctionExpiredMail(auction);
+
+        auction->DeleteFromDB();
+        sAuctionMgr.RemoveAItem(auction->itemGuidLow);
+        delete auction;
+        AuctionsMap.erase(itr);
     }
 }
 
@@ -963,6 +1109,22 @@ uint32 AuctionEntry::GetAuctionOutBid() const
     return outbid;
 }
 
+uint32 AuctionEntry::GetOwnerAccountId() const
+{
+    if (accountsResolved)
+        return ownerAccId;
+
+    return owner ? sObjectMgr.GetPlayerAccountIdByGUID(ObjectGuid(HIGHGUID_PLAYER, owner)) : 0;
+}
+
+uint32 AuctionEntry::GetBidderAccountId() const
+{
+    if (accountsResolved)
+        return bidderAccId;
+
+    return bidder ? sObjectMgr.GetPlayerAccountIdByGUID(ObjectGuid(HIGHGUID_PLAYER, bidder)) : 0;
+}
+
 void AuctionEntry::DeleteFromDB() const
 {
     // No SQL injection (Id is integer)
@@ -22,6 +22,13 @@
 #include "Common.h"
 #include "Server/DBCStructure.h"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
 class Item;
 class Player;
 class Unit;
@@ -70,11 +77,19 @@ struct AuctionEntry
     uint32 deposit;                                         // deposit can be calculated only when creating auction
     AuctionHouseEntry const* auctionHouseEntry;             // in AuctionHouse.dbc
 
+    // expiry state, not saved in DB
+    bool pendingExpire = false;                             // expiry queued to auction worker, no more bids accepted
+    bool accountsResolved = false;                          // ownerAccId/bidderAccId were looked up by auction worker
+    uint32 ownerAccId = 0;
+    uint32 bidderAccId = 0;
+
     // helpers
     uint32 GetHouseId() const { return auctionHouseEntry->houseId; }
     uint32 GetHouseFaction() const { return auctionHouseEntry->faction; }
     uint32 GetAuctionCut() const;
     uint32 GetAuctionOutBid() const;
+    uint32 GetOwnerAccountId() const;
+    uint32 GetBidderAccountId() const;
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
@@ -120,6 +135,7 @@ class AuctionHouseObject
         bool RemoveAuction(uint32 id) { return !!AuctionsMap.erase(id); }
 
         void Update();
+        void ExpireAuction(uint32 auctionId, uint32 owner, uint32 bidder, uint32 ownerAccId, uint32 bidderAccId);
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
@@ -180,6 +196,7 @@ class AuctionHouseMgr
 
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
+        static uint32 LoadAccountIdFromDB(uint32 lowguid);  // synchronous, for auction worker use
 
     public:
         // load first auction items, because of check if item exists, when loading
@@ -191,10 +208,34 @@ class AuctionHouseMgr
 
         void Update();
 
+        // auction worker, runs expiry lookups and AHBot item generation outside of world thread
+        void StartWorker();
+        void StopWorker();
+        void QueueWorkerTask(std::function<void()>&& task);
+        // held shared by worker tasks rolling loot, exclusively while loot tables or conditions are reloaded
+        std::shared_mutex& GetLootDataLock() { return m_lootDataLock; }
+
+        // thread safe, mutations are applied in world thread by ProcessMutations
+        void AddMutation(std::function<void()>&& mutation);
+        void ProcessMutations(bool all = false);
+        size_t GetPendingMutationsCount() const;
+
     private:
+        void WorkerLoop();
+
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
         ItemMap             mAitems;
+
+        std::thread m_worker;
+        std::mutex m_workerMutex;
+        std::condition_variable m_workerCondition;
+        std::deque<std::function<void()>> m_workerTasks;
+        bool m_workerStop;
+        std::shared_mutex m_lootDataLock;
+
+        mutable std::mutex m_mutationMutex;
+        std::deque<std::function<void()>> m_mutations;
 };
 
 #define sAuctionMgr MaNGOS::Singleton<AuctionHouseMgr>::Instance()
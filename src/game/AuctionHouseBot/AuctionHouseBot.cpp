@@ -30,7 +30,7 @@
 
 INSTANTIATE_SINGLETON_1(AuctionHouseBot);
 
-AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1)
+AuctionHouseBot::AuctionHouseBot() : m_configFileName(_AUCTIONHOUSEBOT_CONFIG), m_houseAction(-1), m_chanceSell(0), m_chanceBuy(0), m_budgetPerTick(0)
 {
 }
 
@@ -38,20 +38,23 @@ AuctionHouseBot::~AuctionHouseBot()
 {
 }
 
-void AuctionHouseBot::Initialize()
+bool AuctionHouseBot::Initialize()
 {
+    std::lock_guard<std::mutex> guard(m_configMutex);
+
     if (!m_ahBotCfg.SetSource(m_configFileName))
     {
         // set buy/sell chance to 0, this prevents Update() from accessing uninitialized variables
         m_chanceBuy = 0;
         m_chanceSell = 0;
         sLog.outString("AHBot is disabled. Unable to open configuration file(%s).", m_configFileName.c_str());
-        return;
+        return false;
     }
     sLog.outString("AHBot using configuration file %s", m_configFileName.c_str());
 
     m_chanceSell = GetMinMaxConfig("AuctionHouseBot.Chance.Sell", 0, 100, 10);
     m_chanceBuy = GetMinMaxConfig("AuctionHouseBot.Chance.Buy", 0, 100, 10);
+    m_budgetPerTick = GetMinMaxConfig("AuctionHouseBot.Budget.PerTick", 0, 1000, 20);
 
     sLog.outString("AHBot selling items: %s", m_chanceSell > 0 ? "Enabled" : "Disabled");
     sLog.outString("AHBot buying items: %s", m_chanceBuy > 0 ? "Enabled" : "Disabled");
@@ -150,6 +153,8 @@ void AuctionHouseBot::Initialize()
             delete result;
         }
     }
+
+    return true;
 }
 
 void AuctionHouseBot::Update()
@@ -158,120 +163,184 @@ void AuctionHouseBot::Update()
         m_houseAction = 0;
 
     AuctionHouseType houseType = AuctionHouseType(m_houseAction % MAX_AUCTION_HOUSE_TYPE);
-    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(houseType);
     if (m_houseAction < MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceSell)
     {
-        // Sell items
-        std::unordered_map<uint32, uint32> itemMap;
-
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootNormalConfig, m_creatureLootNormalTemplates, itemMap);       // normal creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootEliteConfig, m_creatureLootEliteTemplates, itemMap);         // elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareEliteConfig, m_creatureLootRareEliteTemplates, itemMap); // rare elite creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootWorldBossConfig, m_creatureLootWorldBossTemplates, itemMap); // world boss creature loot
-        AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareConfig, m_creatureLootRareTemplates, itemMap);           // rare creature loot
-
-        AddLootToItemMap(&LootTemplates_Disenchant, m_disenchantLootConfig, m_disenchantLootTemplates, itemMap);             // disenchant loot
-        AddLootToItemMap(&LootTemplates_Fishing, m_fishingLootConfig, m_fishingLootTemplates, itemMap);                      // fishing loot
-        AddLootToItemMap(&LootTemplates_Gameobject, m_gameobjectLootConfig, m_gameobjectLootTemplates, itemMap);             // gameobject loot
-        AddLootToItemMap(&LootTemplates_Skinning, m_skinningLootConfig, m_skinningLootTemplates, itemMap);                   // skinning loot
-
-        // profession items are a bit different (not looted)
-        if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
+        // rolling loot is expensive, leave it to auction worker
+        sAuctionMgr.QueueWorkerTask([this, houseType]() { GenerateSellOrders(houseType); });
+    }
+    else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
+    {
+        // auction worker can't access live auctions, copy what is needed to decide
+        std::vector<AuctionHouseBotAuctionInfo> auctions;
+        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(houseType)->GetAuctionsBounds();
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
-            int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
-            if (maxTemplates > 0)
-            {
-                for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
-                {
-                    uint32 item = m_professionItems[urand(0, m_professionItems.size() - 1)];
-                    ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(item);
-                    if (!prototype || prototype->Quality == 0 || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
-                        continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
-                    uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
-                    if (count <= 0)
-                        count = 1;
-                    itemMap[item] += count;
-                }
-            }
+            AuctionEntry* auction = itr->second;
+            if (auction->pendingExpire)
+                continue; // already ended
+            if (auction->owner == 0 && auction->bid == 0)
+                continue; // ignore bidding/buying auctions that were created by ahbot and not bidded on by player
+            Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
+            if (!item)
+                continue; // shouldn't happen, but apparently it does(?)
+            auctions.push_back({ auction->Id, item->GetEntry(), item->GetCount(), auction->bid, auction->startbid, auction->GetAuctionOutBid(), auction->buyout });
         }
+        sAuctionMgr.QueueWorkerTask([this, houseType, auctions]() { GenerateBuyOrders(houseType, auctions); });
+    }
+}
 
-        // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
-        for (auto& itemData : m_itemData)
+void AuctionHouseBot::ProcessOrders()
+{
+    std::deque<AuctionHouseBotOrder> orders;
+    {
+        std::lock_guard<std::mutex> guard(m_ordersMutex);
+        uint32 budget = m_budgetPerTick;
+        if (!budget || budget >= m_orders.size())
+            std::swap(orders, m_orders);
+        else
         {
-            if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
-                itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
+            auto last = m_orders.begin() + budget;
+            std::move(m_orders.begin(), last, std::back_inserter(orders));
+            m_orders.erase(m_orders.begin(), last);
         }
+    }
 
-        for (auto& itemEntry : itemMap)
+    for (auto const& order : orders)
+    {
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(order.HouseType);
+        if (order.AuctionId)
         {
-            ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
-            if (!prototype || prototype->GetMaxStackSize() == 0)
-                continue; // really shouldn't happen, but better safe than sorry
-            auto iterator = m_itemData.find(prototype->ItemId);
-            if (iterator != m_itemData.end() && iterator->second.Value == 0)
-                continue; // item is blacklisted
-            if (iterator == m_itemData.end() || iterator->second.AddChance == 0)
-            {
-                if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
-                    continue; // no BoP and quest items
-                if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
-                    continue; // nor items containing loot
-                if (m_itemValue[prototype->Quality][prototype->Class] == 0)
-                    continue; // item class is filtered out
-            }
+            AuctionEntry* auction = auctionHouse->GetAuction(order.AuctionId);
+            if (!auction || auction->pendingExpire || auction->bid != order.SeenBid)
+                continue; // auction changed since decision was made
+            auction->UpdateBid(order.BidPrice);
+        }
+        else if (Item* item = Item::CreateItem(order.ItemId, order.Count))
+            auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(order.HouseType == AUCTION_HOUSE_ALLIANCE ? 1 : (order.HouseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, order.Time, order.BidPrice, order.BuyoutPrice);
+    }
+}
 
-            uint32 itemValue = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
-            for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
+void AuctionHouseBot::GenerateSellOrders(AuctionHouseType houseType)
+{
+    std::lock_guard<std::mutex> guard(m_configMutex);
+    // loot tables and conditions can be reloaded by the world thread meanwhile, item prototypes are never reloaded
+    std::shared_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());
+
+    std::vector<AuctionHouseBotOrder> orders;
+    std::unordered_map<uint32, uint32> itemMap;
+
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootNormalConfig, m_creatureLootNormalTemplates, itemMap);       // normal creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootEliteConfig, m_creatureLootEliteTemplates, itemMap);         // elite creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareEliteConfig, m_creatureLootRareEliteTemplates, itemMap); // rare elite creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootWorldBossConfig, m_creatureLootWorldBossTemplates, itemMap); // world boss creature loot
+    AddLootToItemMap(&LootTemplates_Creature, m_creatureLootRareConfig, m_creatureLootRareTemplates, itemMap);           // rare creature loot
+
+    AddLootToItemMap(&LootTemplates_Disenchant, m_disenchantLootConfig, m_disenchantLootTemplates, itemMap);             // disenchant loot
+    AddLootToItemMap(&LootTemplates_Fishing, m_fishingLootConfig, m_fishingLootTemplates, itemMap);                      // fishing loot
+    AddLootToItemMap(&LootTemplates_Gameobject, m_gameobjectLootConfig, m_gameobjectLootTemplates, itemMap);             // gameobject loot
+    AddLootToItemMap(&LootTemplates_Skinning, m_skinningLootConfig, m_skinningLootTemplates, itemMap);                   // skinning loot
+
+    // profession items are a bit different (not looted)
+    if (m_professionItemsConfig[1] > 0 && m_professionItemsConfig[3] > 0 && m_professionItems.size() > 0)
+    {
+        int32 maxTemplates = m_professionItemsConfig[0] < 0 ? urand(0, m_professionItemsConfig[1] - m_professionItemsConfig[0]) + m_professionItemsConfig[0] : urand(m_professionItemsConfig[0], m_professionItemsConfig[1]);
+        if (maxTemplates > 0)
+        {
+            for (int32 templateCounter = 0; templateCounter < maxTemplates; ++templateCounter)
             {
-                uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
-                uint32 buyoutPrice = itemValue * count;
-                Item* item = Item::CreateItem(itemEntry.first, count);
-                if (buyoutPrice == 0 || !item)
-                    continue; // don't put up items we don't know the value of
-                uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
-                if (item)
-                    auctionHouse->AddAuction(sAuctionHouseStore.LookupEntry(houseType == AUCTION_HOUSE_ALLIANCE ? 1 : (houseType == AUCTION_HOUSE_HORDE ? 6 : 7)), item, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, bidPrice, buyoutPrice);
+                uint32 item = m_professionItems[urand(0, m_professionItems.size() - 1)];
+                ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(item);
+                if (!prototype || prototype->Quality == 0 || urand(0, (1 << (prototype->Quality - 1)) - 1) > 0)
+                    continue; // make it decreasingly likely that crafted items of higher quality is added to the auction house (white: 100%, green: 50%, blue: 25%, purple: 12.5%, ...)
+                uint32 count = (uint32) round((uint64)prototype->GetMaxStackSize() * urand(m_professionItemsConfig[2], m_professionItemsConfig[3]) / 100.0);
+                if (count <= 0)
+                    count = 1;
+                itemMap[item] += count;
             }
         }
-    } else if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE && urand(0, 99) < m_chanceBuy)
+    }
+
+    // remove items we've overridden (AddChance > 0) and add using given AddChance and stack size
+    for (auto& itemData : m_itemData)
     {
-        // Buy items
-        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
-        std::vector<AuctionEntry*> buyoutAuctions;
-        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+        if (itemData.second.AddChance > 0) // replace normal loot sources with custom chance of adding item
+            itemMap[itemData.first] = urand(0, 99) < itemData.second.AddChance ? urand(itemData.second.MinAmount, itemData.second.MaxAmount) : 0;
+    }
+
+    for (auto& itemEntry : itemMap)
+    {
+        ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(itemEntry.first);
+        if (!prototype || prototype->GetMaxStackSize() == 0)
+            continue; // really shouldn't happen, but better safe than sorry
+        auto iterator = m_itemData.find(prototype->ItemId);
+        if (iterator != m_itemData.end() && iterator->second.Value == 0)
+            continue; // item is blacklisted
+        if (iterator == m_itemData.end() || iterator->second.AddChance == 0)
         {
-            AuctionEntry* auction = itr->second;
-            if (auction->owner == 0 && auction->bid == 0)
-                continue; // ignore bidding/buying auctions that were created by ahbot and not bidded on by player
-            Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
-            if (!item)
-                continue; // shouldn't happen, but apparently it does(?)
-            auto prototype = item->GetProto();
-            if (!prototype)
-                continue; // shouldn't happen
-            auto iterator = m_itemData.find(prototype->ItemId);
-            if (iterator != m_itemData.end() && iterator->second.Value == 0)
-                continue; // item is blacklisted
-
-            uint32 buyItemCheck = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
-            buyItemCheck *= item->GetCount();
-            uint32 bidPrice = auction->bid + auction->GetAuctionOutBid();
-            if (auction->startbid > bidPrice)
-                bidPrice = auction->startbid;
-            if (auction->buyout > 0 && buyItemCheck > auction->buyout)
-                buyoutAuctions.push_back(auction); // can't buyout item here as that modifies the AuctionEntryMap, invalidating the iterator
-            else if (buyItemCheck > bidPrice)
-                auction->UpdateBid(bidPrice);
+            if (prototype->Bonding == BIND_WHEN_PICKED_UP || prototype->Bonding == BIND_QUEST_ITEM)
+                continue; // no BoP and quest items
+            if (prototype->Flags & ITEM_FLAG_HAS_LOOT)
+                continue; // nor items containing loot
+            if (m_itemValue[prototype->Quality][prototype->Class] == 0)
+                continue; // item class is filtered out
+        }
+
+        uint32 itemValue = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
+        for (uint32 stackCounter = 0; stackCounter < itemEntry.second; stackCounter += prototype->GetMaxStackSize())
+        {
+            uint32 count = itemEntry.second - stackCounter > prototype->GetMaxStackSize() ? prototype->GetMaxStackSize() : itemEntry.second - stackCounter;
+            uint32 buyoutPrice = itemValue * count;
+            if (buyoutPrice == 0)
+                continue; // don't put up items we don't know the value of
+            uint32 bidPrice = buyoutPrice * (urand(m_auctionBidMin, m_auctionBidMax)) / 100;
+            orders.push_back({ houseType, 0, itemEntry.first, count, bidPrice, buyoutPrice, urand(m_auctionTimeMin, m_auctionTimeMax) * HOUR, 0 });
         }
-        for (auto auction : buyoutAuctions)
-            auction->UpdateBid(auction->buyout);
     }
+
+    AddOrders(orders);
 }
 
-bool AuctionHouseBot::ReloadAllConfig()
+void AuctionHouseBot::GenerateBuyOrders(AuctionHouseType houseType, std::vector<AuctionHouseBotAuctionInfo> const& auctions)
 {
-    Initialize();
-    return true;
+    std::lock_guard<std::mutex> guard(m_configMutex);
+
+    std::vector<AuctionHouseBotOrder> orders;
+    for (auto const& auction : auctions)
+    {
+        ItemPrototype const* prototype = ObjectMgr::GetItemPrototype(auction.ItemId);
+        if (!prototype)
+            continue; // shouldn't happen
+        auto iterator = m_itemData.find(prototype->ItemId);
+        if (iterator != m_itemData.end() && iterator->second.Value == 0)
+            continue; // item is blacklisted
+
+        uint32 buyItemCheck = ValueWithVariance(iterator != m_itemData.end() ? iterator->second.Value : CalculateBuyoutPrice(prototype));
+        buyItemCheck *= auction.Count;
+        uint32 bidPrice = auction.Bid + auction.OutBid;
+        if (auction.StartBid > bidPrice)
+            bidPrice = auction.StartBid;
+        if (auction.Buyout > 0 && buyItemCheck > auction.Buyout)
+            orders.push_back({ houseType, auction.AuctionId, auction.ItemId, auction.Count, auction.Buyout, auction.Buyout, 0, auction.Bid });
+        else if (buyItemCheck > bidPrice)
+            orders.push_back({ houseType, auction.AuctionId, auction.ItemId, auction.Count, bidPrice, auction.Buyout, 0, auction.Bid });
+    }
+
+    AddOrders(orders);
+}
+
+void AuctionHouseBot::AddOrders(std::vector<AuctionHouseBotOrder>& orders)
+{
+    std::lock_guard<std::mutex> guard(m_ordersMutex);
+    std::move(orders.begin(), orders.end(), std::back_inserter(m_orders));
+}
+
+void AuctionHouseBot::ReloadAllConfig(std::function<void(bool)> callback)
+{
+    sAuctionMgr.QueueWorkerTask([this, callback]()
+    {
+        bool result = Initialize();
+        sWorld.GetMessager().AddMessage([callback, result](World* /*world*/) { callback(result); });
+    });
 }
 
 void AuctionHouseBot::Rebuild(bool all)
@@ -292,13 +361,15 @@ void AuctionHouseBot::Rebuild(bool all)
         }
     }
     // refill auction house with items, simulating typical max amount of items available after some time
-    uint32 updateCounter = ((m_auctionTimeMax - m_auctionTimeMin) / 2 + m_auctionTimeMin) * 90;
-    for (uint32 i = 0; i < updateCounter; ++i)
+    sAuctionMgr.QueueWorkerTask([this]()
     {
-        if (m_houseAction >= MAX_AUCTION_HOUSE_TYPE - 1)
-            m_houseAction = -1; // this prevents AHBot from buying items when refilling
-        Update();
-    }
+        uint32 updateCounter = ((m_auctionTimeMax - m_auctionTimeMin) / 2 + m_auctionTimeMin) * 90;
+        for (uint32 i = 0; i < updateCounter; ++i)
+        {
+            if (urand(0, 99) < m_chanceSell)
+                GenerateSellOrders(AuctionHouseType(i % MAX_AUCTION_HOUSE_TYPE));
+        }
+    });
 }
 
 void AuctionHouseBot::PrepareStatusInfos(AuctionHouseBotStatusInfo& statusInfo) const
@@ -332,6 +403,8 @@ void AuctionHouseBot::PrepareStatusInfos(AuctionHouseBotStatusInfo& statusInfo)
 
 void AuctionHouseBot::SetItemData(uint32 item, AuctionHouseBotItemData& itemData, bool reset)
 {
+    std::lock_guard<std::mutex> guard(m_configMutex);
+
     static SqlStatementID delItem;
     SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM ahbot_items WHERE item = ?");
     stmt.PExecute(item);
@@ -369,6 +442,8 @@ void AuctionHouseBot::SetItemData(uint32 item, AuctionHouseBotItemData& itemData
 
 AuctionHouseBotItemData AuctionHouseBot::GetItemData(uint32 item)
 {
+    std::lock_guard<std::mutex> guard(m_configMutex);
+
     auto iterator = m_itemData.find(item);
     if (iterator != m_itemData.end())
         return iterator->second;
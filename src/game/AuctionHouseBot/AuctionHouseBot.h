@@ -26,6 +26,11 @@
 #include "Loot/LootMgr.h"
 #include "Util.h"
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+
 struct AuctionHouseBotItemData
 {
     uint32 Value = 0;
@@ -42,18 +47,44 @@ struct AuctionHouseBotStatusInfoPerType
 
 typedef AuctionHouseBotStatusInfoPerType AuctionHouseBotStatusInfo[MAX_AUCTION_HOUSE_TYPE];
 
+// auction as seen by AHBot when deciding what to buy, copied in world thread
+struct AuctionHouseBotAuctionInfo
+{
+    uint32 AuctionId;
+    uint32 ItemId;
+    uint32 Count;
+    uint32 Bid;
+    uint32 StartBid;
+    uint32 OutBid;
+    uint32 Buyout;
+};
+
+// decision made in auction worker, applied in world thread by ProcessOrders
+struct AuctionHouseBotOrder
+{
+    AuctionHouseType HouseType;
+    uint32 AuctionId;                                       // 0 for new auction, else auction to bid on
+    uint32 ItemId;
+    uint32 Count;
+    uint32 BidPrice;                                        // start bid of new auction, else new bid
+    uint32 BuyoutPrice;
+    uint32 Time;
+    uint32 SeenBid;                                         // bid of auction when decided, order dropped if changed
+};
+
 class AuctionHouseBot
 {
     public:
         AuctionHouseBot();
         ~AuctionHouseBot();
 
-        void Initialize();
+        bool Initialize();                                  // false when the config file could not be read
         void SetConfigFileName(const std::string& filename) { m_configFileName = filename; }
         void Update();
+        void ProcessOrders();
 
         // Following methods are mainly used by level3.cpp for ingame/console commands
-        bool ReloadAllConfig();
+        void ReloadAllConfig(std::function<void(bool)> callback);    // callback runs in world thread once reloaded
         void Rebuild(bool all);
         void PrepareStatusInfos(AuctionHouseBotStatusInfo& statusInfo) const;
         void SetItemData(uint32 item, AuctionHouseBotItemData& itemData, bool reset = false);
@@ -68,13 +99,25 @@ class AuctionHouseBot
         uint32 CalculateBuyoutPrice(ItemPrototype const* prototype);
         uint32 ValueWithVariance(uint32 itemValue) { return (uint32) (itemValue + ((int32) urand(0, m_valueVariance * 2 + 1) - (int32) m_valueVariance) * (int32) (itemValue / 100)); };
 
+        // run in auction worker
+        void GenerateSellOrders(AuctionHouseType houseType);
+        void GenerateBuyOrders(AuctionHouseType houseType, std::vector<AuctionHouseBotAuctionInfo> const& auctions);
+        void AddOrders(std::vector<AuctionHouseBotOrder>& orders);
+
         std::string m_configFileName;
         Config m_ahBotCfg;
 
+        // guards config and item data, used by auction worker and world thread commands
+        std::mutex m_configMutex;
+
         uint32 m_houseAction;
 
-        uint32 m_chanceSell;
-        uint32 m_chanceBuy;
+        std::atomic<uint32> m_chanceSell;
+        std::atomic<uint32> m_chanceBuy;
+        uint32 m_budgetPerTick;
+
+        std::mutex m_ordersMutex;
+        std::deque<AuctionHouseBotOrder> m_orders;
 
         std::vector<int32> m_creatureLootNormalConfig;
         std::vector<int32> m_creatureLootRareConfig;
@@ -221,6 +221,11 @@ ChatCommand* ChatHandler::getCommandTable()
     {
         { "tempspawn",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleShowTemporarySpawnList,          "", nullptr },
         { "gridsloaded",    SEC_ADMINISTRATOR,  false, &ChatHandler::HandleGridsLoadedCount,                "", nullptr },
+        { "messages",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugMapMessagesCommand,         "", nullptr },
+        { "queries",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugSyncQueriesCommand,         "", nullptr },
+        { "writebehind",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugWriteBehindCommand,         "", nullptr },
+        { "packetsizes",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketSizesCommand,         "", nullptr },
+        { "frames",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugFramesCommand,              "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
@@ -271,6 +276,7 @@ ChatCommand* ChatHandler::getCommandTable()
         { "spawn",          SEC_GAMEMASTER,     true,  nullptr,                                             "", debugSpawnsCommandtable },
         { "debugflags",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugObjectFlags,                "", nullptr },
         { "packetlog",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugPacketLog,                  "", nullptr },
+        { "opcodestats",    SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeStatsCommand,         "", nullptr },
         { "dbscript",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugDbscript,                   "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
@@ -285,6 +285,12 @@ class ChatHandler
 
         bool HandleShowTemporarySpawnList(char* args);
         bool HandleGridsLoadedCount(char* args);
+        bool HandleDebugMapMessagesCommand(char* args);
+        bool HandleDebugSyncQueriesCommand(char* args);
+        bool HandleDebugWriteBehindCommand(char* args);
+        bool HandleDebugPacketSizesCommand(char* args);
+        bool HandleDebugOpcodeStatsCommand(char* args);
+        bool HandleDebugFramesCommand(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
         bool HandleDebugPlaySoundCommand(char* args);
@@ -81,14 +81,20 @@ bool ChatHandler::HandleAHBotRebuildCommand(char* args)
 
 bool ChatHandler::HandleAHBotReloadCommand(char* /*args*/)
 {
-    if (sAuctionHouseBot.ReloadAllConfig())
+    // the reload runs in the auction worker, the session may be gone when it is done
+    uint32 accountId = m_session ? m_session->GetAccountId() : 0;
+    sAuctionHouseBot.ReloadAllConfig([accountId](bool result)
     {
-        SendSysMessage(LANG_AHBOT_RELOAD_OK);
-        return true;
-    }
-    SendSysMessage(LANG_AHBOT_RELOAD_FAIL);
-    SetSentErrorMessage(true);
-    return false;
+        if (!accountId)
+        {
+            sLog.outString("%s", sObjectMgr.GetMangosStringForDbcLocale(result ? LANG_AHBOT_RELOAD_OK : LANG_AHBOT_RELOAD_FAIL));
+            return;
+        }
+
+        if (WorldSession* session = sWorld.FindSession(accountId))
+            ChatHandler(session).SendSysMessage(result ? LANG_AHBOT_RELOAD_OK : LANG_AHBOT_RELOAD_FAIL);
+    });
+    return true;
 }
 
 bool ChatHandler::HandleAHBotStatusCommand(char* /*args*/)
@@ -214,6 +220,7 @@ bool ChatHandler::HandleReloadAllAreaCommand(char* /*args*/)
 bool ChatHandler::HandleReloadAllLootCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables...");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTables();
     SendGlobalSysMessage("DB tables `*_loot_template` reloaded.");
     return true;
@@ -382,6 +389,7 @@ bool ChatHandler::HandleReloadCreatureQuestInvRelationsCommand(char* /*args*/)
 bool ChatHandler::HandleReloadConditionsCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading `conditions`... ");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     sObjectMgr.LoadConditions();
     SendGlobalSysMessage("DB table `conditions` reloaded.");
     return true;
@@ -472,6 +480,7 @@ bool ChatHandler::HandleReloadQuestTemplateCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`creature_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Creature();
     LootTemplates_Creature.CheckLootRefs();
     SendGlobalSysMessage("DB table `creature_loot_template` reloaded.");
@@ -481,6 +490,7 @@ bool ChatHandler::HandleReloadLootTemplatesCreatureCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`disenchant_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Disenchant();
     LootTemplates_Disenchant.CheckLootRefs();
     SendGlobalSysMessage("DB table `disenchant_loot_template` reloaded.");
@@ -490,6 +500,7 @@ bool ChatHandler::HandleReloadLootTemplatesDisenchantCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`fishing_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Fishing();
     LootTemplates_Fishing.CheckLootRefs();
     SendGlobalSysMessage("DB table `fishing_loot_template` reloaded.");
@@ -499,6 +510,7 @@ bool ChatHandler::HandleReloadLootTemplatesFishingCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`gameobject_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Gameobject();
     LootTemplates_Gameobject.CheckLootRefs();
     SendGlobalSysMessage("DB table `gameobject_loot_template` reloaded.");
@@ -508,6 +520,7 @@ bool ChatHandler::HandleReloadLootTemplatesGameobjectCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`item_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Item();
     LootTemplates_Item.CheckLootRefs();
     SendGlobalSysMessage("DB table `item_loot_template` reloaded.");
@@ -517,6 +530,7 @@ bool ChatHandler::HandleReloadLootTemplatesItemCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`pickpocketing_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Pickpocketing();
     LootTemplates_Pickpocketing.CheckLootRefs();
     SendGlobalSysMessage("DB table `pickpocketing_loot_template` reloaded.");
@@ -526,6 +540,7 @@ bool ChatHandler::HandleReloadLootTemplatesPickpocketingCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesProspectingCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`prospecting_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Prospecting();
     LootTemplates_Prospecting.CheckLootRefs();
     SendGlobalSysMessage("DB table `prospecting_loot_template` reloaded.");
@@ -535,6 +550,7 @@ bool ChatHandler::HandleReloadLootTemplatesProspectingCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`mail_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Mail();
     LootTemplates_Mail.CheckLootRefs();
     SendGlobalSysMessage("DB table `mail_loot_template` reloaded.");
@@ -544,6 +560,7 @@ bool ChatHandler::HandleReloadLootTemplatesMailCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`reference_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Reference();
     SendGlobalSysMessage("DB table `reference_loot_template` reloaded.");
     return true;
@@ -552,6 +569,7 @@ bool ChatHandler::HandleReloadLootTemplatesReferenceCommand(char* /*args*/)
 bool ChatHandler::HandleReloadLootTemplatesSkinningCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Loot Tables... (`skinning_loot_template`)");
+    std::unique_lock<std::shared_mutex> lootGuard(sAuctionMgr.GetLootDataLock());   // auction worker rolls loot
     LoadLootTemplates_Skinning();
     LootTemplates_Skinning.CheckLootRefs();
     SendGlobalSysMessage("DB table `skinning_loot_template` reloaded.");
@@ -3653,6 +3671,7 @@ void ChatHandler::HandleCharacterLevel(Player* player, ObjectGuid player_guid, u
     {
         // update level and XP at level, all other will be updated at loading
         CharacterDatabase.PExecute("UPDATE characters SET level = '%u', xp = 0 WHERE guid = '%u'", newlevel, player_guid.GetCounter());
+        sObjectMgr.UpdateCharacterDirectoryLevel(player_guid.GetCounter(), uint8(newlevel));
     }
 }
 
@@ -4229,6 +4248,7 @@ static bool HandleResetStatsOrLevelHelper(Player* player)
 
     player->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, DEFAULT_WORLD_OBJECT_SIZE);
     player->SetFloatValue(UNIT_FIELD_COMBATREACH, 1.5f);
+    player->GetPackedSlot().UpdateReach(player->GetCombatReach());
 
     player->setFactionForRace(player->getRace());
 
@@ -21,6 +21,10 @@
 #include "WorldPacket.h"
 #include "Entities/Player.h"
 #include "Server/Opcodes.h"
+#include "Server/PacketLog.h"
+#include "Server/PacketSizeStats.h"
+#include "Server/OpcodeStats.h"
+#include "World/FrameProfiler.h"
 #include "Chat/Chat.h"
 #include "Log.h"
 #include "Entities/Unit.h"
@@ -1408,6 +1412,259 @@ bool ChatHandler::HandleGridsLoadedCount(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleDebugMapMessagesCommand(char* /*args*/)
+{
+    MapManager::MapMapType const& maps = sMapMgr.Maps();
+    if (maps.empty())
+    {
+        SendSysMessage("No maps loaded.");
+        return true;
+    }
+
+    for (auto const& itr : maps)
+    {
+        Messager<Map> const& messager = itr.second->GetMessager();
+        uint64 posted = messager.GetPostedCount();
+        uint64 executed = messager.GetExecutedCount();
+        PSendSysMessage("Map %u instance %u: " UI64FMTD " messages posted, " UI64FMTD " pending, at most %u in one update.",
+                        itr.second->GetId(), itr.second->GetInstanceId(), posted, posted > executed ? posted - executed : 0, messager.GetMaxExecuteCount());
+    }
+    return true;
+}
+
+// .debug perf queries [reset|#count]
+bool ChatHandler::HandleDebugSyncQueriesCommand(char* args)
+{
+    DatabaseType* databases[] = { &WorldDatabase, &CharacterDatabase, &LoginDatabase, &LogsDatabase };
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        for (DatabaseType* database : databases)
+            database->GetQueryStats().Reset();
+
+        SendSysMessage("Synchronous query statistics reset.");
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        return false;
+
+    for (DatabaseType* database : databases)
+    {
+        SqlQueryStats& stats = database->GetQueryStats();
+        if (!stats.IsEnabled())
+            continue;
+
+        std::vector<SqlQueryStat> statements;
+        stats.GetTopStatements(statements, count);
+        if (statements.empty())
+            continue;
+
+        // statements are told apart by their normalized text only, call sites issuing the same one are summed up
+        PSendSysMessage("Database %s, top %u synchronous statements (normalized SQL) by total time:", stats.GetDatabaseName().c_str(), uint32(statements.size()));
+        for (SqlQueryStat const& statement : statements)
+        {
+            uint64 calls = statement.GetCalls();
+            PSendSysMessage("%08X: " UI64FMTD " calls (world " UI64FMTD ", map " UI64FMTD ", network " UI64FMTD "), total " UI64FMTD " ms, avg " UI64FMTD " us, max " UI64FMTD " us",
+                            statement.hash, calls, statement.calls[SQL_THREAD_WORLD], statement.calls[SQL_THREAD_MAP], statement.calls[SQL_THREAD_NETWORK],
+                            statement.totalTime / 1000, calls ? statement.totalTime / calls : 0, statement.maxTime);
+            PSendSysMessage("    %s", statement.sql.c_str());
+        }
+    }
+    return true;
+}
+
+// .debug perf writebehind
+bool ChatHandler::HandleDebugWriteBehindCommand(char* /*args*/)
+{
+    SqlWriteBehind const& writeBehind = CharacterDatabase.GetWriteBehind();
+    if (!writeBehind.GetWindow())
+    {
+        SendSysMessage("Character database updates are written at once (WriteBehindWindow = 0).");
+        return true;
+    }
+
+    PSendSysMessage("Character database delayed updates: " UI64FMTD ", statements written " UI64FMTD ", elided " UI64FMTD ", window %u ms",
+                    writeBehind.GetUpdates(), writeBehind.GetWritten(), writeBehind.GetElided(), writeBehind.GetWindow());
+    return true;
+}
+
+bool ChatHandler::HandleDebugPacketSizesCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sPacketSizeStats.Reset();
+        SendSysMessage("Packet size statistics reset.");
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        return false;
+
+    std::vector<PacketSizeStat> stats;
+    sPacketSizeStats.GetTopOpcodes(stats, count);
+    if (stats.empty())
+    {
+        SendSysMessage("No packets recorded.");
+        return true;
+    }
+
+    uint64 reallocations = 0;
+    uint64 avoided = 0;
+    PSendSysMessage("Top %u outgoing opcodes by packet count:", uint32(stats.size()));
+    for (PacketSizeStat const& stat : stats)
+    {
+        PSendSysMessage("%s: " UI64FMTD " packets, avg " UI64FMTD " bytes, max %u, reserve hint %u, reallocations " UI64FMTD ", avoided " UI64FMTD,
+                        LookupOpcodeName(stat.opcode), stat.count, stat.totalSize / stat.count, stat.maxSize, stat.hint, stat.reallocations, stat.avoided);
+
+        std::string distribution;
+        for (uint32 i = 0; i < PACKET_SIZE_BUCKETS; ++i)
+        {
+            if (!stat.buckets[i])
+                continue;
+
+            char bucket[64];
+            if (i + 1 < PACKET_SIZE_BUCKETS)
+                snprintf(bucket, sizeof(bucket), " <=%u: " UI64FMTD, PACKET_SIZE_MIN_BUCKET << i, stat.buckets[i]);
+            else
+                snprintf(bucket, sizeof(bucket), " >%u: " UI64FMTD, PACKET_SIZE_MIN_BUCKET << (i - 1), stat.buckets[i]);
+            distribution += bucket;
+        }
+        PSendSysMessage("   %s", distribution.c_str());
+
+        reallocations += stat.reallocations;
+        avoided += stat.avoided;
+    }
+
+    PSendSysMessage("Listed opcodes: " UI64FMTD " reallocations, " UI64FMTD " avoided by reserve hints", reallocations, avoided);
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeStatsCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sOpcodeStats.Reset();
+        SendSysMessage("Opcode handler statistics reset.");
+        return true;
+    }
+
+    bool byBytesOut = ExtractLiteralArg(&args, "bytes") != nullptr;
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10))
+        return false;
+
+    std::vector<OpcodeStat> stats;
+    sOpcodeStats.GetTopOpcodes(stats, count, byBytesOut);
+    if (stats.empty())
+    {
+        SendSysMessage("No packets handled.");
+        return true;
+    }
+
+    PSendSysMessage("Top %u opcodes by %s:", uint32(stats.size()), byBytesOut ? "bytes sent" : "total handler time");
+    for (OpcodeStat const& stat : stats)
+    {
+        uint64 calls = stat.GetCalls();
+        uint64 totalTime = stat.GetTotalTime();
+        PSendSysMessage("%s: " UI64FMTD " calls, total " UI64FMTD " ms, avg " UI64FMTD " us, bytes in " UI64FMTD ", out " UI64FMTD,
+                        LookupOpcodeName(stat.opcode), calls, totalTime / 1000, totalTime / calls, stat.bytesIn, stat.bytesOut);
+
+        for (uint32 role = SQL_THREAD_OTHER; role < MAX_SQL_THREAD_ROLE; ++role)
+            if (stat.calls[role])
+                PSendSysMessage("    %s: " UI64FMTD " calls, total " UI64FMTD " ms, max " UI64FMTD " us", GetSqlThreadRoleName(SqlThreadRole(role)),
+                                stat.calls[role], stat.totalTime[role] / 1000, stat.maxTime[role]);
+    }
+    return true;
+}
+
+bool ChatHandler::HandleDebugFramesCommand(char* args)
+{
+    if (ExtractLiteralArg(&args, "on"))
+    {
+        sFrameProfiler.SetEnabled(true);
+        SendSysMessage("Frame profiler enabled.");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "off"))
+    {
+        sFrameProfiler.SetEnabled(false);
+        SendSysMessage("Frame profiler disabled.");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "reset"))
+    {
+        sFrameProfiler.Reset();
+        SendSysMessage("Frame profiler history cleared.");
+        return true;
+    }
+
+    if (ExtractLiteralArg(&args, "dump"))
+    {
+        uint32 count;
+        if (!ExtractOptUInt32(&args, count, 5))
+            return false;
+
+        std::string filename = "frames_" + std::to_string(uint64(time(nullptr))) + ".json";
+        if (!sFrameProfiler.Dump(filename, count))
+        {
+            PSendSysMessage("Could not write %s.", filename.c_str());
+            SetSentErrorMessage(true);
+            return false;
+        }
+
+        PSendSysMessage("Slowest %u ticks written to %s in LogsDir.", count, filename.c_str());
+        return true;
+    }
+
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 3))
+        return false;
+
+    std::vector<FrameTick> ticks;
+    sFrameProfiler.GetSlowestTicks(ticks, count);
+    if (ticks.empty())
+    {
+        PSendSysMessage("No ticks recorded, the frame profiler is %s.", sFrameProfiler.IsEnabled() ? "enabled" : "disabled");
+        return true;
+    }
+
+    for (FrameTick const& tick : ticks)
+    {
+        std::map<std::string, uint64> phases;
+        std::map<std::pair<uint32, uint32>, uint64> maps;
+        for (FrameZone const& zone : tick.zones)
+        {
+            if (!strcmp(zone.name, "Map::Update"))
+                maps[std::make_pair(zone.mapId, zone.instanceId)] += zone.duration;
+            else if (strcmp(zone.name, "World::Update"))
+                phases[zone.name] += zone.duration;
+        }
+
+        PSendSysMessage("Tick %u, %u ms, %u zones:", tick.id, tick.duration / 1000, uint32(tick.zones.size()));
+
+        std::vector<std::pair<uint64, std::string>> slowestPhases;
+        for (auto const& phase : phases)
+            slowestPhases.emplace_back(phase.second, phase.first);
+        std::sort(slowestPhases.rbegin(), slowestPhases.rend());
+        for (uint32 i = 0; i < slowestPhases.size() && i < 8; ++i)
+            PSendSysMessage("    %s: " UI64FMTD " us", slowestPhases[i].second.c_str(), slowestPhases[i].first);
+
+        std::vector<std::pair<uint64, std::pair<uint32, uint32>>> slowestMaps;
+        for (auto const& map : maps)
+            slowestMaps.emplace_back(map.second, map.first);
+        std::sort(slowestMaps.rbegin(), slowestMaps.rend());
+        for (uint32 i = 0; i < slowestMaps.size() && i < 5; ++i)
+            PSendSysMessage("    map %u instance %u: " UI64FMTD " us", slowestMaps[i].second.first, slowestMaps[i].second.second, slowestMaps[i].first);
+    }
+    return true;
+}
+
 bool ChatHandler::HandleDebugWaypoint(char* args)
 {
     Creature* target = getSelectedCreature();
@@ -1863,10 +2120,26 @@ bool ChatHandler::HandleDebugRespawnDynguid(char* args)
 
 bool ChatHandler::HandleDebugPacketLog(char* args)
 {
+    if (!*args)
+    {
+        if (!sPacketLog->CanLogPacket())
+        {
+            SendSysMessage("Packet logging is disabled, PacketLogFile is not set.");
+            return true;
+        }
+
+        PSendSysMessage("Packets logged: " UI64FMTD ", dropped: " UI64FMTD " (" UI64FMTD " bytes)",
+                        sPacketLog->GetLoggedCount(), sPacketLog->GetDroppedCount(), sPacketLog->GetDroppedBytes());
+        return true;
+    }
+
     uint32 value;
     if (!ExtractUInt32(&args, value))
         return false;
 
+    if (!GetSession())
+        return false;
+
     GetSession()->SetPacketLogging(value == 1);
     return true;
 }
@@ -673,7 +673,11 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder, const bool checkA
             SendPacket(data);
             DEBUG_LOG("WORLD: Sent guild-motd (SMSG_GUILD_EVENT)");
 
-            guild->DisplayGuildBankTabsInfo(this);
+            // bank is loaded at first login of a member, the tabs are sent to everyone online once it is there
+            if (guild->IsDataLoaded())
+                guild->DisplayGuildBankTabsInfo(this);
+            else
+                guild->LoadDataAsync();
 
             guild->BroadcastEvent(GE_SIGNED_ON, pCurrChar->GetObjectGuid(), pCurrChar->GetName());
         }
@@ -1143,6 +1147,8 @@ void WorldSession::HandleChangePlayerNameOpcodeCallBack(QueryResult* result, uin
     CharacterDatabase.PExecute("DELETE FROM character_declinedname WHERE guid ='%u'", guidLow);
     CharacterDatabase.CommitTransaction();
 
+    sObjectMgr.UpdateCharacterDirectoryName(guidLow, newname);
+
     sLog.outChar("Account: %d (IP: %s) Character:[%s] (guid:%u) Changed name to: %s", session->GetAccountId(), session->GetRemoteAddress().c_str(), oldname.c_str(), guidLow, newname.c_str());
 
     WorldPacket data(SMSG_CHAR_RENAME, 1 + 8 + (newname.size() + 1));
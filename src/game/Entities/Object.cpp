@@ -1225,6 +1225,7 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
     m_position.y = y;
     m_position.z = z;
     m_position.o = orientation;
+    m_packedSlot.UpdatePosition(x, y, z, GetCombatReach());
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, orientation);
@@ -1235,6 +1236,7 @@ void WorldObject::Relocate(float x, float y, float z)
     m_position.x = x;
     m_position.y = y;
     m_position.z = z;
+    m_packedSlot.UpdatePosition(x, y, z, GetCombatReach());
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, GetOrientation());
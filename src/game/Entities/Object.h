@@ -1107,6 +1107,7 @@ class WorldObject : public Object
         void SetActiveObjectState(bool active);
 
         ViewPoint& GetViewPoint() { return m_viewPoint; }
+        GridPackedSlot& GetPackedSlot() { return m_packedSlot; }
 
         // ASSERT print helper
         bool PrintCoordinatesError(float x, float y, float z, char const* descr) const;
@@ -1219,6 +1220,7 @@ class WorldObject : public Object
         uint32 m_phaseMask;                                 // in area phase state
 
         Position m_position;
+        GridPackedSlot m_packedSlot;                        // entry in the packed storage of the current cell
         ViewPoint m_viewPoint;
         bool m_isActiveObject;
         uint64 m_debugFlags;
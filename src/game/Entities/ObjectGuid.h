@@ -21,6 +21,7 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include <algorithm>
 #include <atomic>
 
 enum TypeID
@@ -199,6 +200,102 @@ typedef std::set<ObjectGuid> GuidSet;
 typedef std::list<ObjectGuid> GuidList;
 typedef std::vector<ObjectGuid> GuidVector;
 
+// Guids of the objects a player's client knows about. Kept as a sorted vector so lookups are a binary
+// search over contiguous memory, every entry carries the number of the last visibility pass that saw it.
+// A visibility update marks what it visits in place and sweeps the rest, no copy of the set is made.
+class ClientGuidSet
+{
+    public:
+        typedef GuidVector::const_iterator const_iterator;
+
+        ClientGuidSet() : m_pass(0) {}
+
+        const_iterator begin() const { return m_guids.begin(); }
+        const_iterator end() const { return m_guids.end(); }
+        bool empty() const { return m_guids.empty(); }
+        size_t size() const { return m_guids.size(); }
+
+        void clear()
+        {
+            m_guids.clear();
+            m_passes.clear();
+        }
+
+        bool Contains(ObjectGuid guid) const { return std::binary_search(m_guids.begin(), m_guids.end(), guid); }
+
+        // entries added during a pass count as seen by it
+        void insert(ObjectGuid guid)
+        {
+            auto itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr != m_guids.end() && *itr == guid)
+                return;
+
+            m_passes.insert(m_passes.begin() + (itr - m_guids.begin()), m_pass);
+            m_guids.insert(itr, guid);
+        }
+
+        void erase(ObjectGuid guid)
+        {
+            auto itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr == m_guids.end() || *itr != guid)
+                return;
+
+            m_passes.erase(m_passes.begin() + (itr - m_guids.begin()));
+            m_guids.erase(itr);
+        }
+
+        uint32 BeginPass() { return ++m_pass; }
+
+        void MarkSeen(ObjectGuid guid)
+        {
+            auto itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            if (itr != m_guids.end() && *itr == guid)
+                m_passes[itr - m_guids.begin()] = m_pass;
+        }
+
+        // a nested pass started after 'pass' also counts, it saw the entry later
+        bool IsUnseen(ObjectGuid guid, uint32 pass) const
+        {
+            auto itr = std::lower_bound(m_guids.begin(), m_guids.end(), guid);
+            return itr != m_guids.end() && *itr == guid && m_passes[itr - m_guids.begin()] < pass;
+        }
+
+        // calls f(guid) for every entry not seen by 'pass', f must not modify the set
+        template<class F>
+        void ForEachUnseen(uint32 pass, F&& f) const
+        {
+            for (size_t i = 0; i < m_guids.size(); ++i)
+                if (m_passes[i] < pass)
+                    f(m_guids[i]);
+        }
+
+        // moves every entry not seen by 'pass' into 'erased'
+        void EraseUnseen(uint32 pass, GuidVector& erased)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < m_guids.size(); ++i)
+            {
+                if (m_passes[i] < pass)
+                {
+                    erased.push_back(m_guids[i]);
+                    continue;
+                }
+
+                m_guids[kept] = m_guids[i];
+                m_passes[kept] = m_passes[i];
+                ++kept;
+            }
+
+            m_guids.resize(kept);
+            m_passes.resize(kept);
+        }
+
+    private:
+        GuidVector m_guids;
+        std::vector<uint32> m_passes;                       // parallel to m_guids
+        uint32 m_pass;
+};
+
 // minimum buffer size for packed guid is 9 bytes
 #define PACKED_GUID_MIN_BUFFER_SIZE 9
 
@@ -23,6 +23,7 @@
 #include "Server/Opcodes.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 #include "World/World.h"
+#include "World/PlayerSaveScheduler.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
 #include "UpdateMask.h"
@@ -518,6 +519,7 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
     // randomize first save time in range [CONFIG_UINT32_INTERVAL_SAVE] around [CONFIG_UINT32_INTERVAL_SAVE]
     // this must help in case next save after mass player load after server startup
     m_nextSave = urand(m_nextSave / 2, m_nextSave * 3 / 2);
+    m_saveRequested = false;
 
     clearResurrectRequestData();
 
@@ -659,6 +661,9 @@ Player::~Player()
 {
     CleanupsBeforeDelete();
 
+    if (m_saveRequested)
+        sPlayerSaveScheduler.Cancel(GetObjectGuid());
+
     // it must be unloaded already in PlayerLogout and accessed only for loggined player
     // m_social = nullptr;
 
@@ -1538,14 +1543,24 @@ void Player::Update(const uint32 diff)
     if (m_deathState == JUST_DIED)
         KillPlayer();
 
-    if (m_nextSave > 0)
+    if (m_saveRequested)
     {
-        if (diff >= m_nextSave)
+        if (sPlayerSaveScheduler.TakeGrant(GetObjectGuid()))
         {
-            // m_nextSave reseted in SaveToDB call
+            // m_nextSave and m_saveRequested reseted in SaveToDB call
             SaveToDB();
             DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
         }
+    }
+    else if (m_nextSave > 0)
+    {
+        if (diff >= m_nextSave)
+        {
+            // the scheduler spreads autosaves over the interval and holds them back while the database is behind
+            m_nextSave = 0;
+            m_saveRequested = true;
+            sPlayerSaveScheduler.RequestSave(GetObjectGuid(), GetSaveDirtyScore());
+        }
         else
             m_nextSave -= diff;
     }
@@ -3721,6 +3736,13 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
             uint64 cat_time = fields[3].GetUInt64();
             uint32 item_id = fields[4].GetUInt32();
 
+            // every row read counts as saved, so rows skipped below get deleted by the next save
+            SavedSpellCooldown& saved = m_savedSpellCooldowns[spell_id];
+            saved.spellExpireTime = spell_time;
+            saved.category = category;
+            saved.catExpireTime = cat_time;
+            saved.itemId = item_id;
+
             SpellEntry const* spellEntry = sSpellTemplate.LookupEntry<SpellEntry>(spell_id);
             if (!spellEntry)
             {
@@ -3772,13 +3794,10 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 void Player::_SaveSpellCooldowns()
 {
     static SqlStatementID deleteSpellCooldown;
-
-    // delete all old cooldown
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
     static SqlStatementID insertSpellCooldown;
+    static SqlStatementID updateSpellCooldown;
 
+    SavedSpellCooldownMap currentCooldowns;
     for (auto& cdItr : m_cooldownMap)
     {
         auto& cdData = cdItr.second;
@@ -3788,19 +3807,55 @@ void Player::_SaveSpellCooldowns()
             TimePoint cTime = TimePoint::min();
             cdData->GetSpellCDExpireTime(sTime);
             cdData->GetCatCDExpireTime(cTime);
-            uint64 spellExpireTime = uint64(Clock::to_time_t(sTime));
-            uint64 catExpireTime = uint64(Clock::to_time_t(cTime));
 
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
+            SavedSpellCooldown& cooldown = currentCooldowns[cdData->GetSpellId()];
+            cooldown.spellExpireTime = uint64(Clock::to_time_t(sTime));
+            cooldown.category = cdData->GetCategory();
+            cooldown.catExpireTime = uint64(Clock::to_time_t(cTime));
+            cooldown.itemId = cdData->GetItemId();
+        }
+    }
+
+    for (const auto& savedCooldown : m_savedSpellCooldowns)
+    {
+        if (currentCooldowns.find(savedCooldown.first) != currentCooldowns.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ? AND SpellId = ?");
+        stmt.PExecute(GetGUIDLow(), savedCooldown.first);
+    }
+
+    for (const auto& currentCooldown : currentCooldowns)
+    {
+        SavedSpellCooldown const& cooldown = currentCooldown.second;
+        SavedSpellCooldownMap::const_iterator saved = m_savedSpellCooldowns.find(currentCooldown.first);
+        if (saved != m_savedSpellCooldowns.end())
+        {
+            if (saved->second == cooldown)
+                continue;
+
+            SqlStatement stmt = CharacterDatabase.CreateStatement(updateSpellCooldown, "UPDATE character_spell_cooldown SET SpellExpireTime = ?, Category = ?, CategoryExpireTime = ?, ItemId = ? WHERE guid = ? AND SpellId = ?");
+            stmt.addUInt64(cooldown.spellExpireTime);
+            stmt.addUInt32(cooldown.category);
+            stmt.addUInt64(cooldown.catExpireTime);
+            stmt.addUInt32(cooldown.itemId);
             stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt32(cdData->GetSpellId());
-            stmt.addUInt64(spellExpireTime);
-            stmt.addUInt32(cdData->GetCategory());
-            stmt.addUInt64(catExpireTime);
-            stmt.addUInt32(cdData->GetItemId());
+            stmt.addUInt32(currentCooldown.first);
             stmt.Execute();
+            continue;
         }
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt32(currentCooldown.first);
+        stmt.addUInt64(cooldown.spellExpireTime);
+        stmt.addUInt32(cooldown.category);
+        stmt.addUInt64(cooldown.catExpireTime);
+        stmt.addUInt32(cooldown.itemId);
+        stmt.Execute();
     }
+
+    m_savedSpellCooldowns.swap(currentCooldowns);
 }
 
 
@@ -4308,11 +4363,13 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             CharacterDatabase.PExecute("DELETE FROM guild_eventlog WHERE PlayerGuid1 = '%u' OR PlayerGuid2 = '%u'", lowguid, lowguid);
             CharacterDatabase.PExecute("DELETE FROM guild_bank_eventlog WHERE PlayerGuid = '%u'", lowguid);
             CharacterDatabase.CommitTransaction();
+            sObjectMgr.RemoveCharacterDirectoryEntry(lowguid);
             break;
         }
         // The character gets unlinked from the account, the name gets freed up and appears as deleted ingame
         case 1:
             CharacterDatabase.PExecute("UPDATE characters SET deleteInfos_Name=name, deleteInfos_Account=account, deleteDate='" UI64FMTD "', name='', account=0 WHERE guid=%u", uint64(time(nullptr)), lowguid);
+            sObjectMgr.RemoveCharacterDirectoryEntry(lowguid);
             break;
         default:
             sLog.outError("Player::DeleteFromDB: Unsupported delete method: %u.", charDelete_method);
@@ -6870,17 +6927,11 @@ uint32 Player::GetZoneIdFromDB(ObjectGuid guid)
 
 uint32 Player::GetLevelFromDB(ObjectGuid guid)
 {
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT level FROM characters WHERE guid='%u'", lowguid);
-    if (!result)
+    CharacterDirectoryEntry entry;
+    if (!sObjectMgr.GetCharacterDirectoryEntry(guid.GetCounter(), entry))
         return 0;
 
-    Field* fields = result->Fetch();
-    uint32 level = fields[0].GetUInt32();
-    delete result;
-
-    return level;
+    return entry.level;
 }
 
 void Player::UpdateArea(uint32 newArea)
@@ -15520,6 +15571,16 @@ void Player::_LoadAuras(QueryResult* result, uint32 timediff)
             int32 remaintime = fields[12].GetInt32();
             uint32 effIndexMask = fields[13].GetUInt32();
 
+            // every row read counts as saved, so rows skipped below get deleted by the next save
+            SavedAuraRow& saved = m_savedAuras[SavedAuraKey(caster_guid.GetRawValue(), item_lowguid, spellid)];
+            saved.stackCount = stackcount;
+            saved.charges = remaincharges;
+            std::copy(std::begin(damage), std::end(damage), std::begin(saved.damage));
+            std::copy(std::begin(periodicTime), std::end(periodicTime), std::begin(saved.periodicTime));
+            saved.maxDuration = maxduration;
+            saved.remainTime = remaintime;
+            saved.effIndexMask = effIndexMask;
+
             SpellEntry const* spellproto = sSpellTemplate.LookupEntry<SpellEntry>(spellid);
             if (!spellproto)
             {
@@ -16521,6 +16582,11 @@ void Player::SaveToDB()
     // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
     // delay auto save at any saves (manual, in code, or autosave)
     m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    if (m_saveRequested)
+    {
+        m_saveRequested = false;
+        sPlayerSaveScheduler.Cancel(GetObjectGuid());
+    }
 
     // lets allow only players in world to be saved
     if (IsBeingTeleportedFar())
@@ -16716,6 +16782,7 @@ void Player::SaveToDB()
     GetSession()->SaveTutorialsData();                      // changed only while character in game
 
     CharacterDatabase.CommitTransaction();
+    sObjectMgr.UpdateCharacterDirectoryEntry(this);
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
@@ -16727,6 +16794,26 @@ void Player::SaveToDB()
         pet->SavePetToDB(PET_SAVE_AS_CURRENT, this);
 }
 
+// rough amount of unsaved rows, autosaves of players with more pending changes are scheduled first
+uint32 Player::GetSaveDirtyScore() const
+{
+    uint32 score = uint32(m_itemUpdateQueue.size());
+
+    for (const auto& questStatus : mQuestStatus)
+        if (questStatus.second.uState != QUEST_UNCHANGED)
+            ++score;
+
+    for (const auto& skillStatus : mSkillStatus)
+        if (skillStatus.second.uState != SKILL_UNCHANGED)
+            ++score;
+
+    for (const auto& spell : m_spells)
+        if (spell.second.state != PLAYERSPELL_UNCHANGED)
+            ++score;
+
+    return score;
+}
+
 // fast save function for item/money cheating preventing - save only inventory and money state
 void Player::SaveInventoryAndGoldToDB()
 {
@@ -16792,73 +16879,143 @@ void Player::_SaveActions()
     }
 }
 
-void Player::_SaveAuras()
+bool SavedAuraRow::IsSameAs(SavedAuraRow const& saved, bool exactDuration) const
 {
-    static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
+    if (stackCount != saved.stackCount || charges != saved.charges || maxDuration != saved.maxDuration || effIndexMask != saved.effIndexMask)
+        return false;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        if (damage[i] != saved.damage[i] || periodicTime[i] != saved.periodicTime[i])
+            return false;
 
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
+    if (remainTime == saved.remainTime)
+        return true;
 
-    if (auraHolders.empty())
-        return;
+    // remaintime is relative to logout_time, which every save writes anew. A row that is not rewritten
+    // is restored after a crash with the time counted down since it was written on top, keep that small.
+    return !exactDuration && remainTime >= 0 && remainTime < saved.remainTime && saved.remainTime - remainTime <= AURA_SAVE_MAX_DRIFT;
+}
+
+void Player::_SaveAuras()
+{
+    static SqlStatementID insertAura ;
+    static SqlStatementID updateAura ;
+    static SqlStatementID deleteAura ;
 
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    // remaining times are written exactly on logout only, after a crash auras may last up to AURA_SAVE_MAX_DRIFT longer
+    bool const exactDuration = GetSession()->isLogingOut();
 
-    for (const auto& auraHolder : auraHolders)
+    SavedAuraMap currentAuras;
+    for (const auto& auraHolder : GetSpellAuraHolderMap())
     {
         SpellAuraHolder* holder = auraHolder.second;
         // skip all holders from spells that are passive or channeled
         // save singleTarget auras if self cast.
-        if (holder->IsSaveToDbHolder())
+        if (!holder->IsSaveToDbHolder())
+            continue;
+
+        SavedAuraRow row;
+        row.effIndexMask = 0;
+
+        for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         {
-            int32  damage[MAX_EFFECT_INDEX];
-            uint32 periodicTime[MAX_EFFECT_INDEX];
-            uint32 effIndexMask = 0;
+            row.damage[i] = 0;
+            row.periodicTime[i] = 0;
 
-            for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+            if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
             {
-                damage[i] = 0;
-                periodicTime[i] = 0;
-
-                if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
-                {
-                    // don't save not own area auras
-                    if (!aur->IsSaveToDbAura())
-                        continue;
+                // don't save not own area auras
+                if (!aur->IsSaveToDbAura())
+                    continue;
 
-                    damage[i] = aur->GetModifier()->m_amount;
-                    periodicTime[i] = aur->GetModifier()->periodictime;
-                    effIndexMask |= (1 << i);
-                }
+                row.damage[i] = aur->GetModifier()->m_amount;
+                row.periodicTime[i] = aur->GetModifier()->periodictime;
+                row.effIndexMask |= (1 << i);
             }
+        }
+
+        if (!row.effIndexMask)
+            continue;
+
+        row.stackCount = holder->GetStackAmount();
+        row.charges = uint8(holder->GetAuraCharges());
+        row.maxDuration = holder->GetAuraMaxDuration();
+        row.remainTime = holder->GetAuraDuration();
+
+        currentAuras[SavedAuraKey(holder->GetCasterGuid().GetRawValue(), holder->GetCastItemGuid().GetCounter(), holder->GetId())] = row;
+    }
+
+    for (const auto& savedAura : m_savedAuras)
+    {
+        if (currentAuras.find(savedAura.first) != currentAuras.end())
+            continue;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAura, "DELETE FROM character_aura WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(std::get<0>(savedAura.first));
+        stmt.addUInt32(std::get<1>(savedAura.first));
+        stmt.addUInt32(std::get<2>(savedAura.first));
+        stmt.Execute();
+    }
 
-            if (!effIndexMask)
+    for (auto& currentAura : currentAuras)
+    {
+        SavedAuraRow& row = currentAura.second;
+        SavedAuraMap::const_iterator saved = m_savedAuras.find(currentAura.first);
+        if (saved != m_savedAuras.end())
+        {
+            if (row.IsSameAs(saved->second, exactDuration))
+            {
+                row = saved->second;                        // keep tracking what the database holds
                 continue;
+            }
 
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt64(holder->GetCasterGuid().GetRawValue());
-            stmt.addUInt32(holder->GetCastItemGuid().GetCounter());
-            stmt.addUInt32(holder->GetId());
-            stmt.addUInt32(holder->GetStackAmount());
-            stmt.addUInt8(holder->GetAuraCharges());
+            SqlStatement stmt = CharacterDatabase.CreateStatement(updateAura, "UPDATE character_aura SET stackcount = ?, remaincharges = ?, "
+                                "basepoints0 = ?, basepoints1 = ?, basepoints2 = ?, periodictime0 = ?, periodictime1 = ?, periodictime2 = ?, maxduration = ?, remaintime = ?, effIndexMask = ? "
+                                "WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+            stmt.addUInt32(row.stackCount);
+            stmt.addUInt8(uint8(row.charges));
 
-            for (int i : damage)
+            for (int32 i : row.damage)
                 stmt.addInt32(i);
 
-            for (unsigned int i : periodicTime)
+            for (uint32 i : row.periodicTime)
                 stmt.addUInt32(i);
 
-            stmt.addInt32(holder->GetAuraMaxDuration());
-            stmt.addInt32(holder->GetAuraDuration());
-            stmt.addUInt32(effIndexMask);
+            stmt.addInt32(row.maxDuration);
+            stmt.addInt32(row.remainTime);
+            stmt.addUInt32(row.effIndexMask);
+            stmt.addUInt32(GetGUIDLow());
+            stmt.addUInt64(std::get<0>(currentAura.first));
+            stmt.addUInt32(std::get<1>(currentAura.first));
+            stmt.addUInt32(std::get<2>(currentAura.first));
             stmt.Execute();
+            continue;
         }
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(insertAura, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+                            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
+                            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt64(std::get<0>(currentAura.first));
+        stmt.addUInt32(std::get<1>(currentAura.first));
+        stmt.addUInt32(std::get<2>(currentAura.first));
+        stmt.addUInt32(row.stackCount);
+        stmt.addUInt8(uint8(row.charges));
+
+        for (int32 i : row.damage)
+            stmt.addInt32(i);
+
+        for (uint32 i : row.periodicTime)
+            stmt.addUInt32(i);
+
+        stmt.addInt32(row.maxDuration);
+        stmt.addInt32(row.remainTime);
+        stmt.addUInt32(row.effIndexMask);
+        stmt.Execute();
     }
+
+    m_savedAuras.swap(currentAuras);
 }
 
 void Player::_SaveInventory()
@@ -17321,6 +17478,8 @@ void Player::SavePositionInDB(ObjectGuid guid, uint32 mapid, float x, float y, f
        << "transguid='0',taxi_path='' WHERE guid='" << guid.GetCounter() << "'";
     DEBUG_LOG("%s", ss.str().c_str());
     CharacterDatabase.Execute(ss.str().c_str());
+
+    sObjectMgr.UpdateCharacterDirectoryMap(guid.GetCounter(), mapid);
 }
 
 void Player::SetUInt32ValueInArray(Tokens& tokens, uint16 index, uint32 value)
@@ -43,6 +43,7 @@
 #include "Cinematics/CinematicMgr.h"
 
 #include <functional>
+#include <tuple>
 #include <vector>
 
 struct Mail;
@@ -125,6 +126,42 @@ struct SpellCooldown
 
 typedef std::map<uint32, SpellCooldown> SpellCooldowns;
 
+#define AURA_SAVE_MAX_DRIFT (MINUTE * IN_MILLISECONDS)     // remaining time counted down since the last write that still does not need a rewrite
+
+// character_aura row as last written, saves only write rows that differ from it
+struct SavedAuraRow
+{
+    uint32 stackCount;
+    uint32 charges;
+    int32  damage[MAX_EFFECT_INDEX];
+    uint32 periodicTime[MAX_EFFECT_INDEX];
+    int32  maxDuration;
+    int32  remainTime;
+    uint32 effIndexMask;
+
+    // a remaining time that only counted down by at most AURA_SAVE_MAX_DRIFT since the last write is not a change unless exactDuration is set
+    bool IsSameAs(SavedAuraRow const& saved, bool exactDuration) const;
+};
+
+typedef std::tuple<uint64 /*caster guid*/, uint32 /*item lowguid*/, uint32 /*spell*/> SavedAuraKey;
+typedef std::map<SavedAuraKey, SavedAuraRow> SavedAuraMap;
+
+// character_spell_cooldown row as last written
+struct SavedSpellCooldown
+{
+    uint64 spellExpireTime;
+    uint32 category;
+    uint64 catExpireTime;
+    uint32 itemId;
+
+    bool operator==(SavedSpellCooldown const& other) const
+    {
+        return spellExpireTime == other.spellExpireTime && category == other.category && catExpireTime == other.catExpireTime && itemId == other.itemId;
+    }
+};
+
+typedef std::unordered_map<uint32 /*spell*/, SavedSpellCooldown> SavedSpellCooldownMap;
+
 enum TrainerSpellState
 {
     TRAINER_SPELL_GREEN         = 0,
@@ -1817,6 +1854,7 @@ class Player : public Unit
         void SetLaunched(bool apply) { m_launched = apply; }
 
         WorldLocation& GetTeleportDest() { return m_teleport_dest; }
+        WorldLocation const& GetTeleportDest() const { return m_teleport_dest; }
         bool IsBeingTeleported() const { return m_semaphoreTeleport_Near || m_semaphoreTeleport_Far; }
         bool IsBeingTeleportedNear() const { return m_semaphoreTeleport_Near; }
         bool IsBeingTeleportedFar() const { return m_semaphoreTeleport_Far; }
@@ -2121,6 +2159,7 @@ class Player : public Unit
 
         uint32 GetSaveTimer() const { return m_nextSave; }
         void   SetSaveTimer(uint32 timer) { m_nextSave = timer; }
+        uint32 GetSaveDirtyScore() const;
 
         // Recall position
         uint32 m_recallMap;
@@ -2138,10 +2177,10 @@ class Player : public Unit
         Object* GetObjectByTypeMask(ObjectGuid guid, TypeMask typemask);
 
         // currently visible objects at player client
-        bool HasAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.find(u->GetObjectGuid()) != m_clientGUIDs.end(); }
+        bool HasAtClient(WorldObject const* u) { return u == this || m_clientGUIDs.Contains(u->GetObjectGuid()); }
         void AddAtClient(WorldObject* target);
         void RemoveAtClient(WorldObject* target);
-        GuidSet& GetClientGuids() { return m_clientGUIDs; }
+        ClientGuidSet& GetClientGuids() { return m_clientGUIDs; }
 
         bool IsVisibleInGridForPlayer(Player* pl) const override;
         bool IsVisibleGloballyFor(Player* u) const;
@@ -2409,6 +2448,7 @@ class Player : public Unit
 
         Team m_team;
         uint32 m_nextSave;
+        bool m_saveRequested;                               // autosave due, waiting for sPlayerSaveScheduler
         time_t m_speakTime;
         uint32 m_speakCount;
         Difficulty m_dungeonDifficulty;
@@ -2436,6 +2476,9 @@ class Player : public Unit
 
         ActionButtonList m_actionButtons;
 
+        SavedAuraMap m_savedAuras;                          // character_aura content, kept in sync by _LoadAuras/_SaveAuras
+        SavedSpellCooldownMap m_savedSpellCooldowns;        // character_spell_cooldown content
+
         float m_auraBaseMod[BASEMOD_END][MOD_END];
         int16 m_baseRatingValue[MAX_COMBAT_RATING];
 
@@ -2615,7 +2658,7 @@ class Player : public Unit
         Spell* m_modsSpell;
         std::set<SpellModifierPair>* m_consumedMods;
 
-        GuidSet m_clientGUIDs;
+        ClientGuidSet m_clientGUIDs;
 
         // Recruit-A-Friend
         uint8 m_grantableLevels;
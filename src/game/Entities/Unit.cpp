@@ -467,13 +467,16 @@ void Unit::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    auto meas = metric::make_slow_duration<std::chrono::microseconds>("unit.update", 1000, [this](std::map<std::string, std::string>& tags, std::map<std::string, boost::any>& /*fields*/)
+    {
+        tags = {
+            { "entry", std::to_string(GetEntry()) },
+            { "guid", std::to_string(GetGUIDLow()) },
+            { "unit_type", std::to_string(GetGUIDHigh()) },
+            { "map_id", std::to_string(GetMapId()) },
+            { "instance_id", std::to_string(GetInstanceId()) }
+        };
+    });
 #endif
 
     /*if(p_time > m_AurasCheck)
@@ -518,13 +521,16 @@ void Unit::Update(const uint32 diff)
     if (AI() && IsAlive())
     {
 #ifdef BUILD_METRICS
-        metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
+        auto meas_ai = metric::make_slow_duration<std::chrono::microseconds>("unit.update.ai", 1000, [this](std::map<std::string, std::string>& tags, std::map<std::string, boost::any>& /*fields*/)
+        {
+            tags = {
+                { "entry", std::to_string(GetEntry()) },
+                { "guid", std::to_string(GetGUIDLow()) },
+                { "unit_type", std::to_string(GetGUIDHigh()) },
+                { "map_id", std::to_string(GetMapId()) },
+                { "instance_id", std::to_string(GetInstanceId()) }
+            };
+        });
 #endif
 
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
@@ -4303,15 +4309,22 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
 void Unit::_UpdateSpells(uint32 time)
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update.spells", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
-
-    std::vector<uint32> updatedSpellIds;
+    auto meas = metric::make_slow_duration<std::chrono::microseconds>("unit.update.spells", 1000, [this](std::map<std::string, std::string>& tags, std::map<std::string, boost::any>& fields)
+    {
+        tags = {
+            { "entry", std::to_string(GetEntry()) },
+            { "guid", std::to_string(GetGUIDLow()) },
+            { "unit_type", std::to_string(GetGUIDHigh()) },
+            { "map_id", std::to_string(GetMapId()) },
+            { "instance_id", std::to_string(GetInstanceId()) }
+        };
+
+        // holders left after the update, listed only for slow updates
+        std::string logging;
+        for (auto const& holder : m_spellAuraHolders)
+            logging += std::to_string(holder.first) + ",";
+        fields["spells"] = "\"" + logging + "\"";
+    });
 #endif
 
     if (m_currentSpells[CURRENT_AUTOREPEAT_SPELL])
@@ -4334,9 +4347,6 @@ void Unit::_UpdateSpells(uint32 time)
         SpellAuraHolder* i_holder = m_spellAuraHoldersUpdateIterator->second;
         ++m_spellAuraHoldersUpdateIterator;                 // need shift to next for allow update if need into aura update
         i_holder->UpdateHolder(time);
-#ifdef BUILD_METRICS
-        updatedSpellIds.push_back(i_holder->GetId());
-#endif
     }
 
     // remove expired auras
@@ -4352,12 +4362,6 @@ void Unit::_UpdateSpells(uint32 time)
         else
             ++iter;
     }
-#ifdef BUILD_METRICS
-    std::string logging;
-    for (uint32 spellId : updatedSpellIds)
-        logging += std::to_string(spellId) + ",";
-    meas.add_field("spells", "\"" + logging + "\"");
-#endif
 }
 
 void Unit::_UpdateAutoRepeatSpell()
@@ -10753,6 +10757,7 @@ void Unit::UpdateModelData()
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, GetObjectScale() * modelInfo->bounding_radius);
 
         SetFloatValue(UNIT_FIELD_COMBATREACH, GetObjectScale() * modelInfo->combat_reach);
+        GetPackedSlot().UpdateReach(GetCombatReach());
 
         SetBaseWalkSpeed(modelInfo->SpeedWalk);
         SetBaseRunSpeed(modelInfo->SpeedRun, false);
@@ -11529,8 +11534,13 @@ void Unit::OnRelocated()
         m_last_notified_position.y = GetPositionY();
         m_last_notified_position.z = GetPositionZ();
 
-        GetViewPoint().Call_UpdateVisibilityForOwner();
-        UpdateObjectVisibility();
+        if (World::IsRelocationVisibilityBatched())
+            GetMap()->AddRelocatedUnit(this);
+        else
+        {
+            GetViewPoint().Call_UpdateVisibilityForOwner();
+            UpdateObjectVisibility();
+        }
     }
     ScheduleAINotify(World::GetRelocationAINotifyDelay());
 }
@@ -11545,13 +11555,16 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (movespline->Finalized())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    auto meas = metric::make_slow_duration<std::chrono::microseconds>("unit.updatesplinemovement", 1000, [this](std::map<std::string, std::string>& tags, std::map<std::string, boost::any>& /*fields*/)
+    {
+        tags = {
+            { "entry", std::to_string(GetEntry()) },
+            { "guid", std::to_string(GetGUIDLow()) },
+            { "unit_type", std::to_string(GetGUIDHigh()) },
+            { "map_id", std::to_string(GetMapId()) },
+            { "instance_id", std::to_string(GetInstanceId()) }
+        };
+    });
 #endif
     movespline->updateState(t_diff);
     bool arrived = movespline->Finalized();
@@ -12328,8 +12341,10 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
+        std::vector<BasicEvent*> events;
+        target->m_events.GetEvents(events);
+        for (BasicEvent* e : events)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(e))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
@@ -2085,8 +2085,7 @@ void ObjectMgr::AddCreatureToGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
-            cell_guids.creatures.insert(guid);
+            mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].creatures.Insert(cell_id, guid);
         }
     }
 }
@@ -2101,8 +2100,9 @@ void ObjectMgr::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
-            cell_guids.creatures.erase(guid);
+            MapObjectGuids::iterator itr = mMapObjectGuids.find(MAKE_PAIR32(data->mapid, i));
+            if (itr != mMapObjectGuids.end())
+                itr->second.creatures.Erase(cell_id, guid);
         }
     }
 }
@@ -2388,8 +2388,7 @@ void ObjectMgr::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
-            cell_guids.gameobjects.insert(guid);
+            mMapObjectGuids[MAKE_PAIR32(data->mapid, i)].gameobjects.Insert(cell_id, guid);
         }
     }
 }
@@ -2404,8 +2403,9 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
             CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
             uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-            CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(data->mapid, i)][cell_id];
-            cell_guids.gameobjects.erase(guid);
+            MapObjectGuids::iterator itr = mMapObjectGuids.find(MAKE_PAIR32(data->mapid, i));
+            if (itr != mMapObjectGuids.end())
+                itr->second.gameobjects.Erase(cell_id, guid);
         }
     }
 }
@@ -2413,82 +2413,75 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
 // Get player map id of offline player. Return -1 if not found!
 int32 ObjectMgr::GetPlayerMapIdByGUID(ObjectGuid const& guid) const
 {
-    // prevent DB access for online player
+    // online player data is more recent than the last save
     if (Player* player = GetPlayer(guid))
         return int32(player->GetMapId());
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT map FROM characters WHERE guid = '%u'", guid.GetCounter());
-
-    if (result)
-    {
-        uint32 mapId = (*result)[0].GetUInt32();
-        delete result;
-        return int32(mapId);
-    }
+    CharacterDirectoryEntry entry;
+    if (GetCharacterDirectoryEntry(guid.GetCounter(), entry))
+        return int32(entry.map);
 
     return -1;
 }
 
-// name must be checked to correctness (if received) before call this function
-ObjectGuid ObjectMgr::GetPlayerGuidByName(std::string name) const
+namespace
 {
-    ObjectGuid guid;
+    // character names compare case insensitive in the database
+    std::string GetCharacterNameKey(std::string const& name)
+    {
+        std::wstring wname;
+        if (!Utf8toWStr(name, wname))
+            return name;
 
-    CharacterDatabase.escape_string(name);
+        wstrToLower(wname);
 
-    // Player name safe to sending to DB (checked at login) and this function using
-    QueryResult* result = CharacterDatabase.PQuery("SELECT guid FROM characters WHERE name = '%s'", name.c_str());
-    if (result)
-    {
-        guid = ObjectGuid(HIGHGUID_PLAYER, (*result)[0].GetUInt32());
+        std::string key;
+        if (!WStrToUtf8(wname, key))
+            return name;
 
-        delete result;
+        return key;
     }
+}
+
+// name must be checked to correctness (if received) before call this function
+ObjectGuid ObjectMgr::GetPlayerGuidByName(std::string name) const
+{
+    std::string const key = GetCharacterNameKey(name);
 
-    return guid;
+    std::shared_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterNameIndex::const_iterator itr = m_characterNameIndex.find(key);
+    if (itr == m_characterNameIndex.end())
+        return ObjectGuid();
+
+    return ObjectGuid(HIGHGUID_PLAYER, itr->second);
 }
 
 bool ObjectMgr::GetPlayerNameByGUID(ObjectGuid guid, std::string& name) const
 {
-    // prevent DB access for online player
     if (Player* player = GetPlayer(guid))
     {
         name = player->GetName();
         return true;
     }
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT name FROM characters WHERE guid = '%u'", lowguid);
-
-    if (result)
-    {
-        name = (*result)[0].GetCppString();
-        delete result;
-        return true;
-    }
+    CharacterDirectoryEntry entry;
+    if (!GetCharacterDirectoryEntry(guid.GetCounter(), entry))
+        return false;
 
-    return false;
+    name = entry.name;
+    return true;
 }
 
 Team ObjectMgr::GetPlayerTeamByGUID(ObjectGuid guid) const
 {
-    // prevent DB access for online player
     if (Player* player = GetPlayer(guid))
         return Player::TeamForRace(player->getRace());
 
-    uint32 lowguid = guid.GetCounter();
-
-    QueryResult* result = CharacterDatabase.PQuery("SELECT race FROM characters WHERE guid = '%u'", lowguid);
-
-    if (result)
-    {
-        uint8 race = (*result)[0].GetUInt8();
-        delete result;
-        return Player::TeamForRace(race);
-    }
+    CharacterDirectoryEntry entry;
+    if (!GetCharacterDirectoryEntry(guid.GetCounter(), entry))
+        return TEAM_NONE;
 
-    return TEAM_NONE;
+    return Player::TeamForRace(entry.race);
 }
 
 uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
@@ -2496,34 +2489,186 @@ uint32 ObjectMgr::GetPlayerAccountIdByGUID(ObjectGuid guid) const
     if (!guid.IsPlayer())
         return 0;
 
-    // prevent DB access for online player
     if (Player* player = GetPlayer(guid))
         return player->GetSession()->GetAccountId();
 
-    uint32 lowguid = guid.GetCounter();
+    CharacterDirectoryEntry entry;
+    if (!GetCharacterDirectoryEntry(guid.GetCounter(), entry))
+        return 0;
 
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE guid = '%u'", lowguid);
-    if (result)
+    return entry.account;
+}
+
+uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+{
+    ObjectGuid guid = GetPlayerGuidByName(name);
+    if (!guid)
+        return 0;
+
+    CharacterDirectoryEntry entry;
+    if (!GetCharacterDirectoryEntry(guid.GetCounter(), entry))
+        return 0;
+
+    return entry.account;
+}
+
+namespace
+{
+    //                                                 0     1     2        3     4      5       6      7
+    char const* const CharacterDirectoryQuery = "SELECT guid, name, account, race, class, gender, level, map FROM characters WHERE deleteDate IS NULL";
+
+    CharacterDirectoryEntry ReadCharacterDirectoryEntry(Field* fields)
     {
-        uint32 acc = (*result)[0].GetUInt32();
-        delete result;
-        return acc;
+        CharacterDirectoryEntry entry;
+        entry.name        = fields[1].GetCppString();
+        entry.account     = fields[2].GetUInt32();
+        entry.race        = fields[3].GetUInt8();
+        entry.playerClass = fields[4].GetUInt8();
+        entry.gender      = fields[5].GetUInt8();
+        entry.level       = fields[6].GetUInt8();
+        entry.map         = fields[7].GetUInt32();
+        return entry;
     }
+}
 
-    return 0;
+void ObjectMgr::LoadCharacterDirectory()
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+        m_characterDirectory.clear();
+        m_characterNameIndex.clear();
+    }
+
+    QueryResult* result = CharacterDatabase.Query(CharacterDirectoryQuery);
+    if (!result)
+    {
+        BarGoLink bar(1);
+        bar.step();
+        sLog.outString(">> Loaded 0 characters into the character directory");
+        sLog.outString();
+        return;
+    }
+
+    BarGoLink bar(result->GetRowCount());
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+        m_characterDirectory.reserve(result->GetRowCount());
+        m_characterNameIndex.reserve(result->GetRowCount());
+    }
+
+    do
+    {
+        bar.step();
+
+        Field* fields = result->Fetch();
+        SetCharacterDirectoryEntry(fields[0].GetUInt32(), ReadCharacterDirectoryEntry(fields));
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    sLog.outString(">> Loaded " SIZEFMTD " characters into the character directory", m_characterDirectory.size());
+    sLog.outString();
 }
 
-uint32 ObjectMgr::GetPlayerAccountIdByPlayerName(const std::string& name) const
+bool ObjectMgr::GetCharacterDirectoryEntry(uint32 lowguid, CharacterDirectoryEntry& entry) const
 {
-    QueryResult* result = CharacterDatabase.PQuery("SELECT account FROM characters WHERE name = '%s'", name.c_str());
-    if (result)
+    std::shared_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterDirectory::const_iterator itr = m_characterDirectory.find(lowguid);
+    if (itr == m_characterDirectory.end())
+        return false;
+
+    entry = itr->second;
+    return true;
+}
+
+void ObjectMgr::SetCharacterDirectoryEntry(uint32 lowguid, CharacterDirectoryEntry const& entry)
+{
+    std::string const key = GetCharacterNameKey(entry.name);
+
+    std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterDirectory::iterator itr = m_characterDirectory.find(lowguid);
+    if (itr != m_characterDirectory.end())
     {
-        uint32 acc = (*result)[0].GetUInt32();
-        delete result;
-        return acc;
+        if (itr->second.name != entry.name)
+            m_characterNameIndex.erase(GetCharacterNameKey(itr->second.name));
+        itr->second = entry;
     }
+    else
+        m_characterDirectory.emplace(lowguid, entry);
 
-    return 0;
+    m_characterNameIndex[key] = lowguid;
+}
+
+void ObjectMgr::UpdateCharacterDirectoryEntry(Player const* player)
+{
+    CharacterDirectoryEntry entry;
+    entry.name        = player->GetName();
+    entry.account     = player->GetSession()->GetAccountId();
+    entry.race        = player->getRace();
+    entry.playerClass = player->getClass();
+    entry.gender      = player->getGender();
+    entry.level       = uint8(player->GetLevel());
+    entry.map         = player->IsBeingTeleported() ? player->GetTeleportDest().mapid : player->GetMapId();
+
+    SetCharacterDirectoryEntry(player->GetGUIDLow(), entry);
+}
+
+void ObjectMgr::UpdateCharacterDirectoryName(uint32 lowguid, std::string const& name)
+{
+    CharacterDirectoryEntry entry;
+    if (!GetCharacterDirectoryEntry(lowguid, entry))
+        return;
+
+    entry.name = name;
+    SetCharacterDirectoryEntry(lowguid, entry);
+}
+
+void ObjectMgr::UpdateCharacterDirectoryLevel(uint32 lowguid, uint8 level)
+{
+    std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterDirectory::iterator itr = m_characterDirectory.find(lowguid);
+    if (itr != m_characterDirectory.end())
+        itr->second.level = level;
+}
+
+void ObjectMgr::UpdateCharacterDirectoryMap(uint32 lowguid, uint32 mapId)
+{
+    std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterDirectory::iterator itr = m_characterDirectory.find(lowguid);
+    if (itr != m_characterDirectory.end())
+        itr->second.map = mapId;
+}
+
+void ObjectMgr::RemoveCharacterDirectoryEntry(uint32 lowguid)
+{
+    std::unique_lock<std::shared_mutex> lock(m_characterDirectoryLock);
+    CharacterDirectory::iterator itr = m_characterDirectory.find(lowguid);
+    if (itr == m_characterDirectory.end())
+        return;
+
+    CharacterNameIndex::iterator nameItr = m_characterNameIndex.find(GetCharacterNameKey(itr->second.name));
+    if (nameItr != m_characterNameIndex.end() && nameItr->second == lowguid)
+        m_characterNameIndex.erase(nameItr);
+
+    m_characterDirectory.erase(itr);
+}
+
+void ObjectMgr::ReloadCharacterDirectoryEntry(uint32 lowguid)
+{
+    // queued behind the statements that changed the row
+    CharacterDatabase.AsyncPQuery(this, &ObjectMgr::ReloadCharacterDirectoryEntryCallback, "%s AND guid = '%u'", CharacterDirectoryQuery, lowguid);
+}
+
+void ObjectMgr::ReloadCharacterDirectoryEntryCallback(QueryResult* result)
+{
+    if (!result)
+        return;
+
+    Field* fields = result->Fetch();
+    SetCharacterDirectoryEntry(fields[0].GetUInt32(), ReadCharacterDirectoryEntry(fields));
+    delete result;
 }
 
 void ObjectMgr::LoadItemLocales()
@@ -7990,16 +8135,37 @@ void ObjectMgr::DeleteGOData(uint32 guid)
 
 void ObjectMgr::AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance)
 {
-    // corpses are always added to spawn mode 0 and they are spawned by their instance id
-    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)][cellid];
-    cell_guids.corpses[player_guid] = instance;
+    // corpses are spawned by their instance id
+    mMapCorpseGuids[mapid][cellid][player_guid] = instance;
 }
 
 void ObjectMgr::DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid)
 {
-    // corpses are always added to spawn mode 0 and they are spawned by their instance id
-    CellObjectGuids& cell_guids = mMapObjectGuids[MAKE_PAIR32(mapid, 0)][cellid];
-    cell_guids.corpses.erase(player_guid);
+    MapCorpseGuids::iterator mapItr = mMapCorpseGuids.find(mapid);
+    if (mapItr == mMapCorpseGuids.end())
+        return;
+
+    CellCorpsesMap::iterator cellItr = mapItr->second.find(cellid);
+    if (cellItr == mapItr->second.end())
+        return;
+
+    cellItr->second.erase(player_guid);
+    if (cellItr->second.empty())
+        mapItr->second.erase(cellItr);
+}
+
+void ObjectMgr::PackMapObjectGuids()
+{
+    size_t count = 0;
+    for (auto& mapGuids : mMapObjectGuids)
+    {
+        mapGuids.second.creatures.Pack();
+        mapGuids.second.gameobjects.Pack();
+        count += mapGuids.second.creatures.GetPackedSize() + mapGuids.second.gameobjects.GetPackedSize();
+    }
+
+    sLog.outString(">> Packed " SIZEFMTD " static spawn grid guids for " SIZEFMTD " map spawn modes", count, mMapObjectGuids.size());
+    sLog.outString();
 }
 
 void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table)
@@ -38,6 +38,7 @@
 
 #include <map>
 #include <climits>
+#include <shared_mutex>
 
 class Group;
 class ArenaTeam;
@@ -128,15 +129,22 @@ struct BroadcastText
 
 typedef std::map<uint32, BroadcastText> BroadcastTextMap;
 
-typedef std::map < uint32/*player guid*/, uint32/*instance*/ > CellCorpseSet;
-struct CellObjectGuids
+// Character data offline lookups need, kept in memory so they never query the database
+struct CharacterDirectoryEntry
 {
-    CellGuidSet creatures;
-    CellGuidSet gameobjects;
-    CellCorpseSet corpses;
+    std::string name;
+    uint32 account;
+    uint32 map;
+    uint8 race;
+    uint8 playerClass;
+    uint8 gender;
+    uint8 level;
 };
-typedef std::unordered_map<uint32/*cell_id*/, CellObjectGuids> CellObjectGuidsMap;
-typedef std::unordered_map<uint32/*(mapid,spawnMode) pair*/, CellObjectGuidsMap> MapObjectGuids;
+
+typedef std::map < uint32/*player guid*/, uint32/*instance*/ > CellCorpseSet;
+typedef std::unordered_map<uint32/*cell_id*/, CellCorpseSet> CellCorpsesMap;
+typedef std::unordered_map<uint32/*(mapid,spawnMode) pair*/, MapCellObjectGuids> MapObjectGuids;
+typedef std::unordered_map<uint32/*mapid*/, CellCorpsesMap> MapCorpseGuids;
 
 // mangos string ranges
 #define MIN_MANGOS_STRING_ID           1                    // 'mangos_string'
@@ -516,6 +524,15 @@ class ObjectMgr
         uint32 GetPlayerAccountIdByGUID(ObjectGuid guid) const;
         uint32 GetPlayerAccountIdByPlayerName(const std::string& name) const;
 
+        void LoadCharacterDirectory();
+        bool GetCharacterDirectoryEntry(uint32 lowguid, CharacterDirectoryEntry& entry) const;
+        void UpdateCharacterDirectoryEntry(Player const* player);
+        void UpdateCharacterDirectoryName(uint32 lowguid, std::string const& name);
+        void UpdateCharacterDirectoryLevel(uint32 lowguid, uint8 level);
+        void UpdateCharacterDirectoryMap(uint32 lowguid, uint32 mapId);
+        void RemoveCharacterDirectoryEntry(uint32 lowguid);
+        void ReloadCharacterDirectoryEntry(uint32 lowguid); // async, after characters rows changed outside of the player code
+
         bool AddTaxiShortcut(const TaxiPathEntry* path, uint32 lengthTakeoff, uint32 lengthLanding);
         bool GetTaxiShortcut(uint32 pathid, TaxiShortcutData& data);
         void LoadTaxiShortcuts();
@@ -996,9 +1013,20 @@ class ObjectMgr
         int GetOrNewStorageLocaleIndexFor(LocaleConstant loc);
 
         // global grid objects state (static DB spawns, global spawn mods from gameevent system)
-        CellObjectGuids const& GetCellObjectGuids(uint16 mapid, uint8 spawnMode, uint32 cell_id)
+        MapCellObjectGuids const* GetMapObjectGuids(uint16 mapid, uint8 spawnMode) const
         {
-            return mMapObjectGuids[MAKE_PAIR32(mapid, spawnMode)][cell_id];
+            MapObjectGuids::const_iterator itr = mMapObjectGuids.find(MAKE_PAIR32(mapid, spawnMode));
+            return itr != mMapObjectGuids.end() ? &itr->second : nullptr;
+        }
+
+        CellCorpseSet const* GetCellCorpses(uint32 mapid, uint32 cell_id) const
+        {
+            MapCorpseGuids::const_iterator mapItr = mMapCorpseGuids.find(mapid);
+            if (mapItr == mMapCorpseGuids.end())
+                return nullptr;
+
+            CellCorpsesMap::const_iterator cellItr = mapItr->second.find(cell_id);
+            return cellItr != mapItr->second.end() ? &cellItr->second : nullptr;
         }
 
         // modifiers for global grid objects state (static DB spawns, global spawn mods from gameevent system)
@@ -1009,6 +1037,7 @@ class ObjectMgr
         void RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data);
         void AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance);
         void DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid);
+        void PackMapObjectGuids();                          // after loading static spawns, later changes go to the side lists
 
         // reserved names
         void LoadReservedPlayersNames();
@@ -1276,6 +1305,8 @@ class ObjectMgr
 
     private:
         void LoadCreatureAddons(SQLStorage& creatureaddons, char const* entryName, char const* comment);
+        void SetCharacterDirectoryEntry(uint32 lowguid, CharacterDirectoryEntry const& entry);
+        void ReloadCharacterDirectoryEntryCallback(QueryResult* result);
         void ConvertCreatureAddonAuras(CreatureDataAddon* addon, char const* table, char const* guidEntryStr);
         void LoadQuestRelationsHelper(QuestRelationsMap& map, char const* table);
         void LoadVendors(char const* tableName, bool isTemplates);
@@ -1286,6 +1317,12 @@ class ObjectMgr
 
         MailLevelRewardMap m_mailLevelRewardMap;
 
+        typedef std::unordered_map<uint32 /*lowguid*/, CharacterDirectoryEntry> CharacterDirectory;
+        typedef std::unordered_map<std::string /*lower case name*/, uint32 /*lowguid*/> CharacterNameIndex;
+        CharacterDirectory m_characterDirectory;
+        CharacterNameIndex m_characterNameIndex;
+        mutable std::shared_mutex m_characterDirectoryLock; // read from map threads, written from map and world threads
+
         typedef std::map<uint32, PetLevelInfo*> PetLevelInfoMap;
         // PetLevelInfoMap[creature_id][level]
         PetLevelInfoMap petInfo;                            // [creature_id][level]
@@ -1314,6 +1351,7 @@ class ObjectMgr
         CreatureClassLvlStats m_creatureClassLvlStats[DEFAULT_MAX_CREATURE_LEVEL + 1][MAX_CREATURE_CLASS][MAX_EXPANSION + 1];
 
         MapObjectGuids mMapObjectGuids;
+        MapCorpseGuids mMapCorpseGuids;
         ActiveObjectGuidsOnMap m_activeCreatures;
         ActiveObjectGuidsOnMap m_activeGameObjects;
         CreatureSpawnTemplateMap m_creatureSpawnTemplateMap;
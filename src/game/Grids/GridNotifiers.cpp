@@ -38,56 +38,63 @@ void VisibleChangesNotifier::Visit(CameraMapType& m)
     }
 }
 
+void CameraCollector::Visit(CameraMapType& m)
+{
+    for (auto& iter : m)
+        i_cameras.push_back(iter.getSource());
+}
+
 void VisibleNotifier::Notify()
 {
     Player& player = *i_camera.GetOwner();
-    // at this moment i_clientGUIDs have guids that not iterate at grid level checks
+    // at this moment unseen client guids are those that not iterate at grid level checks
     // but exist one case when this possible and object not out of range: transports
     if (GenericTransport* transport = player.GetTransport())
     {
         for (auto itr : transport->GetPassengers())
         {
-            if (i_clientGUIDs.find(itr->GetObjectGuid()) != i_clientGUIDs.end())
+            if (i_clientGUIDs.IsUnseen(itr->GetObjectGuid(), i_pass))
             {
+                i_clientGUIDs.MarkSeen(itr->GetObjectGuid());
                 // ignore far sight case
                 if (itr->IsPlayer())
                     static_cast<Player*>(itr)->UpdateVisibilityOf(static_cast<Player*>(itr), &player);
                 player.UpdateVisibilityOf(&player, itr, i_data, i_visibleNow);
-                i_clientGUIDs.erase(itr->GetObjectGuid());
             }
         }
     }
 
-    // Far objects update on player notify
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end();)
+    // Far objects update on player notify, collected first since the update changes the client guids
+    std::vector<WorldObject*> farObjects;
+    i_clientGUIDs.ForEachUnseen(i_pass, [&](ObjectGuid guid)
     {
-        GuidSet::iterator current = itr++;
-        if (WorldObject* obj = player.GetMap()->GetWorldObject(*current))
-        {
-            if (!obj->GetVisibilityData().IsVisibilityOverridden())
-                continue;
-
-            player.UpdateVisibilityOf(&player, obj);
-            i_clientGUIDs.erase(current);
-        }
+        if (WorldObject* obj = player.GetMap()->GetWorldObject(guid))
+            if (obj->GetVisibilityData().IsVisibilityOverridden())
+                farObjects.push_back(obj);
+    });
+    for (WorldObject* obj : farObjects)
+    {
+        i_clientGUIDs.MarkSeen(obj->GetObjectGuid());
+        player.UpdateVisibilityOf(&player, obj);
     }
 
     // generate outOfRange for not iterate objects
-    i_data.AddOutOfRangeGUID(i_clientGUIDs);
-    for (GuidSet::iterator itr = i_clientGUIDs.begin(); itr != i_clientGUIDs.end(); ++itr)
+    GuidVector outOfRange;
+    i_clientGUIDs.EraseUnseen(i_pass, outOfRange);
+    for (ObjectGuid const& guid : outOfRange)
     {
-        if (WorldObject* target = player.GetMap()->GetWorldObject(*itr))
+        i_data.AddOutOfRangeGUID(guid);
+        if (WorldObject* target = player.GetMap()->GetWorldObject(guid))
         {
             if (target->GetTypeId() == TYPEID_UNIT)
                 player.BeforeVisibilityDestroy(static_cast<Creature*>(target));
-            player.RemoveAtClient(target);
+            target->RemoveClientIAmAt(&player);
         }
         else
-            sLog.outCustomLog("Object was %s in current map.", player.GetMap()->m_objRemoveList.find(*itr) == player.GetMap()->m_objRemoveList.end() ? "not found" : "found");
-        
+            sLog.outCustomLog("Object was %s in current map.", player.GetMap()->m_objRemoveList.find(guid) == player.GetMap()->m_objRemoveList.end() ? "not found" : "found");
 
         DEBUG_FILTER_LOG(LOG_FILTER_VISIBILITY_CHANGES, "%s is out of range (no in active cells set) now for %s",
-                         itr->GetString().c_str(), player.GetGuidStr().c_str());
+                         guid.GetString().c_str(), player.GetGuidStr().c_str());
     }
 
     if (i_data.HasData())
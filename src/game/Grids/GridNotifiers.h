@@ -27,9 +27,11 @@
 #include "Entities/GameObject.h"
 #include "Entities/Player.h"
 #include "Entities/Unit.h"
+#include "GameSystem/GridPackedFilter.h"
 
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 namespace MaNGOS
 {
@@ -37,10 +39,11 @@ namespace MaNGOS
     {
         Camera& i_camera;
         UpdateData i_data;
-        GuidSet i_clientGUIDs;
+        ClientGuidSet& i_clientGUIDs;
+        uint32 i_pass;                                      // visited client guids are marked with it
         WorldObjectSet i_visibleNow;
 
-        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()) {}
+        explicit VisibleNotifier(Camera& c) : i_camera(c), i_clientGUIDs(c.GetOwner()->GetClientGuids()), i_pass(i_clientGUIDs.BeginPass()) {}
         template<class T> void Visit(GridRefManager<T>& m);
         void Visit(CameraMapType& /*m*/) {}
         void Notify(void);
@@ -59,6 +62,16 @@ namespace MaNGOS
         GuidSet m_unvisitedGuids;
     };
 
+    // gathers cameras once so several objects near each other can be checked against them
+    struct CameraCollector
+    {
+        std::vector<Camera*>& i_cameras;
+
+        explicit CameraCollector(std::vector<Camera*>& cameras) : i_cameras(cameras) {}
+        template<class T> void Visit(GridRefManager<T>&) {}
+        void Visit(CameraMapType& m);
+    };
+
     struct MessageDeliverer
     {
         Player const& i_player;
@@ -198,6 +211,29 @@ namespace MaNGOS
     };
     */
 
+    // Checks providing GetPackedFilter() have their grid lists prefiltered by 2d distance over the packed positions
+    template<class Check, class = void>
+    struct HasPackedFilter : std::false_type {};
+
+    template<class Check>
+    struct HasPackedFilter<Check, std::void_t<decltype(std::declval<Check const&>().GetPackedFilter())>> : std::true_type {};
+
+    // calls f for every object of 'm' that may pass 'check', objects come in packed order when prefiltered
+    template<class Check, class T, class F>
+    inline void VisitCandidates(Check const& check, GridRefManager<T>& m, F&& f)
+    {
+        if constexpr (HasPackedFilter<Check>::value && GridPackedTraits<T>::enabled)
+        {
+            GridPackedStore<T> const& packed = m.getPacked();
+            check.GetPackedFilter().ForEach(packed, [&](uint32 index) { f(packed.object(index)); });
+        }
+        else
+        {
+            for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                f(itr->getSource());
+        }
+    }
+
     // WorldObject searchers & workers
 
     template<class Check>
@@ -949,6 +985,7 @@ namespace MaNGOS
                 i_controlledByPlayer = obj->IsControlledByPlayer();
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Unit* u) const
             {
                 // ignore totems
@@ -969,6 +1006,7 @@ namespace MaNGOS
             AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, SpellEntry const* spellInfo, float range, bool ignorePhase = false)
                 : i_obj(obj), i_spellInfo(spellInfo), i_range(range), i_ignorePhase(ignorePhase) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range, true, i_ignorePhase) && i_obj->CanAssistSpell(u, i_spellInfo);
@@ -986,6 +1024,7 @@ namespace MaNGOS
             AnyFriendlyOrGroupMemberUnitInUnitRangeCheck(Unit const* obj, Unit const* target, Group const* group, SpellEntry const* spellInfo, float range)
                 : i_group(group), i_obj(obj), i_target(target), i_spellInfo(spellInfo), i_range(range) {}
             Unit const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_target->GetPositionX(), i_target->GetPositionY(), i_range + i_target->GetCombatReach()); }
             bool operator()(Unit* u)
             {
                 if (!u->IsAlive() || !i_target->IsWithinDistInMap(u, i_range) || !i_obj->CanAssistSpell(u, i_spellInfo))
@@ -1047,6 +1086,7 @@ namespace MaNGOS
         public:
             AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range);
@@ -1081,6 +1121,7 @@ namespace MaNGOS
             NearestAttackableUnitInObjectRangeCheck(NearestAttackableUnitInObjectRangeCheck const&) =  delete;
 
             Unit const& GetFocusObject() const { return *m_source; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(m_source->GetPositionX(), m_source->GetPositionY(), m_range + m_source->GetCombatReach()); }
 
             bool operator()(Unit* currUnit)
             {
@@ -1111,6 +1152,7 @@ namespace MaNGOS
                 i_targetForPlayer = i_obj->IsControlledByPlayer();
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
@@ -1330,6 +1372,7 @@ namespace MaNGOS
         public:
             AnyPlayerInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Player* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range);
@@ -1345,6 +1388,7 @@ namespace MaNGOS
             AnyPlayerInObjectRangeWithAuraCheck(WorldObject const* obj, float range, uint32 spellId)
                 : i_obj(obj), i_range(range), i_spellId(spellId) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Player* u)
             {
                 return u->IsAlive()
@@ -1363,6 +1407,7 @@ namespace MaNGOS
             AnyPlayerInCapturePointRange(WorldObject const* obj, float range)
                 : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            GridPackedFilter GetPackedFilter() const { return GridPackedFilter(i_obj->GetPositionX(), i_obj->GetPositionY(), i_range + i_obj->GetCombatReach()); }
             bool operator()(Player* u)
             {
                 return u->CanUseCapturePoint() &&
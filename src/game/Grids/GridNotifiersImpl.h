@@ -36,7 +36,7 @@ inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T>& m)
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         i_camera.UpdateVisibilityOf(iter->getSource(), i_data, i_visibleNow);
-        i_clientGUIDs.erase(iter->getSource()->GetObjectGuid());
+        i_clientGUIDs.MarkSeen(iter->getSource()->GetObjectGuid());
     }
 }
 
@@ -525,37 +525,41 @@ void MaNGOS::UnitSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitCandidates(i_check, m, [&](auto* object)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(object))
+            i_object = object;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitLastSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitCandidates(i_check, m, [&](auto* object)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(object))
+            i_object = object;
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitCandidates(i_check, m, [&](auto* object)
+    {
+        if (i_check(object))
+            i_objects.push_back(object);
+    });
 }
 
 template<class Check>
 void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitCandidates(i_check, m, [&](auto* object)
+    {
+        if (i_check(object))
+            i_objects.push_back(object);
+    });
 }
 
 // Creature searchers
@@ -580,19 +584,21 @@ void MaNGOS::CreatureSearcher<Check>::Visit(CreatureMapType& m)
 template<class Check>
 void MaNGOS::CreatureLastSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+    VisitCandidates(i_check, m, [&](auto* object)
     {
-        if (i_check(itr->getSource()))
-            i_object = itr->getSource();
-    }
+        if (i_check(object))
+            i_object = object;
+    });
 }
 
 template<class Check>
 void MaNGOS::CreatureListSearcher<Check>::Visit(CreatureMapType& m)
 {
-    for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitCandidates(i_check, m, [&](auto* object)
+    {
+        if (i_check(object))
+            i_objects.push_back(object);
+    });
 }
 
 template<class Check>
@@ -615,9 +621,11 @@ void MaNGOS::PlayerSearcher<Check>::Visit(PlayerMapType& m)
 template<class Check>
 void MaNGOS::PlayerListSearcher<Check>::Visit(PlayerMapType& m)
 {
-    for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
-        if (i_check(itr->getSource()))
-            i_objects.push_back(itr->getSource());
+    VisitCandidates(i_check, m, [&](auto* object)
+    {
+        if (i_check(object))
+            i_objects.push_back(object);
+    });
 }
 
 template<class Builder>
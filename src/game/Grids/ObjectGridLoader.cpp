@@ -112,11 +112,14 @@ template<> void addUnitState(Creature* obj, CellPair const& cell_pair)
 }
 
 template <class T>
-void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
+void LoadHelper(CellGuidIndex::GuidList const& guids, CellPair& cell, GridRefManager<T>& /*m*/, uint32& count, Map* map, GridType& grid)
 {
+    if (guids.empty())
+        return;
+
     BattleGround* bg = map->IsBattleGroundOrArena() ? ((BattleGroundMap*)map)->GetBG() : nullptr;
 
-    for (uint32 guid : guid_set)
+    for (uint32 guid : guids)
     {
         T* obj;
         if (std::is_same<T, GameObject>::value) // TODO: When c++17 is added change to constexpr
@@ -155,12 +158,12 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair& cell, GridRefManager<T>&
     }
 }
 
-void LoadHelper(CellCorpseSet const& cell_corpses, CellPair& cell, CorpseMapType& /*m*/, uint32& count, Map* map, GridType& grid)
+void LoadHelper(CellCorpseSet const* cell_corpses, CellPair& cell, CorpseMapType& /*m*/, uint32& count, Map* map, GridType& grid)
 {
-    if (cell_corpses.empty())
+    if (!cell_corpses)
         return;
 
-    for (const auto& cell_corpse : cell_corpses)
+    for (const auto& cell_corpse : *cell_corpses)
     {
         if (cell_corpse.second != map->GetInstanceId())
             continue;
@@ -191,11 +194,14 @@ ObjectGridLoader::Visit(GameObjectMapType& m)
     CellPair cell_pair(x, y);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
+    // static spawns first, then the map copy specific ones, guids are copied as loading may change the indexes
+    CellGuidIndex::GuidList guids;
+    if (MapCellObjectGuids const* map_guids = sObjectMgr.GetMapObjectGuids(i_map->GetId(), i_map->GetSpawnMode()))
+        map_guids->gameobjects.GetGuids(cell_id, guids);
+    i_map->GetPersistentState()->GetGridObjectGuids().gameobjects.GetGuids(cell_id, guids);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).gameobjects, cell_pair, m, i_gameObjects, i_map, grid);
+    LoadHelper(guids, cell_pair, m, i_gameObjects, i_map, grid);
 }
 
 void
@@ -206,11 +212,14 @@ ObjectGridLoader::Visit(CreatureMapType& m)
     CellPair cell_pair(x, y);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), i_map->GetSpawnMode(), cell_id);
+    // static spawns first, then the map copy specific ones, guids are copied as loading may change the indexes
+    CellGuidIndex::GuidList guids;
+    if (MapCellObjectGuids const* map_guids = sObjectMgr.GetMapObjectGuids(i_map->GetId(), i_map->GetSpawnMode()))
+        map_guids->creatures.GetGuids(cell_id, guids);
+    i_map->GetPersistentState()->GetGridObjectGuids().creatures.GetGuids(cell_id, guids);
 
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.creatures, cell_pair, m, i_creatures, i_map, grid);
-    LoadHelper(i_map->GetPersistentState()->GetCellObjectGuids(cell_id).creatures, cell_pair, m, i_creatures, i_map, grid);
+    LoadHelper(guids, cell_pair, m, i_creatures, i_map, grid);
 }
 
 void
@@ -221,10 +230,9 @@ ObjectWorldLoader::Visit(CorpseMapType& m)
     CellPair cell_pair(x, y);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    // corpses are always added to spawn mode 0 and they are spawned by their instance id
-    CellObjectGuids const& cell_guids = sObjectMgr.GetCellObjectGuids(i_map->GetId(), 0, cell_id);
+    // corpses are spawned by their instance id
     GridType& grid = (*i_map->getNGrid(i_cell.GridX(), i_cell.GridY()))(i_cell.CellX(), i_cell.CellY());
-    LoadHelper(cell_guids.corpses, cell_pair, m, i_corpses, i_map, grid);
+    LoadHelper(sObjectMgr.GetCellCorpses(i_map->GetId(), cell_id), cell_pair, m, i_corpses, i_map, grid);
 }
 
 void
@@ -881,6 +881,7 @@ bool Group::_addMember(ObjectGuid guid, const char* name, bool isAssistant, uint
     if (!IsBattleGroup())
     {
         // insert into group table
+        CharacterDatabase.DiscardDelayedUpdate("group_member", "memberGuid = " + std::to_string(member.guid.GetCounter()));
         CharacterDatabase.PExecute("INSERT INTO group_member(groupId,memberGuid,assistant,subgroup) VALUES('%u','%u','%u','%u')",
                                    m_Id, member.guid.GetCounter(), ((member.assistant == 1) ? 1 : 0), member.group);
     }
@@ -1105,7 +1106,7 @@ bool Group::_setMembersGroup(ObjectGuid guid, uint8 group)
     SubGroupCounterIncrease(group);
 
     if (!IsBattleGroup())
-        CharacterDatabase.PExecute("UPDATE group_member SET subgroup='%u' WHERE memberGuid='%u'", group, guid.GetCounter());
+        CharacterDatabase.DelayedUpdate("group_member", "memberGuid = " + std::to_string(guid.GetCounter()), "subgroup", std::to_string(group));
 
     return true;
 }
@@ -1118,7 +1119,7 @@ bool Group::_setAssistantFlag(ObjectGuid guid, const bool& state)
 
     slot->assistant = state;
     if (!IsBattleGroup())
-        CharacterDatabase.PExecute("UPDATE group_member SET assistant='%u' WHERE memberGuid='%u'", (state) ? 1 : 0, guid.GetCounter());
+        CharacterDatabase.DelayedUpdate("group_member", "memberGuid = " + std::to_string(guid.GetCounter()), "assistant", state ? "1" : "0");
     return true;
 }
 
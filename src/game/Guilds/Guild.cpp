@@ -31,6 +31,12 @@
 #include "World/World.h"
 #include "Anticheat/Anticheat.hpp"
 
+// bank withdraw limits and bank money change with every bank use, they are written as delayed updates
+static std::string GuildMemberRowKey(uint32 guildId, uint32 lowguid)
+{
+    return "guildid = " + std::to_string(guildId) + " AND guid = " + std::to_string(lowguid);
+}
+
 //// MemberSlot ////////////////////////////////////////////
 void MemberSlot::SetMemberStats(Player* player)
 {
@@ -97,6 +103,8 @@ Guild::Guild()
 
     m_GuildBankMoney = 0;
 
+    m_dataState = GUILD_DATA_NOT_LOADED;
+
     m_GuildEventLogNextGuid = 0;
     m_GuildBankEventLogNextGuid_Money = 0;
     for (unsigned int& i : m_GuildBankEventLogNextGuid_Item)
@@ -130,6 +138,7 @@ bool Guild::Create(Player* leader, std::string gname)
     MOTD = "No message set.";
     m_GuildBankMoney = 0;
     m_Id = sObjectMgr.GenerateGuildId();
+    m_dataState = GUILD_DATA_LOADED;                        // new guild has no logs or bank content
 
     // creating data
     time_t now = time(nullptr);
@@ -247,6 +256,7 @@ bool Guild::AddMember(ObjectGuid plGuid, uint32 plRank)
     CharacterDatabase.escape_string(dbPnote);
     CharacterDatabase.escape_string(dbOFFnote);
 
+    CharacterDatabase.DiscardDelayedUpdate("guild_member", GuildMemberRowKey(m_Id, lowguid));
     CharacterDatabase.PExecute("INSERT INTO guild_member (guildid,guid,`rank`,pnote,offnote) VALUES ('%u', '%u', '%u','%s','%s')",
                                m_Id, lowguid, newmember.RankId, dbPnote.c_str(), dbOFFnote.c_str());
 
@@ -754,6 +764,8 @@ void Guild::Disband()
 
     // Free bank tab used memory and delete items stored in them
     DeleteGuildBankItems(true);
+    if (!IsDataLoaded())
+        CharacterDatabase.PExecute("DELETE FROM item_instance WHERE guid IN (SELECT item_guid FROM guild_bank_item WHERE guildid = '%u')", m_Id);
 
     CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE guildid = '%u'", m_Id);
     CharacterDatabase.PExecute("DELETE FROM guild_bank_right WHERE guildid = '%u'", m_Id);
@@ -904,11 +916,139 @@ void Guild::DisplayGuildEventLog(WorldSession* session)
     DEBUG_LOG("WORLD: Sent (MSG_GUILD_EVENT_LOG_QUERY)");
 }
 
+// *************************************************
+// Event log, bank content and bank logs load
+
+//                                           0        1          2            3            4        5
+#define GUILD_EVENTLOG_QUERY    "SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u"
+//                                           0      1        2        3
+#define GUILD_BANK_TAB_QUERY    "SELECT TabId, TabName, TabIcon, TabText FROM guild_bank_tab WHERE guildid='%u' ORDER BY TabId"
+// data needs to be at first place for Item::LoadFromDB
+//                                           0          1            2                3      4         5        6      7             8                 9           10          11     12      13         14
+#define GUILD_BANK_ITEM_QUERY   "SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, itemTextId, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId"
+//                                           0        1          2           3            4               5          6
+#define GUILD_BANK_LOG_QUERY    "SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' AND TabId='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u"
+
+enum GuildDataQueryIndex
+{
+    GUILD_DATA_QUERY_EVENTLOG           = 0,
+    GUILD_DATA_QUERY_BANK_TABS          = 1,
+    GUILD_DATA_QUERY_BANK_ITEMS         = 2,
+    GUILD_DATA_QUERY_BANK_MONEY_LOG     = 3,
+    GUILD_DATA_QUERY_BANK_TAB_LOG       = 4,                // one per purchased tab
+    MAX_GUILD_DATA_QUERY                = GUILD_DATA_QUERY_BANK_TAB_LOG + GUILD_BANK_MAX_TABS
+};
+
+class GuildDataQueryHolder : public SqlQueryHolder
+{
+    public:
+        explicit GuildDataQueryHolder(uint32 guildId) : m_guildId(guildId) {}
+        uint32 GetGuildId() const { return m_guildId; }
+        bool Initialize(uint8 purchasedTabs);
+
+    private:
+        uint32 m_guildId;
+};
+
+bool GuildDataQueryHolder::Initialize(uint8 purchasedTabs)
+{
+    SetSize(MAX_GUILD_DATA_QUERY);
+
+    bool res = true;
+    res &= SetPQuery(GUILD_DATA_QUERY_EVENTLOG, GUILD_EVENTLOG_QUERY, m_guildId, GUILD_EVENTLOG_MAX_RECORDS);
+    res &= SetPQuery(GUILD_DATA_QUERY_BANK_TABS, GUILD_BANK_TAB_QUERY, m_guildId);
+    res &= SetPQuery(GUILD_DATA_QUERY_BANK_ITEMS, GUILD_BANK_ITEM_QUERY, m_guildId);
+    res &= SetPQuery(GUILD_DATA_QUERY_BANK_MONEY_LOG, GUILD_BANK_LOG_QUERY, m_guildId, uint32(GUILD_BANK_MONEY_LOGS_TAB), uint32(GUILD_BANK_MAX_LOGS));
+    for (uint32 tabId = 0; tabId < purchasedTabs; ++tabId)
+        res &= SetPQuery(GUILD_DATA_QUERY_BANK_TAB_LOG + tabId, GUILD_BANK_LOG_QUERY, m_guildId, tabId, uint32(GUILD_BANK_MAX_LOGS));
+
+    return res;
+}
+
+class GuildDataLoader
+{
+    public:
+        void HandleLoadCallback(QueryResult* /*dummy*/, SqlQueryHolder* holder)
+        {
+            if (!holder)
+                return;
+
+            // guild may be disbanded meanwhile
+            if (Guild* guild = sGuildMgr.GetGuildById(((GuildDataQueryHolder*)holder)->GetGuildId()))
+                guild->LoadDataFromHolder(holder);
+
+            delete holder;
+        }
+} guildDataLoader;
+
+void Guild::LoadDataAsync()
+{
+    if (m_dataState != GUILD_DATA_NOT_LOADED)
+        return;
+
+    GuildDataQueryHolder* holder = new GuildDataQueryHolder(m_Id);
+    if (!holder->Initialize(GetPurchasedTabs()))
+    {
+        delete holder;
+        LoadDataDirect();
+        return;
+    }
+
+    m_dataState = GUILD_DATA_LOADING;
+    if (!CharacterDatabase.DelayQueryHolder(&guildDataLoader, &GuildDataLoader::HandleLoadCallback, (SqlQueryHolder*)holder))
+    {
+        delete holder;
+        m_dataState = GUILD_DATA_NOT_LOADED;
+        LoadDataDirect();
+    }
+}
+
+void Guild::LoadDataDirect()
+{
+    if (m_dataState == GUILD_DATA_LOADED)
+        return;
+
+    // a pending async load is ignored when it arrives
+    m_dataState = GUILD_DATA_LOADED;
+
+    QueryResult* tabLogResults[GUILD_BANK_MAX_TABS] = {};
+    for (uint32 tabId = 0; tabId < uint32(GetPurchasedTabs()); ++tabId)
+        tabLogResults[tabId] = CharacterDatabase.PQuery(GUILD_BANK_LOG_QUERY, m_Id, tabId, uint32(GUILD_BANK_MAX_LOGS));
+
+    LoadGuildEventLogFromDB(CharacterDatabase.PQuery(GUILD_EVENTLOG_QUERY, m_Id, GUILD_EVENTLOG_MAX_RECORDS));
+    LoadGuildBankEventLogFromDB(CharacterDatabase.PQuery(GUILD_BANK_LOG_QUERY, m_Id, uint32(GUILD_BANK_MONEY_LOGS_TAB), uint32(GUILD_BANK_MAX_LOGS)), tabLogResults);
+    LoadGuildBankFromDB(CharacterDatabase.PQuery(GUILD_BANK_TAB_QUERY, m_Id), CharacterDatabase.PQuery(GUILD_BANK_ITEM_QUERY, m_Id));
+
+    AddPendingLogEntries();
+}
+
+void Guild::LoadDataFromHolder(SqlQueryHolder* holder)
+{
+    if (m_dataState == GUILD_DATA_LOADED)
+        return;
+
+    m_dataState = GUILD_DATA_LOADED;
+
+    QueryResult* tabLogResults[GUILD_BANK_MAX_TABS] = {};
+    for (uint32 tabId = 0; tabId < uint32(GetPurchasedTabs()); ++tabId)
+        tabLogResults[tabId] = holder->GetResult(GUILD_DATA_QUERY_BANK_TAB_LOG + tabId);
+
+    // bank logs before the bank, the bank load may drop the tabs
+    LoadGuildEventLogFromDB(holder->GetResult(GUILD_DATA_QUERY_EVENTLOG));
+    LoadGuildBankEventLogFromDB(holder->GetResult(GUILD_DATA_QUERY_BANK_MONEY_LOG), tabLogResults);
+    LoadGuildBankFromDB(holder->GetResult(GUILD_DATA_QUERY_BANK_TABS), holder->GetResult(GUILD_DATA_QUERY_BANK_ITEMS));
+
+    AddPendingLogEntries();
+
+    // members logged in while loading got no tab info
+    for (MemberList::const_iterator itr = members.cbegin(); itr != members.cend(); ++itr)
+        if (Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first)))
+            DisplayGuildBankTabsInfo(player->GetSession());
+}
+
 // Load guild eventlog from DB
-void Guild::LoadGuildEventLogFromDB()
+void Guild::LoadGuildEventLogFromDB(QueryResult* result)
 {
-    //                                                     0        1          2            3            4        5
-    QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid1, PlayerGuid2, NewRank, TimeStamp FROM guild_eventlog WHERE guildid=%u ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, GUILD_EVENTLOG_MAX_RECORDS);
     if (!result)
         return;
     bool isNextLogGuidSet = false;
@@ -951,6 +1091,20 @@ void Guild::LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid pl
     NewEvent.PlayerGuid2 = playerGuid2.GetCounter();
     NewEvent.NewRank = newRank;
     NewEvent.TimeStamp = uint32(time(nullptr));
+
+    // the next LogGuid is only known once the log is loaded
+    if (!IsDataLoaded())
+    {
+        m_pendingEventLog.push_back(NewEvent);
+        LoadDataAsync();
+        return;
+    }
+
+    AddGuildEventLogEntry(NewEvent);
+}
+
+void Guild::AddGuildEventLogEntry(GuildEventLogEntry const& NewEvent)
+{
     // Count new LogGuid
     m_GuildEventLogNextGuid = (m_GuildEventLogNextGuid + 1) % sWorld.getConfig(CONFIG_UINT32_GUILD_EVENT_LOG_COUNT);
     // Check max records limit
@@ -1160,12 +1314,12 @@ uint32 Guild::GetBankRights(uint32 rankId, uint8 TabId) const
 // Guild bank loading related
 
 // This load should be called on startup only
-void Guild::LoadGuildBankFromDB()
+void Guild::LoadGuildBankFromDB(QueryResult* tabResult, QueryResult* itemResult)
 {
-    //                                                     0      1        2        3
-    QueryResult* result = CharacterDatabase.PQuery("SELECT TabId, TabName, TabIcon, TabText FROM guild_bank_tab WHERE guildid='%u' ORDER BY TabId", m_Id);
+    QueryResult* result = tabResult;
     if (!result)
     {
+        delete itemResult;
         m_TabListMap.clear();
         return;
     }
@@ -1192,9 +1346,7 @@ void Guild::LoadGuildBankFromDB()
 
     delete result;
 
-    // data needs to be at first place for Item::LoadFromDB
-    //                                        0          1            2                3      4         5        6      7             8                 9           10          11     12      13         14
-    result = CharacterDatabase.PQuery("SELECT itemEntry, creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability, itemTextId, TabId, SlotId, item_guid, item_entry FROM guild_bank_item JOIN item_instance ON item_guid = guid WHERE guildid='%u' ORDER BY TabId", m_Id);
+    result = itemResult;
     if (!result)
         return;
 
@@ -1269,8 +1421,7 @@ bool Guild::MemberMoneyWithdraw(uint32 amount, uint32 LowGuid)
         if (itr == members.end())
             return false;
         itr->second.BankRemMoney -= amount;
-        CharacterDatabase.PExecute("UPDATE guild_member SET BankRemMoney='%u' WHERE guildid='%u' AND guid='%u'",
-                                   itr->second.BankRemMoney, m_Id, LowGuid);
+        CharacterDatabase.DelayedUpdate("guild_member", GuildMemberRowKey(m_Id, LowGuid), "BankRemMoney", std::to_string(itr->second.BankRemMoney));
     }
     return true;
 }
@@ -1281,7 +1432,12 @@ void Guild::SetBankMoney(int64 money)
         money = 0;
     m_GuildBankMoney = money;
 
-    CharacterDatabase.PExecute("UPDATE guild SET BankMoney='" UI64FMTD "' WHERE guildid='%u'", money, m_Id);
+    CharacterDatabase.DelayedUpdate("guild", "guildid = " + std::to_string(m_Id), "BankMoney", std::to_string(money));
+}
+
+void Guild::FlushMemberBankLimits(uint32 LowGuid)
+{
+    CharacterDatabase.FlushDelayedUpdate("guild_member", GuildMemberRowKey(m_Id, LowGuid));
 }
 
 // *************************************************
@@ -1300,8 +1456,8 @@ bool Guild::MemberItemWithdraw(uint8 TabId, uint32 LowGuid)
         if (itr == members.end())
             return false;
         --itr->second.BankRemSlotsTab[TabId];
-        CharacterDatabase.PExecute("UPDATE guild_member SET BankRemSlotsTab%u='%u' WHERE guildid='%u' AND guid='%u'",
-                                   uint32(TabId), itr->second.BankRemSlotsTab[TabId], m_Id, LowGuid);
+        CharacterDatabase.DelayedUpdate("guild_member", GuildMemberRowKey(m_Id, LowGuid), ("BankRemSlotsTab" + std::to_string(TabId)).c_str(),
+                                        std::to_string(itr->second.BankRemSlotsTab[TabId]));
     }
     return true;
 }
@@ -1336,8 +1492,9 @@ uint32 Guild::GetMemberSlotWithdrawRem(uint32 LowGuid, uint8 TabId)
     {
         member.BankResetTimeTab[TabId] = curTime;
         member.BankRemSlotsTab[TabId] = GetBankSlotPerDay(member.RankId, TabId);
-        CharacterDatabase.PExecute("UPDATE guild_member SET BankResetTimeTab%u='%u', BankRemSlotsTab%u='%u' WHERE guildid='%u' AND guid='%u'",
-                                   uint32(TabId), member.BankResetTimeTab[TabId], uint32(TabId), member.BankRemSlotsTab[TabId], m_Id, LowGuid);
+        std::string const key = GuildMemberRowKey(m_Id, LowGuid);
+        CharacterDatabase.DelayedUpdate("guild_member", key, ("BankResetTimeTab" + std::to_string(TabId)).c_str(), std::to_string(member.BankResetTimeTab[TabId]));
+        CharacterDatabase.DelayedUpdate("guild_member", key, ("BankRemSlotsTab" + std::to_string(TabId)).c_str(), std::to_string(member.BankRemSlotsTab[TabId]));
     }
     return member.BankRemSlotsTab[TabId];
 }
@@ -1358,8 +1515,9 @@ uint32 Guild::GetMemberMoneyWithdrawRem(uint32 LowGuid)
     {
         member.BankResetTimeMoney = curTime;
         member.BankRemMoney = GetBankMoneyPerDay(member.RankId);
-        CharacterDatabase.PExecute("UPDATE guild_member SET BankResetTimeMoney='%u', BankRemMoney='%u' WHERE guildid='%u' AND guid='%u'",
-                                   member.BankResetTimeMoney, member.BankRemMoney, m_Id, LowGuid);
+        std::string const key = GuildMemberRowKey(m_Id, LowGuid);
+        CharacterDatabase.DelayedUpdate("guild_member", key, "BankResetTimeMoney", std::to_string(member.BankResetTimeMoney));
+        CharacterDatabase.DelayedUpdate("guild_member", key, "BankRemMoney", std::to_string(member.BankRemMoney));
     }
     return member.BankRemMoney;
 }
@@ -1382,6 +1540,7 @@ void Guild::SetBankMoneyPerDay(uint32 rankId, uint32 money)
     }
 
     CharacterDatabase.PExecute("UPDATE guild_rank SET BankMoneyPerDay='%u' WHERE rid='%u' AND guildid='%u'", money, rankId, m_Id);
+    CharacterDatabase.FlushWriteBehind();                   // pending member reset times must not overwrite the reset
     CharacterDatabase.PExecute("UPDATE guild_member SET BankResetTimeMoney='0' WHERE guildid='%u' AND `rank`='%u'", m_Id, rankId);
 }
 
@@ -1416,6 +1575,7 @@ void Guild::SetBankRightsAndSlots(uint32 rankId, uint8 TabId, uint32 right, uint
         CharacterDatabase.PExecute("DELETE FROM guild_bank_right WHERE guildid='%u' AND TabId='%u' AND rid='%u'", m_Id, uint32(TabId), rankId);
         CharacterDatabase.PExecute("INSERT INTO guild_bank_right (guildid,TabId,rid,gbright,SlotPerDay) VALUES "
                                    "('%u','%u','%u','%u','%u')", m_Id, uint32(TabId), rankId, m_Ranks[rankId].TabRight[TabId], m_Ranks[rankId].TabSlotPerDay[TabId]);
+        CharacterDatabase.FlushWriteBehind();               // pending member reset times must not overwrite the reset
         CharacterDatabase.PExecute("UPDATE guild_member SET BankResetTimeTab%u='0' WHERE guildid='%u' AND `rank`='%u'", uint32(TabId), m_Id, rankId);
     }
 }
@@ -1481,7 +1641,7 @@ bool Guild::LoadBankRightsFromDB(QueryResult* guildBankTabRightsResult)
 // *************************************************
 // Bank log related
 
-void Guild::LoadGuildBankEventLogFromDB()
+void Guild::LoadGuildBankEventLogFromDB(QueryResult* moneyResult, QueryResult* const* tabResults)
 {
     // Money log is in TabId = GUILD_BANK_MONEY_LOGS_TAB
 
@@ -1489,8 +1649,7 @@ void Guild::LoadGuildBankEventLogFromDB()
     // cycle through all purchased guild bank item tabs
     for (uint32 tabId = 0; tabId < uint32(GetPurchasedTabs()); ++tabId)
     {
-        //                                                     0        1          2           3            4               5          6
-        QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' AND TabId='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, tabId, GUILD_BANK_MAX_LOGS);
+        QueryResult* result = tabResults[tabId];
         if (!result)
             continue;
 
@@ -1531,8 +1690,7 @@ void Guild::LoadGuildBankEventLogFromDB()
     }
 
     // special handle for guild bank money log
-    //                                                     0        1          2           3            4               5          6
-    QueryResult* result = CharacterDatabase.PQuery("SELECT LogGuid, EventType, PlayerGuid, ItemOrMoney, ItemStackCount, DestTabId, TimeStamp FROM guild_bank_eventlog WHERE guildid='%u' AND TabId='%u' ORDER BY TimeStamp DESC,LogGuid DESC LIMIT %u", m_Id, GUILD_BANK_MONEY_LOGS_TAB, GUILD_BANK_MAX_LOGS);
+    QueryResult* result = moneyResult;
     if (!result)
         return;
 
@@ -1620,6 +1778,19 @@ void Guild::LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uin
     NewEvent.DestTabId = DestTabId;
     NewEvent.TimeStamp = uint32(time(nullptr));
 
+    // the next LogGuid is only known once the log is loaded
+    if (!IsDataLoaded())
+    {
+        m_pendingBankEventLog.emplace_back(TabId, NewEvent);
+        LoadDataAsync();
+        return;
+    }
+
+    AddBankEventLogEntry(TabId, NewEvent);
+}
+
+void Guild::AddBankEventLogEntry(uint8 TabId, GuildBankEventLogEntry const& NewEvent)
+{
     // add new event to the end of event list
     uint32 currentTabId = TabId;
     uint32 currentLogGuid;
@@ -1650,6 +1821,17 @@ void Guild::LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uin
                                m_Id, currentLogGuid, currentTabId, uint32(NewEvent.EventType), NewEvent.PlayerGuid, NewEvent.ItemOrMoney, uint32(NewEvent.ItemStackCount), uint32(NewEvent.DestTabId), NewEvent.TimeStamp);
 }
 
+void Guild::AddPendingLogEntries()
+{
+    for (GuildEventLogEntry const& entry : m_pendingEventLog)
+        AddGuildEventLogEntry(entry);
+    m_pendingEventLog.clear();
+
+    for (auto const& entry : m_pendingBankEventLog)
+        AddBankEventLogEntry(entry.first, entry.second);
+    m_pendingBankEventLog.clear();
+}
+
 bool Guild::AddGBankItemToDB(uint32 GuildId, uint32 BankTab, uint32 BankTabSlot, uint32 GUIDLow, uint32 Entry) const
 {
     CharacterDatabase.PExecute("DELETE FROM guild_bank_item WHERE guildid = '%u' AND TabId = '%u'AND SlotId = '%u'", GuildId, BankTab, BankTabSlot);
@@ -28,6 +28,7 @@
 #include "Globals/SharedDefines.h"
 
 class Item;
+class SqlQueryHolder;
 
 #define GUILD_RANKS_MIN_COUNT   5
 #define GUILD_RANKS_MAX_COUNT   10
@@ -186,6 +187,14 @@ enum GuildEmblem
     ERR_GUILDEMBLEM_INVALIDVENDOR         = 5
 };
 
+// event log, bank content and bank logs are loaded at first use
+enum GuildDataState
+{
+    GUILD_DATA_NOT_LOADED   = 0,
+    GUILD_DATA_LOADING      = 1,                            // async query in progress
+    GUILD_DATA_LOADED       = 2,
+};
+
 inline uint32 GetGuildBankTabPrice(uint8 Index)
 {
     switch (Index)
@@ -396,8 +405,14 @@ class Guild
         void Roster(WorldSession* session = nullptr);          // nullptr = broadcast
         void Query(WorldSession* session);
 
+        // Event log, bank content and bank logs
+        bool   IsDataLoaded() const { return m_dataState == GUILD_DATA_LOADED; }
+        void   LoadDataAsync();
+        void   LoadDataDirect();                            // for callers that can't wait for the async load
+        void   LoadDataFromHolder(SqlQueryHolder* holder);
+
         // Guild EventLog
-        void   LoadGuildEventLogFromDB();
+        void   LoadGuildEventLogFromDB(QueryResult* result);
         void   DisplayGuildEventLog(WorldSession* session);
         void   LogGuildEvent(uint8 EventType, ObjectGuid playerGuid1, ObjectGuid playerGuid2 = ObjectGuid(), uint8 newRank = 0);
 
@@ -420,7 +435,7 @@ class Guild
         uint32 GetBankRights(uint32 rankId, uint8 TabId) const;
         bool   IsMemberHaveRights(uint32 LowGuid, uint8 TabId, uint32 rights) const;
         // Load
-        void   LoadGuildBankFromDB();
+        void   LoadGuildBankFromDB(QueryResult* tabResult, QueryResult* itemResult);
         // Money deposit/withdraw
         void   SendMoneyInfo(WorldSession* session, uint32 LowGuid);
         bool   MemberMoneyWithdraw(uint32 amount, uint32 LowGuid);
@@ -431,13 +446,14 @@ class Guild
         uint32 GetMemberSlotWithdrawRem(uint32 LowGuid, uint8 TabId);
         uint32 GetMemberMoneyWithdrawRem(uint32 LowGuid);
         void   SetBankMoneyPerDay(uint32 rankId, uint32 money);
+        void   FlushMemberBankLimits(uint32 LowGuid);       // writes the member's withdraw limits held back by the write-behind window
         void   SetBankRightsAndSlots(uint32 rankId, uint8 TabId, uint32 right, uint32 nbSlots, bool db);
         uint32 GetBankMoneyPerDay(uint32 rankId);
         uint32 GetBankSlotPerDay(uint32 rankId, uint8 TabId);
         // rights per day
         bool   LoadBankRightsFromDB(QueryResult* guildBankTabRightsResult);
         // Guild Bank Event Logs
-        void   LoadGuildBankEventLogFromDB();
+        void   LoadGuildBankEventLogFromDB(QueryResult* moneyResult, QueryResult* const* tabResults);
         void   DisplayGuildBankLogs(WorldSession* session, uint8 TabId);
         void   LogBankEvent(uint8 EventType, uint8 TabId, uint32 PlayerGuidLow, uint32 ItemOrMoney, uint8 ItemStackCount = 0, uint8 DestTabId = 0);
         bool   AddGBankItemToDB(uint32 GuildId, uint32 BankTab, uint32 BankTabSlot, uint32 GUIDLow, uint32 Entry) const;
@@ -475,6 +491,12 @@ class Guild
         GuildBankEventLog m_GuildBankEventLog_Money;
         GuildBankEventLog m_GuildBankEventLog_Item[GUILD_BANK_MAX_TABS];
 
+        GuildDataState m_dataState;
+
+        // logged while the data loads, added once the log guids are known
+        std::vector<GuildEventLogEntry> m_pendingEventLog;
+        std::vector<std::pair<uint8, GuildBankEventLogEntry>> m_pendingBankEventLog;
+
         uint32 m_GuildEventLogNextGuid;
         uint32 m_GuildBankEventLogNextGuid_Money;
         uint32 m_GuildBankEventLogNextGuid_Item[GUILD_BANK_MAX_TABS];
@@ -484,6 +506,10 @@ class Guild
     private:
         void UpdateAccountsNumber() { m_accountsNumber = 0;}// mark for lazy calculation at request in GetAccountsNumber
 
+        void   AddGuildEventLogEntry(GuildEventLogEntry const& NewEvent);
+        void   AddBankEventLogEntry(uint8 TabId, GuildBankEventLogEntry const& NewEvent);
+        void   AddPendingLogEntries();
+
         // used only from high level Swap/Move functions
         Item*  GetItem(uint8 TabId, uint8 SlotId);
         InventoryResult CanStoreItem(uint8 tab, uint8 slot, GuildItemPosCountVec& dest, uint32 count, Item* pItem, bool swap = false) const;
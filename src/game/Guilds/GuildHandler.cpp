@@ -762,14 +762,33 @@ void WorldSession::HandleSaveGuildEmblemOpcode(WorldPacket& recvPacket)
     guild->Query(this);
 }
 
-void WorldSession::HandleGuildEventLogQueryOpcode(WorldPacket& /* recvPacket */)
+// event log and bank are loaded at first use, the packet is handled again once the async load finished
+bool WorldSession::IsGuildDataReady(Guild* guild, WorldPacket const& packet)
+{
+    if (guild->IsDataLoaded())
+        return true;
+
+    // bot sessions don't process a receive queue of their own
+    if (!m_Socket)
+    {
+        guild->LoadDataDirect();
+        return true;
+    }
+
+    guild->LoadDataAsync();
+    DeferPacket(packet);
+    return false;
+}
+
+void WorldSession::HandleGuildEventLogQueryOpcode(WorldPacket& recvPacket)
 {
     // empty
     DEBUG_LOG("WORLD: Received (MSG_GUILD_EVENT_LOG_QUERY)");
 
     if (uint32 GuildId = GetPlayer()->GetGuildId())
         if (Guild* pGuild = sGuildMgr.GetGuildById(GuildId))
-            pGuild->DisplayGuildEventLog(this);
+            if (IsGuildDataReady(pGuild, recvPacket))
+                pGuild->DisplayGuildEventLog(this);
 }
 
 /******  GUILD BANK  *******/
@@ -827,7 +846,8 @@ void WorldSession::HandleGuildBankerActivate(WorldPacket& recv_data)
     {
         if (Guild* pGuild = sGuildMgr.GetGuildById(GuildId))
         {
-            pGuild->DisplayGuildBankTabsInfo(this);         // this also will load guild bank if not yet
+            if (IsGuildDataReady(pGuild, recv_data))
+                pGuild->DisplayGuildBankTabsInfo(this);
             return;
         }
     }
@@ -855,6 +875,9 @@ void WorldSession::HandleGuildBankQueryTab(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (TabId >= pGuild->GetPurchasedTabs())
         return;
 
@@ -889,6 +912,9 @@ void WorldSession::HandleGuildBankDepositMoney(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (!pGuild->GetPurchasedTabs())
         return;
 
@@ -937,6 +963,9 @@ void WorldSession::HandleGuildBankWithdrawMoney(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (!pGuild->GetPurchasedTabs())
         return;
 
@@ -1001,6 +1030,12 @@ void WorldSession::HandleGuildBankSwapItems(WorldPacket& recv_data)
         return;
     }
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+    {
+        recv_data.rpos(recv_data.wpos());
+        return;
+    }
+
     if (BankToBank)
     {
         recv_data >> BankTabDst;
@@ -1096,6 +1131,9 @@ void WorldSession::HandleGuildBankBuyTab(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     // m_PurchasedTabs = 0 when buying Tab 0, that is why this check can be made
     if (TabId != pGuild->GetPurchasedTabs())
         return;
@@ -1146,6 +1184,9 @@ void WorldSession::HandleGuildBankUpdateTab(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (TabId >= pGuild->GetPurchasedTabs())
         return;
 
@@ -1169,6 +1210,9 @@ void WorldSession::HandleGuildBankLogQuery(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     // GUILD_BANK_MAX_TABS send by client for money log
     if (TabId >= pGuild->GetPurchasedTabs() && TabId != GUILD_BANK_MAX_TABS)
         return;
@@ -1191,6 +1235,9 @@ void WorldSession::HandleQueryGuildBankTabText(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (TabId >= pGuild->GetPurchasedTabs())
         return;
 
@@ -1214,6 +1261,9 @@ void WorldSession::HandleSetGuildBankTabText(WorldPacket& recv_data)
     if (!pGuild)
         return;
 
+    if (!IsGuildDataReady(pGuild, recv_data))
+        return;
+
     if (TabId >= pGuild->GetPurchasedTabs())
         return;
 
@@ -143,9 +143,7 @@ void GuildMgr::LoadGuilds()
             continue;
         }
 
-        newGuild->LoadGuildEventLogFromDB();
-        newGuild->LoadGuildBankEventLogFromDB();
-        newGuild->LoadGuildBankFromDB();
+        // event log and bank are loaded when a member logs in or uses them
         AddGuild(newGuild);
     }
     while (result->NextRow());
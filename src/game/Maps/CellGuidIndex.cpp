@@ -0,0 +1,175 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/CellGuidIndex.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+    bool InsertSorted(CellGuidIndex::GuidList& list, uint32 guid)
+    {
+        auto itr = std::lower_bound(list.begin(), list.end(), guid);
+        if (itr != list.end() && *itr == guid)
+            return false;
+
+        list.insert(itr, guid);
+        return true;
+    }
+
+    template<class Map>
+    bool EraseSorted(Map& lists, uint32 cellId, uint32 guid)
+    {
+        auto listItr = lists.find(cellId);
+        if (listItr == lists.end())
+            return false;
+
+        CellGuidIndex::GuidList& list = listItr->second;
+        auto itr = std::lower_bound(list.begin(), list.end(), guid);
+        if (itr == list.end() || *itr != guid)
+            return false;
+
+        list.erase(itr);
+        if (list.empty())
+            lists.erase(listItr);
+        return true;
+    }
+}
+
+void CellGuidIndex::Insert(uint32 cellId, uint32 guid)
+{
+    // erased packed guid coming back
+    if (EraseSorted(m_removed, cellId, guid))
+        return;
+
+    if (IsPacked(cellId, guid))
+        return;
+
+    InsertSorted(m_added[cellId], guid);
+}
+
+void CellGuidIndex::Erase(uint32 cellId, uint32 guid)
+{
+    if (EraseSorted(m_added, cellId, guid))
+        return;
+
+    if (IsPacked(cellId, guid))
+        InsertSorted(m_removed[cellId], guid);
+}
+
+void CellGuidIndex::Pack()
+{
+    std::vector<std::pair<uint32, uint32>> entries;
+    entries.reserve(m_guids.size());
+
+    for (size_t i = 0; i < m_cells.size(); ++i)
+    {
+        GuidList guids;
+        GetGuids(m_cells[i], guids);
+        for (uint32 guid : guids)
+            entries.emplace_back(m_cells[i], guid);
+    }
+
+    // cells only present in the side lists
+    for (auto const& added : m_added)
+        if (!std::binary_search(m_cells.begin(), m_cells.end(), added.first))
+            for (uint32 guid : added.second)
+                entries.emplace_back(added.first, guid);
+
+    std::sort(entries.begin(), entries.end());
+
+    std::vector<uint32> cells;
+    std::vector<uint32> offsets;
+    GuidList guids;
+    guids.reserve(entries.size());
+    for (auto const& entry : entries)
+    {
+        if (cells.empty() || cells.back() != entry.first)
+        {
+            cells.push_back(entry.first);
+            offsets.push_back(uint32(guids.size()));
+        }
+        guids.push_back(entry.second);
+    }
+    offsets.push_back(uint32(guids.size()));
+
+    cells.shrink_to_fit();
+    offsets.shrink_to_fit();
+
+    m_cells.swap(cells);
+    m_offsets.swap(offsets);
+    m_guids.swap(guids);
+    CellGuidLists().swap(m_added);
+    CellGuidLists().swap(m_removed);
+}
+
+void CellGuidIndex::GetGuids(uint32 cellId, GuidList& guids) const
+{
+    GuidList::const_iterator begin, end;
+    bool const packed = GetPackedRange(cellId, begin, end);
+
+    auto addedItr = m_added.find(cellId);
+    if (addedItr == m_added.end())
+    {
+        if (!packed)
+            return;
+
+        auto removedItr = m_removed.find(cellId);
+        if (removedItr == m_removed.end())
+            guids.insert(guids.end(), begin, end);
+        else
+            std::set_difference(begin, end, removedItr->second.begin(), removedItr->second.end(), std::back_inserter(guids));
+        return;
+    }
+
+    GuidList const& added = addedItr->second;
+    if (!packed)
+    {
+        guids.insert(guids.end(), added.begin(), added.end());
+        return;
+    }
+
+    GuidList merged;
+    auto removedItr = m_removed.find(cellId);
+    if (removedItr == m_removed.end())
+        merged.assign(begin, end);
+    else
+        std::set_difference(begin, end, removedItr->second.begin(), removedItr->second.end(), std::back_inserter(merged));
+
+    std::merge(merged.begin(), merged.end(), added.begin(), added.end(), std::back_inserter(guids));
+}
+
+bool CellGuidIndex::GetPackedRange(uint32 cellId, GuidList::const_iterator& begin, GuidList::const_iterator& end) const
+{
+    auto cellItr = std::lower_bound(m_cells.begin(), m_cells.end(), cellId);
+    if (cellItr == m_cells.end() || *cellItr != cellId)
+        return false;
+
+    size_t const index = cellItr - m_cells.begin();
+    begin = m_guids.begin() + m_offsets[index];
+    end = m_guids.begin() + m_offsets[index + 1];
+    return true;
+}
+
+bool CellGuidIndex::IsPacked(uint32 cellId, uint32 guid) const
+{
+    GuidList::const_iterator begin, end;
+    return GetPackedRange(cellId, begin, end) && std::binary_search(begin, end, guid);
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CELL_GUID_INDEX_H
+#define CELL_GUID_INDEX_H
+
+#include "Platform/Define.h"
+
+#include <unordered_map>
+#include <vector>
+
+/*
+  Spawn guids of one map by cell id. Pack() folds everything into one sorted guid array with a sorted cell id array
+  and per cell offsets on top (CSR layout), which is what the static DB spawns are kept in once loaded. Inserts and
+  erases after that only touch two small per cell side lists, so event, pool and GM spawn changes stay cheap.
+*/
+class CellGuidIndex
+{
+    public:
+        typedef std::vector<uint32> GuidList;
+
+        void Insert(uint32 cellId, uint32 guid);
+        void Erase(uint32 cellId, uint32 guid);
+        void Pack();
+
+        // appends the guids of a cell in ascending order
+        void GetGuids(uint32 cellId, GuidList& guids) const;
+        size_t GetPackedSize() const { return m_guids.size(); }
+
+    private:
+        typedef std::unordered_map<uint32/*cell_id*/, GuidList> CellGuidLists;
+
+        bool GetPackedRange(uint32 cellId, GuidList::const_iterator& begin, GuidList::const_iterator& end) const;
+        bool IsPacked(uint32 cellId, uint32 guid) const;
+
+        std::vector<uint32> m_cells;                        // sorted ids of cells with packed guids
+        std::vector<uint32> m_offsets;                      // guids of m_cells[i] are m_guids[m_offsets[i]] up to m_guids[m_offsets[i + 1]]
+        GuidList m_guids;
+        CellGuidLists m_added;                              // sorted, not packed yet
+        CellGuidLists m_removed;                            // sorted, packed but erased since
+};
+
+#endif
@@ -32,6 +32,13 @@ class Pet;
 class Player;
 class Camera;
 
+// world objects kept in cell containers also get packed positions, cameras only follow their viewpoint
+template<> struct GridPackedTraits<Corpse>          { static constexpr bool enabled = true; };
+template<> struct GridPackedTraits<Creature>        { static constexpr bool enabled = true; };
+template<> struct GridPackedTraits<DynamicObject>   { static constexpr bool enabled = true; };
+template<> struct GridPackedTraits<GameObject>      { static constexpr bool enabled = true; };
+template<> struct GridPackedTraits<Player>          { static constexpr bool enabled = true; };
+
 #define MAX_NUMBER_OF_GRIDS      64
 
 #define SIZE_OF_GRIDS            533.33333f
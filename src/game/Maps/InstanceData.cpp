@@ -29,13 +29,16 @@ void InstanceData::SaveToDB() const
     if (!Save())
         return;
 
-    std::string data = Save();
+    std::string const raw = Save();
+    std::string data = raw;
     CharacterDatabase.escape_string(data);
 
+    // scripts save on every state change, a boss fight only needs its last state written. The raw data is
+    // handed to a map loading it again before the update is written.
     if (instance->Instanceable())
-        CharacterDatabase.PExecute("UPDATE instance SET data = '%s' WHERE id = '%u'", data.c_str(), instance->GetInstanceId());
+        CharacterDatabase.DelayedUpdate("instance", "id = " + std::to_string(instance->GetInstanceId()), "data", "'" + data + "'", &raw);
     else
-        CharacterDatabase.PExecute("UPDATE world SET data = '%s' WHERE map = '%u'", data.c_str(), instance->GetId());
+        CharacterDatabase.DelayedUpdate("world", "map = " + std::to_string(instance->GetId()), "data", "'" + data + "'", &raw);
 }
 
 bool InstanceData::CheckConditionCriteriaMeet(Player const* /*source*/, uint32 instance_condition_id, WorldObject const* /*conditionSource*/, uint32 conditionSourceType) const
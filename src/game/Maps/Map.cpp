@@ -31,6 +31,7 @@
 #include "Globals/ObjectAccessor.h"
 #include "Globals/ObjectMgr.h"
 #include "World/World.h"
+#include "World/FrameProfiler.h"
 #include "Groups/Group.h"
 #include "MapRefManager.h"
 #include "Server/DBCEnums.h"
@@ -40,10 +41,6 @@
 #include "Weather/Weather.h"
 #include "AI/ScriptDevAI/ScriptDevAIMgr.h"
 
-#ifdef BUILD_METRICS
- #include "Metric/Metric.h"
-#endif
-
 Map::~Map()
 {
     UnloadAll(true);
@@ -155,6 +152,18 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
       m_variableManager(this)
 {
     m_weatherSystem = new WeatherSystem(this);
+
+#ifdef BUILD_METRICS
+    std::map<std::string, std::string> metricTags = {
+        { "map_id", std::to_string(i_id) },
+        { "instance_id", std::to_string(i_InstanceId) }
+    };
+    m_updateMetric = metric::histogram("map.update", metricTags);
+    m_sessionUpdateMetric = metric::histogram("map.update.session", metricTags);
+    m_updatedObjectsMetric = metric::counter("map.update.objects", metricTags);
+    m_updatedSessionsMetric = metric::counter("map.update.sessions", metricTags);
+    m_messagesMetric = metric::counter("map.update.messages", metricTags);
+#endif
 }
 
 void Map::Initialize(bool loadInstanceData /*= true*/)
@@ -664,18 +673,24 @@ void Map::Update(const uint32& t_diff)
 {
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
-});
+    metric::scoped_timer<std::chrono::microseconds> meas(m_updateMetric);
 #endif
+    SqlThreadRoleGuard sqlThreadRole(SQL_THREAD_MAP);      // maps are updated by the world thread without map threads
+    FrameProfileZone mapZone("Map::Update", GetId(), GetInstanceId());
+    FrameProfileZone phase("Map::DynamicTree");
 
 
     uint64 count = 0;
 
     m_dyn_tree.update(t_diff);
 
+    phase.Next("Map::Messager");
+#ifdef BUILD_METRICS
+    m_messagesMetric.add(GetMessager().Execute(this));
+#else
     GetMessager().Execute(this);
+#endif
+    phase.Next("Map::SpawnManager");
     m_spawnManager.Update();
 
     /// update active cells around players and active objects
@@ -686,6 +701,7 @@ void Map::Update(const uint32& t_diff)
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
 
+    phase.Next("Map::Transports");
     for (m_transportsIterator = m_transports.begin(); m_transportsIterator != m_transports.end();)
     {
         Transport* transport = *m_transportsIterator;
@@ -695,13 +711,11 @@ void Map::Update(const uint32& t_diff)
 
     // the player iterator is stored in the map object
     // to make sure calls to Map::Remove don't invalidate it
+    phase.Next("Map::UpdateSessions");
     {
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
-        metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
-            { "map_id", std::to_string(i_id) },
-            { "instance_id", std::to_string(i_InstanceId) },
-            });
+        metric::scoped_timer<std::chrono::microseconds> sessions_meas(m_sessionUpdateMetric);
 #endif
 
         for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -718,11 +732,12 @@ void Map::Update(const uint32& t_diff)
 #endif
         }
 #ifdef BUILD_METRICS
-        sessions_meas.add_field("count", std::to_string(static_cast<int32>(updatedSessions)));
+        m_updatedSessionsMetric.add(updatedSessions);
 #endif
     }
 
     /// update players at tick
+    phase.Next("Map::UpdatePlayers");
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* plr = m_mapRefIter->getSource();
@@ -730,6 +745,7 @@ void Map::Update(const uint32& t_diff)
             plr->Update(t_diff);
     }
 
+    phase.Next("Map::VisitCells");
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
         Player* player = m_mapRefIter->getSource();
@@ -785,6 +801,7 @@ void Map::Update(const uint32& t_diff)
     }
 
     // update all objects
+    phase.Next("Map::UpdateObjects");
     for (auto wObj : objToUpdate)
     {
         wObj->Update(t_diff);
@@ -792,12 +809,19 @@ void Map::Update(const uint32& t_diff)
     }
 
 #ifdef BUILD_METRICS
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    m_updatedObjectsMetric.add(count);
 #endif
 
+    // Update visibility of units that moved far enough during this update
+    phase.Next("Map::ProcessRelocatedUnits");
+    ProcessRelocatedUnits();
+
     // Send world objects and item update field changes
+    phase.Next("Map::SendObjectUpdates");
     SendObjectUpdates();
 
+    phase.Next("Map::UpdateGridStates");
+
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
     if (!IsBattleGroundOrArena())
@@ -813,12 +837,15 @@ void Map::Update(const uint32& t_diff)
     }
 
     ///- Process necessary scripts
+    phase.Next("Map::ScriptsProcess");
     if (!m_scriptSchedule.empty())
         ScriptsProcess();
 
+    phase.Next("InstanceData::Update");
     if (i_data)
         i_data->Update(t_diff);
 
+    phase.Next("Map::UpdateWeathers");
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
@@ -1142,6 +1169,105 @@ void Map::UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& ce
             player->UpdateVisibilityOf(player->GetCamera().GetBody(), obj);
 }
 
+void Map::AddRelocatedUnit(Unit* unit)
+{
+    m_relocatedUnits.push_back(unit->GetObjectGuid());
+}
+
+void Map::ProcessRelocatedUnits()
+{
+    if (m_relocatedUnits.empty())
+        return;
+
+    // units relocated while processing wait for the next update
+    std::swap(m_relocatedUnits, m_relocationBatch);
+
+    // a unit moving several times per update is processed once at its final position
+    std::sort(m_relocationBatch.begin(), m_relocationBatch.end());
+    m_relocationBatch.erase(std::unique(m_relocationBatch.begin(), m_relocationBatch.end()), m_relocationBatch.end());
+
+    m_relocationCells.clear();
+    for (ObjectGuid const& guid : m_relocationBatch)
+    {
+        // can be removed from map since relocation
+        Unit* unit = GetUnit(guid);
+        if (!unit || !unit->IsInWorld() || !unit->IsPositionValid())
+            continue;
+
+        unit->GetViewPoint().Call_UpdateVisibilityForOwner();
+
+        CellPair p = MaNGOS::ComputeCellPair(unit->GetPositionX(), unit->GetPositionY());
+        m_relocationCells.emplace_back(p.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + p.x_coord, unit);
+    }
+    m_relocationBatch.clear();
+
+    std::sort(m_relocationCells.begin(), m_relocationCells.end(), [](std::pair<uint32, Unit*> const& a, std::pair<uint32, Unit*> const& b)
+    {
+        return a.first < b.first;
+    });
+
+    // units standing in the same cell share one camera search over the union of their visibility areas,
+    // extra cameras are harmless since UpdateVisibilityOf does the real distance check
+    MaNGOS::CameraCollector collector(m_relocationCameras);
+    TypeContainerVisitor<MaNGOS::CameraCollector, WorldTypeMapContainer> cameraVisitor(collector);
+
+    for (auto groupBegin = m_relocationCells.begin(); groupBegin != m_relocationCells.end();)
+    {
+        uint32 cellId = groupBegin->first;
+        auto groupEnd = std::find_if(groupBegin, m_relocationCells.end(), [cellId](std::pair<uint32, Unit*> const& entry) { return entry.first != cellId; });
+
+        CellArea area;
+        for (auto itr = groupBegin; itr != groupEnd; ++itr)
+        {
+            Unit* unit = itr->second;
+            // same radius as Cell::Visit uses for a single object
+            float radius = std::min(unit->GetVisibilityData().GetVisibilityDistance() + unit->GetObjectBoundingRadius(), MAX_VISIBILITY_DISTANCE);
+            CellArea unitArea = Cell::CalculateCellArea(unit->GetPositionX(), unit->GetPositionY(), radius);
+            if (itr == groupBegin)
+                area = unitArea;
+            else
+            {
+                area.low_bound.x_coord = std::min(area.low_bound.x_coord, unitArea.low_bound.x_coord);
+                area.low_bound.y_coord = std::min(area.low_bound.y_coord, unitArea.low_bound.y_coord);
+                area.high_bound.x_coord = std::max(area.high_bound.x_coord, unitArea.high_bound.x_coord);
+                area.high_bound.y_coord = std::max(area.high_bound.y_coord, unitArea.high_bound.y_coord);
+            }
+        }
+
+        m_relocationCameras.clear();
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+        {
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+            {
+                Cell cell(CellPair(x, y));
+                cell.SetNoCreate();
+                Visit(cell, cameraVisitor);
+            }
+        }
+
+        for (auto itr = groupBegin; itr != groupEnd; ++itr)
+        {
+            Unit* unit = itr->second;
+            GuidSet unvisitedGuids = unit->GetClientGuidsIAmAt();
+            for (Camera* camera : m_relocationCameras)
+            {
+                camera->UpdateVisibilityOf(unit);
+                unvisitedGuids.erase(camera->GetOwner()->GetObjectGuid());
+            }
+
+            // players still seeing the unit from outside the searched area
+            for (auto guid : unvisitedGuids)
+                if (Player* player = GetPlayer(guid))
+                    player->UpdateVisibilityOf(player->GetCamera().GetBody(), unit);
+        }
+
+        groupBegin = groupEnd;
+    }
+
+    m_relocationCells.clear();
+    m_relocationCameras.clear();
+}
+
 void Map::SendInitSelf(Player* player) const
 {
     DETAIL_LOG("Creating player data for himself %u", player->GetGUIDLow());
@@ -1475,14 +1601,31 @@ void Map::CreateInstanceData(bool load)
     if (load)
     {
         // TODO: make a global storage for this
-        QueryResult* result;
+        QueryResult* result = nullptr;
 
+        // data saved by a previous instance of this map may still be held back, it is newer than the stored one.
+        // Its update is queued and the data taken from it, the read would not wait for the write.
+        std::string pendingData;
+        bool pending;
         if (Instanceable())
-            result = CharacterDatabase.PQuery("SELECT data FROM instance WHERE id = '%u'", i_InstanceId);
+        {
+            pending = CharacterDatabase.FlushDelayedUpdate("instance", "id = " + std::to_string(i_InstanceId), "data", &pendingData);
+            if (!pending)
+                result = CharacterDatabase.PQuery("SELECT data FROM instance WHERE id = '%u'", i_InstanceId);
+        }
         else
-            result = CharacterDatabase.PQuery("SELECT data FROM world WHERE map = '%u'", GetId());
+        {
+            pending = CharacterDatabase.FlushDelayedUpdate("world", "map = " + std::to_string(GetId()), "data", &pendingData);
+            if (!pending)
+                result = CharacterDatabase.PQuery("SELECT data FROM world WHERE map = '%u'", GetId());
+        }
 
-        if (result)
+        if (pending)
+        {
+            DEBUG_LOG("Loading instance data for `%s` (Map: %u Instance: %u)", sScriptDevAIMgr.GetScriptName(i_script_id), GetId(), i_InstanceId);
+            i_data->Load(pendingData.c_str());
+        }
+        else if (result)
         {
             Field* fields = result->Fetch();
             const char* data = fields[0].GetString();
@@ -40,6 +40,10 @@
 #include "Maps/MapDataContainer.h"
 #include "World/WorldStateVariableManager.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
 #include <bitset>
 #include <functional>
 #include <list>
@@ -222,6 +226,9 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, const CellPair& cellpair);
 
+        // visibility of relocated units is updated once per map update, see ProcessRelocatedUnits
+        void AddRelocatedUnit(Unit* unit);
+
         void resetMarkedCells() { marked_cells.reset(); }
         bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
@@ -353,6 +360,7 @@ class Map : public GridRefManager<NGridType>
         uint32 GetLoadedGridsCount();
 
         Messager<Map>& GetMessager() { return m_messager; }
+        Messager<Map> const& GetMessager() const { return m_messager; }
 
         typedef std::set<Transport*> TransportSet;
         GenericTransport* GetTransport(ObjectGuid guid);
@@ -437,6 +445,15 @@ class Map : public GridRefManager<NGridType>
         Messager<Map> m_messager;
 
         GraveyardManager m_graveyardManager;
+
+#ifdef BUILD_METRICS
+        // registered once per map, Update only records into them
+        metric::histogram m_updateMetric;                   // microseconds
+        metric::histogram m_sessionUpdateMetric;            // microseconds
+        metric::counter m_updatedObjectsMetric;
+        metric::counter m_updatedSessionsMetric;
+        metric::counter m_messagesMetric;
+#endif
     private:
         time_t i_gridExpiry;
 
@@ -450,6 +467,14 @@ class Map : public GridRefManager<NGridType>
 
         WorldObjectSet i_objectsToRemove;
 
+        void ProcessRelocatedUnits();
+        std::vector<ObjectGuid> m_relocatedUnits;
+
+        // ProcessRelocatedUnits scratch, kept to avoid reallocating every update
+        std::vector<ObjectGuid> m_relocationBatch;
+        std::vector<std::pair<uint32, Unit*>> m_relocationCells;
+        std::vector<Camera*> m_relocationCameras;
+
         typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
         ScriptScheduleMap m_scriptSchedule;
 
@@ -168,7 +168,7 @@ void MapPersistentState::AddCreatureToGrid(uint32 guid, CreatureData const* data
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    m_gridObjectGuids[cell_id].creatures.insert(guid);
+    m_gridObjectGuids.creatures.Insert(cell_id, guid);
 }
 
 void MapPersistentState::RemoveCreatureFromGrid(uint32 guid, CreatureData const* data)
@@ -176,7 +176,7 @@ void MapPersistentState::RemoveCreatureFromGrid(uint32 guid, CreatureData const*
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    m_gridObjectGuids[cell_id].creatures.erase(guid);
+    m_gridObjectGuids.creatures.Erase(cell_id, guid);
 }
 
 void MapPersistentState::AddGameobjectToGrid(uint32 guid, GameObjectData const* data)
@@ -184,7 +184,7 @@ void MapPersistentState::AddGameobjectToGrid(uint32 guid, GameObjectData const*
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    m_gridObjectGuids[cell_id].gameobjects.insert(guid);
+    m_gridObjectGuids.gameobjects.Insert(cell_id, guid);
 }
 
 void MapPersistentState::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data)
@@ -192,7 +192,7 @@ void MapPersistentState::RemoveGameobjectFromGrid(uint32 guid, GameObjectData co
     CellPair cell_pair = MaNGOS::ComputeCellPair(data->posX, data->posY);
     uint32 cell_id = (cell_pair.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP) + cell_pair.x_coord;
 
-    m_gridObjectGuids[cell_id].gameobjects.erase(guid);
+    m_gridObjectGuids.gameobjects.Erase(cell_id, guid);
 }
 
 void MapPersistentState::InitPools()
@@ -267,6 +267,7 @@ void DungeonPersistentState::SaveToDB()
         }
     }
 
+    CharacterDatabase.DiscardDelayedUpdate("instance", "id = " + std::to_string(GetInstanceId()));   // instance ids are reused
     CharacterDatabase.PExecute("INSERT INTO instance VALUES ('%u', '%u', '" UI64FMTD "', '%u', '%u', '%s')", GetInstanceId(), GetMapId(), (uint64)GetResetTimeForDB(), GetDifficulty(), GetCompletedEncountersMask(), data.c_str());
 }
 
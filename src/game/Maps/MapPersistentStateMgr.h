@@ -26,6 +26,7 @@
 #include "Server/DBCStores.h"
 #include "Entities/ObjectGuid.h"
 #include "Pools/PoolManager.h"
+#include "Maps/CellGuidIndex.h"
 
 #include <list>
 #include <map>
@@ -42,16 +43,12 @@ class Map;
 
 #define NORMAL_INSTANCE_RESET_TIME 30 * MINUTE
 
-typedef std::set<uint32> CellGuidSet;
-
 struct MapCellObjectGuids
 {
-    CellGuidSet creatures;
-    CellGuidSet gameobjects;
+    CellGuidIndex creatures;
+    CellGuidIndex gameobjects;
 };
 
-typedef std::unordered_map < uint32/*cell_id*/, MapCellObjectGuids > MapCellObjectGuidsMap;
-
 class MapPersistentStateManager;
 
 class MapPersistentState
@@ -110,7 +107,7 @@ class MapPersistentState
         bool IsSpawnedPoolObject(uint32 db_guid_or_pool_id) { return GetSpawnedPoolData().IsSpawnedObject<T>(db_guid_or_pool_id); }
 
         // grid objects (Dynamic map/instance specific added/removed grid spawns from pool system/etc)
-        MapCellObjectGuids const& GetCellObjectGuids(uint32 cell_id) { return m_gridObjectGuids[cell_id]; }
+        MapCellObjectGuids const& GetGridObjectGuids() const { return m_gridObjectGuids; }
         void AddCreatureToGrid(uint32 guid, CreatureData const* data);
         void RemoveCreatureFromGrid(uint32 guid, CreatureData const* data);
         void AddGameobjectToGrid(uint32 guid, GameObjectData const* data);
@@ -137,7 +134,7 @@ class MapPersistentState
         // persistent data
         RespawnTimes m_creatureRespawnTimes;                // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
         RespawnTimes m_goRespawnTimes;                      // lock MapPersistentState from unload, for example for temporary bound dungeon unload delay
-        MapCellObjectGuidsMap m_gridObjectGuids;            // Single map copy specific grid spawn data, like pool spawns
+        MapCellObjectGuids m_gridObjectGuids;               // Single map copy specific grid spawn data, like pool spawns
 
         SpawnedPoolData m_spawnedPoolData;                  // Pools spawns state for map copy
 };
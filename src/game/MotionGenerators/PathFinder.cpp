@@ -92,13 +92,16 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
         return false;
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
-    }, 1000);
+    auto meas = metric::make_slow_duration<std::chrono::microseconds>("pathfinder.calculate", 1000, [this](std::map<std::string, std::string>& tags, std::map<std::string, boost::any>& /*fields*/)
+    {
+        tags = {
+            { "entry", std::to_string(m_sourceUnit->GetEntry()) },
+            { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
+            { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
+            { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
+            { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
+        };
+    });
 #endif
 
     //if (GenericTransport* transport = m_sourceUnit->GetTransport())
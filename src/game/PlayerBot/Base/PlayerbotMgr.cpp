@@ -35,6 +35,7 @@
 #include "../../World/World.h"
 #include "Grids/GridNotifiers.h"
 #include <boost/algorithm/string.hpp>
+#include <chrono>
 #include <mutex>
 
 std::mutex mtx;
@@ -79,6 +80,7 @@ PlayerbotMgr::PlayerbotMgr(Player* const master) : m_master(master), m_masterCha
 		sLog.outError("Playerbot: PlayerbotAI.Collect.DistanceMax higher than allowed. Using 100");
 		m_confCollectDistanceMax = 100;
 	}
+	m_confLuaGCStepKB = botConfig.GetIntDefault("PlayerbotAI.Lua.GCStepKB", 64);
 	m_confCollectDistance = botConfig.GetIntDefault("PlayerbotAI.Collect.Distance", 25);
 	if (m_confCollectDistance > m_confCollectDistanceMax)
 	{
@@ -143,29 +145,6 @@ void PlayerbotMgr::UpdateAI(const uint32 time)
 	if (m_master->GetSession()->PlayerLoading())
 		return;
 
-	std::vector<Player*> bots;
-	bots.reserve(m_playerBots.size());
-
-	for (auto& [id, bot] : m_playerBots)
-		bots.push_back(bot);
-
-	std::vector<Player*> group_members;
-
-	if (const auto group = m_master->GetGroup())
-	{
-		const Group::MemberSlotList& members = group->GetMemberSlots();
-		for (const auto& [guid, name, group_num, assistant, lastMap] : members)
-		{
-			Player* group_member = sObjectMgr.GetPlayer(guid);
-			if (!group_member)
-				continue;
-
-			group_members.push_back(group_member);
-		}
-	}
-
-	m_lua["wow"]["group"] = group_members;	
-
 	const sol::protected_function act_func = m_luaEnvironment["main"];	
 
 	if (!act_func.valid())
@@ -180,25 +159,26 @@ void PlayerbotMgr::UpdateAI(const uint32 time)
 		return;
 	}
 
-	m_lua["wow"]["command_message"] = m_lastManagerMessage;
-	m_lua["wow"]["command_position"] = m_lastCommandPosition;
-	m_lua["wow"]["bots"] = bots;
+	const auto start = std::chrono::steady_clock::now();
 
-	m_lua["wow"]["raid_icons"] = m_luaEnvironment.create();
-	sol::table raid_icons = m_lua["wow"]["raid_icons"];
+	UpdateLuaTables();
 
-	raid_icons["star"] = GetRaidIcon(0);
-	raid_icons["circle"] = GetRaidIcon(1);
-	raid_icons["diamond"] = GetRaidIcon(2);
-	raid_icons["triangle"] = GetRaidIcon(3);
-	raid_icons["moon"] = GetRaidIcon(4);
-	raid_icons["square"] = GetRaidIcon(5);
-	raid_icons["cross"] = GetRaidIcon(6);
-	raid_icons["skull"] = GetRaidIcon(7);
+	const auto act_result = act_func();
 
-	m_lua["zone"] = m_master->GetMap()->GetMapName();
+	if (act_result.valid())
+	{
+		// messages should be cleared after AI has had a chance to process it
+		for (auto& [id, bot] : m_playerBots)
+			bot->GetPlayerbotAI()->ResetLastMessage();
+
+		// reset 'single-use' things
+		if (!m_lastActErrorMsg.empty())
+			m_lastActErrorMsg = "";
 
-	if (const auto act_result = act_func(); !act_result.valid())
+		if (!m_lastCommandPosition.IsEmpty())
+			m_lastCommandPosition = Position();
+	}
+	else
 	{
 		const sol::error error = act_result;
 
@@ -207,22 +187,67 @@ void PlayerbotMgr::UpdateAI(const uint32 time)
 			SendMsg(error_msg, true);
 			m_lastActErrorMsg = error_msg;
 		}
+	}
 
-		return;
+	const auto gc_start = std::chrono::steady_clock::now();
+	StepLuaGC();
+	const auto end = std::chrono::steady_clock::now();
+
+	const uint32 elapsed = uint32(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+	++m_luaStats.updates;
+	m_luaStats.totalTime += elapsed;
+	m_luaStats.gcTime += std::chrono::duration_cast<std::chrono::microseconds>(end - gc_start).count();
+	m_luaStats.lastTime = elapsed;
+	m_luaStats.maxTime = std::max(m_luaStats.maxTime, elapsed);
+}
+
+void PlayerbotMgr::UpdateLuaTables()
+{
+	// the tables may have been replaced or shortened by the script, only the bound ones are refilled
+	m_luaWow["bots"] = m_luaBots;
+	m_luaWow["group"] = m_luaGroup;
+	m_luaWow["raid_icons"] = m_luaRaidIcons;
+
+	size_t count = 0;
+	for (auto& [id, bot] : m_playerBots)
+		m_luaBots[++count] = bot;
+	for (size_t size = m_luaBots.size(); count < size;)
+		m_luaBots[++count] = sol::lua_nil;
+
+	count = 0;
+	if (const auto group = m_master->GetGroup())
+	{
+		const Group::MemberSlotList& members = group->GetMemberSlots();
+		for (const auto& [guid, name, group_num, assistant, lastMap] : members)
+			if (Player* group_member = sObjectMgr.GetPlayer(guid))
+				m_luaGroup[++count] = group_member;
 	}
+	for (size_t size = m_luaGroup.size(); count < size;)
+		m_luaGroup[++count] = sol::lua_nil;
 
-	// messages should be cleared after AI has had a chance to process it
-	for (const auto& bot : bots)
-		bot->GetPlayerbotAI()->ResetLastMessage();
-	
-	// reset 'single-use' things
-	if (!m_lastActErrorMsg.empty())
-		m_lastActErrorMsg = "";
+	m_luaRaidIcons["star"] = GetRaidIcon(0);
+	m_luaRaidIcons["circle"] = GetRaidIcon(1);
+	m_luaRaidIcons["diamond"] = GetRaidIcon(2);
+	m_luaRaidIcons["triangle"] = GetRaidIcon(3);
+	m_luaRaidIcons["moon"] = GetRaidIcon(4);
+	m_luaRaidIcons["square"] = GetRaidIcon(5);
+	m_luaRaidIcons["cross"] = GetRaidIcon(6);
+	m_luaRaidIcons["skull"] = GetRaidIcon(7);
 
-	if (!m_lastCommandPosition.IsEmpty())
-		m_lastCommandPosition = Position();
+	m_luaWow["command_message"] = m_lastManagerMessage;
+	m_luaWow["command_position"] = m_lastCommandPosition;
 
-	m_lua.script("collectgarbage(\"collect\")");
+	m_lua["zone"] = m_master->GetMap()->GetMapName();
+}
+
+// Does a bounded amount of incremental collection work instead of a full collection every update.
+void PlayerbotMgr::StepLuaGC()
+{
+	lua_State* state = m_lua.lua_state();
+	lua_gc(state, LUA_GCSTEP, int(m_confLuaGCStepKB));
+
+	m_luaStats.memoryKB = uint32(lua_gc(state, LUA_GCCOUNT));
+	m_luaStats.peakMemoryKB = std::max(m_luaStats.peakMemoryKB, m_luaStats.memoryKB);
 }
 
 void PlayerbotMgr::InitMqtt()
@@ -268,7 +293,13 @@ void PlayerbotMgr::InitLua()
 		return make_object(m_lua, "Could not locate module  '" + name + "'.");
 	});
 
-	m_lua.create_table("wow");
+	// incremental collection with default pause and step multiplier, stepped once per update
+	lua_gc(m_lua.lua_state(), LUA_GCINC, 0, 0, 0);
+
+	m_luaWow = m_lua.create_table("wow");
+	m_luaBots = m_lua.create_table();
+	m_luaGroup = m_lua.create_table();
+	m_luaRaidIcons = m_lua.create_table();
 
 	InitLuaMembers();
 	InitLuaFunctions();
@@ -3931,10 +3962,21 @@ bool ChatHandler::HandlePlayerbotCommand(char* args)
 			    R"(usage: 
 get token: retrieve or regenerate an AI authorization token
 load: load ai lua script from database
+stats: show lua time and memory used by your bot AI
 use 'lua' or 'legacy': switch between lua or legacy AI
 write <COMMAND>: send a command string to lua)");
 	    }
 
+		// whole word, "write" messages may contain it
+		else if (rem_cmd.substr(0, rem_cmd.find(' ')) == "stats")
+		{
+			const PlayerbotLuaStats& stats = mgr->GetLuaStats();
+			PSendSysMessage("Lua AI updates: %u, average time: %u us, last: %u us, max: %u us",
+				stats.updates, stats.updates ? uint32(stats.totalTime / stats.updates) : 0, stats.lastTime, stats.maxTime);
+			PSendSysMessage("Lua GC time: " UI64FMTD " us of " UI64FMTD " us total, memory: %u KB, peak: %u KB",
+				stats.gcTime, stats.totalTime, stats.memoryKB, stats.peakMemoryKB);
+		}
+
 		else if (rem_cmd.find("get token") != std::string::npos)
 		{
 			if (const QueryResult* token_result = CharacterDatabase.PQuery(
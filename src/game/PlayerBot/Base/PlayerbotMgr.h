@@ -122,6 +122,18 @@ private:
 
 using PlayerbotMovementPolicyMap = std::unordered_map<ObjectGuid, PlayerbotMovementPolicy*>;
 
+// Lua cost of a master's bot AI, times in microseconds
+struct PlayerbotLuaStats
+{
+	uint32 updates = 0;
+	uint64 totalTime = 0;
+	uint64 gcTime = 0;
+	uint32 lastTime = 0;
+	uint32 maxTime = 0;
+	uint32 memoryKB = 0;
+	uint32 peakMemoryKB = 0;
+};
+
 class PlayerbotMgr
 {
 	// static functions, available without a PlayerbotMgr instance
@@ -154,6 +166,9 @@ public:
 	void InitLuaItemType();
 
 	Unit* GetRaidIcon(uint8 iconIndex) const;
+	void UpdateLuaTables();
+	void StepLuaGC();
+	PlayerbotLuaStats const& GetLuaStats() const { return m_luaStats; }
 	void FlipLuaTable(const std::string& name);
 	void SendMsg(const std::string& msg, bool isError = false, bool sendLog = true, bool sendSysMessage = true);
 	SpellCastResult Cast(Player* bot, Unit* target, uint32 spellId, bool checkIsAlive = true,
@@ -218,6 +233,7 @@ public:
 	bool m_confCollectObjects;
 	uint32 m_confCollectDistance;
 	uint32 m_confCollectDistanceMax;
+	uint32 m_confLuaGCStepKB;
 
 private:
 	Player* const m_master;
@@ -227,6 +243,11 @@ private:
 	// lua VM for the bot
 	sol::state m_lua;
 	sol::environment m_luaEnvironment;
+	sol::table m_luaWow;                    // wow.bots, wow.group and wow.raid_icons are bound once and updated in place
+	sol::table m_luaBots;
+	sol::table m_luaGroup;
+	sol::table m_luaRaidIcons;
+	PlayerbotLuaStats m_luaStats;
 	std::string m_lastActErrorMsg;
 	std::string m_lastManagerMessage;
 	bool m_hasLoadedScript;
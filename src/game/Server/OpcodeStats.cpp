@@ -0,0 +1,331 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/OpcodeStats.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Metric.h"
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+static thread_local uint16 t_currentOpcode = NUM_MSG_TYPES;
+static thread_local bool t_currentSkipped = false;
+
+// counters of one thread, only written by it except for the interval maxima taken by the metrics.
+// Reset is applied by the owner once it sees the new generation.
+struct OpcodeStatsThreadCounters
+{
+    struct OpcodeCounters
+    {
+        std::atomic<uint64> calls;
+        std::atomic<uint64> totalTime;
+        std::atomic<uint64> maxTime;
+        std::atomic<uint64> intervalMaxTime;
+        std::atomic<uint64> bytesIn;
+        std::atomic<uint64> bytesOut;
+    };
+
+    OpcodeStatsThreadCounters() : generation(0) { Clear(); }
+
+    void Clear()
+    {
+        for (auto& opcode : counters)
+        {
+            for (OpcodeCounters& role : opcode)
+            {
+                role.calls.store(0, std::memory_order_relaxed);
+                role.totalTime.store(0, std::memory_order_relaxed);
+                role.maxTime.store(0, std::memory_order_relaxed);
+                role.intervalMaxTime.store(0, std::memory_order_relaxed);
+                role.bytesIn.store(0, std::memory_order_relaxed);
+                role.bytesOut.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // single writer, a plain load and store instead of a locked add
+    static void Add(std::atomic<uint64>& counter, uint64 value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32> generation;
+    OpcodeCounters counters[NUM_MSG_TYPES][MAX_SQL_THREAD_ROLE];
+};
+
+// per thread handle, hands the counters over to the retired totals when the thread exits
+struct OpcodeStatsThreadHandle
+{
+    ~OpcodeStatsThreadHandle()
+    {
+        if (counters)
+            sOpcodeStats.RetireThreadCounters(counters);
+    }
+
+    std::shared_ptr<OpcodeStatsThreadCounters> counters;
+};
+
+static thread_local OpcodeStatsThreadHandle t_opcodeStatsCounters;
+
+
+uint64 OpcodeStat::GetCalls() const
+{
+    uint64 total = 0;
+    for (uint64 count : calls)
+        total += count;
+    return total;
+}
+
+uint64 OpcodeStat::GetTotalTime() const
+{
+    uint64 total = 0;
+    for (uint64 time : totalTime)
+        total += time;
+    return total;
+}
+
+OpcodeStats& OpcodeStats::Instance()
+{
+    // never destroyed, sessions still send packets while the other singletons shut down
+    static OpcodeStats* instance = new OpcodeStats();
+    return *instance;
+}
+
+OpcodeStats::OpcodeStats() : m_retired(NUM_MSG_TYPES * MAX_SQL_THREAD_ROLE), m_generation(1)
+{
+#ifdef BUILD_METRICS
+    memset(m_reported, 0, sizeof(m_reported));
+#endif
+}
+
+OpcodeStatsThreadCounters& OpcodeStats::GetThreadCounters()
+{
+    if (!t_opcodeStatsCounters.counters)
+    {
+        t_opcodeStatsCounters.counters = std::make_shared<OpcodeStatsThreadCounters>();
+
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        t_opcodeStatsCounters.counters->generation.store(m_generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_threads.push_back(t_opcodeStatsCounters.counters);
+    }
+
+    OpcodeStatsThreadCounters& counters = *t_opcodeStatsCounters.counters;
+    uint32 const generation = m_generation.load(std::memory_order_acquire);
+    if (counters.generation.load(std::memory_order_relaxed) != generation)
+    {
+        counters.Clear();
+        counters.generation.store(generation, std::memory_order_release);
+    }
+    return counters;
+}
+
+void OpcodeStats::RetireThreadCounters(std::shared_ptr<OpcodeStatsThreadCounters> const& counters)
+{
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), counters), m_threads.end());
+
+    if (counters->generation.load(std::memory_order_acquire) != m_generation.load(std::memory_order_relaxed))
+        return;
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        for (uint32 role = 0; role < MAX_SQL_THREAD_ROLE; ++role)
+        {
+            OpcodeStatsThreadCounters::OpcodeCounters& source = counters->counters[opcode][role];
+            OpcodeTotals& retired = m_retired[opcode * MAX_SQL_THREAD_ROLE + role];
+            retired.calls += source.calls.load(std::memory_order_relaxed);
+            retired.totalTime += source.totalTime.load(std::memory_order_relaxed);
+            retired.maxTime = std::max(retired.maxTime, source.maxTime.load(std::memory_order_relaxed));
+            retired.intervalMaxTime = std::max(retired.intervalMaxTime, source.intervalMaxTime.exchange(0, std::memory_order_relaxed));
+            retired.bytesIn += source.bytesIn.load(std::memory_order_relaxed);
+            retired.bytesOut += source.bytesOut.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void OpcodeStats::RecordHandler(uint16 opcode, size_t size, uint64 time)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeStatsThreadCounters::OpcodeCounters& counters = GetThreadCounters().counters[opcode][GetSqlThreadRole()];
+    OpcodeStatsThreadCounters::Add(counters.calls, 1);
+    OpcodeStatsThreadCounters::Add(counters.totalTime, time);
+    OpcodeStatsThreadCounters::Add(counters.bytesIn, size);
+
+    if (time > counters.maxTime.load(std::memory_order_relaxed))
+        counters.maxTime.store(time, std::memory_order_relaxed);
+
+    // the metrics take the interval maximum from another thread
+    uint64 maxTime = counters.intervalMaxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !counters.intervalMaxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed)) {}
+}
+
+void OpcodeStats::RecordSent(uint16 opcode, size_t size)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeStatsThreadCounters::Add(GetThreadCounters().counters[opcode][GetSqlThreadRole()].bytesOut, size);
+}
+
+void OpcodeStats::Merge(std::vector<OpcodeTotals>& totals, bool takeIntervalMax)
+{
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    totals = m_retired;
+    if (takeIntervalMax)
+        for (OpcodeTotals& retired : m_retired)
+            retired.intervalMaxTime = 0;
+
+    uint32 const generation = m_generation.load(std::memory_order_relaxed);
+    for (auto const& thread : m_threads)
+    {
+        if (thread->generation.load(std::memory_order_acquire) != generation)
+            continue;
+
+        for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+        {
+            for (uint32 role = 0; role < MAX_SQL_THREAD_ROLE; ++role)
+            {
+                OpcodeStatsThreadCounters::OpcodeCounters& counters = thread->counters[opcode][role];
+                uint64 const calls = counters.calls.load(std::memory_order_relaxed);
+                if (!calls)
+                    continue;
+
+                OpcodeTotals& total = totals[opcode * MAX_SQL_THREAD_ROLE + role];
+                total.calls += calls;
+                total.totalTime += counters.totalTime.load(std::memory_order_relaxed);
+                total.maxTime = std::max(total.maxTime, counters.maxTime.load(std::memory_order_relaxed));
+                total.bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+                total.bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+                if (takeIntervalMax)
+                    total.intervalMaxTime = std::max(total.intervalMaxTime, counters.intervalMaxTime.exchange(0, std::memory_order_relaxed));
+            }
+        }
+    }
+}
+
+void OpcodeStats::GetTopOpcodes(std::vector<OpcodeStat>& stats, uint32 count, bool byBytesOut)
+{
+    std::vector<OpcodeTotals> totals;
+    Merge(totals, false);
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        OpcodeStat stat;
+        stat.opcode = opcode;
+        for (uint32 role = 0; role < MAX_SQL_THREAD_ROLE; ++role)
+        {
+            OpcodeTotals const& total = totals[opcode * MAX_SQL_THREAD_ROLE + role];
+            stat.calls[role] = total.calls;
+            stat.totalTime[role] = total.totalTime;
+            stat.maxTime[role] = total.maxTime;
+            stat.bytesIn += total.bytesIn;
+            stat.bytesOut += total.bytesOut;
+        }
+
+        if (stat.GetCalls())
+            stats.push_back(stat);
+    }
+
+    if (byBytesOut)
+        std::sort(stats.begin(), stats.end(), [](OpcodeStat const& a, OpcodeStat const& b) { return a.bytesOut > b.bytesOut; });
+    else
+        std::sort(stats.begin(), stats.end(), [](OpcodeStat const& a, OpcodeStat const& b) { return a.GetTotalTime() > b.GetTotalTime(); });
+
+    if (stats.size() > count)
+        stats.resize(count);
+}
+
+void OpcodeStats::Reset()
+{
+    // thread counters are cleared by their owners
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    m_generation.fetch_add(1, std::memory_order_release);
+    for (OpcodeTotals& retired : m_retired)
+        retired = OpcodeTotals();
+
+#ifdef BUILD_METRICS
+    memset(m_reported, 0, sizeof(m_reported));
+#endif
+}
+
+#ifdef BUILD_METRICS
+void OpcodeStats::GenerateMetrics()
+{
+    // a reset in between restarts the counters, the current values are the delta then
+    auto delta = [](uint64 current, uint64 reported) { return current >= reported ? current - reported : current; };
+
+    std::vector<OpcodeTotals> totals;
+    Merge(totals, true);
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        for (uint32 role = SQL_THREAD_OTHER; role < MAX_SQL_THREAD_ROLE; ++role)
+        {
+            OpcodeTotals const& total = totals[opcode * MAX_SQL_THREAD_ROLE + role];
+            ReportedCounters& reported = m_reported[opcode][role];
+            if (total.calls == reported.calls)
+                continue;
+
+            metric::measurement meas("world.metrics.opcodes", { { "opcode", opcodeTable[opcode].name }, { "thread", GetSqlThreadRoleName(SqlThreadRole(role)) } });
+            meas.add_field("count", std::to_string(delta(total.calls, reported.calls)));
+            meas.add_field("time", std::to_string(delta(total.totalTime, reported.totalTime)));
+            meas.add_field("max_time", std::to_string(total.intervalMaxTime));
+            meas.add_field("bytes_in", std::to_string(delta(total.bytesIn, reported.bytesIn)));
+            meas.add_field("bytes_out", std::to_string(delta(total.bytesOut, reported.bytesOut)));
+
+            reported.calls = total.calls;
+            reported.totalTime = total.totalTime;
+            reported.bytesIn = total.bytesIn;
+            reported.bytesOut = total.bytesOut;
+        }
+    }
+}
+#endif
+
+OpcodeStatsScope::OpcodeStatsScope(uint16 opcode, size_t size) : m_opcode(opcode), m_size(size), m_previous(t_currentOpcode),
+    m_previousSkipped(t_currentSkipped), m_start(std::chrono::steady_clock::now())
+{
+    t_currentOpcode = opcode;
+    t_currentSkipped = false;
+}
+
+OpcodeStatsScope::~OpcodeStatsScope()
+{
+    if (!t_currentSkipped)
+    {
+        uint64 const time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+        sOpcodeStats.RecordHandler(m_opcode, m_size, time);
+    }
+
+    t_currentOpcode = m_previous;
+    t_currentSkipped = m_previousSkipped;
+}
+
+uint16 OpcodeStatsScope::GetCurrentOpcode()
+{
+    return t_currentOpcode;
+}
+
+void OpcodeStatsScope::SkipCurrent()
+{
+    t_currentSkipped = true;
+}
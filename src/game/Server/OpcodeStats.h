@@ -0,0 +1,135 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODE_STATS_H
+#define MANGOS_OPCODE_STATS_H
+
+#include "Common.h"
+#include "Server/Opcodes.h"
+#include "Database/SqlQueryStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// one opcode, split by the role of the thread that ran its handler
+struct OpcodeStat
+{
+    uint32 opcode = 0;
+    uint64 calls[MAX_SQL_THREAD_ROLE] = {};
+    uint64 totalTime[MAX_SQL_THREAD_ROLE] = {};             // microseconds
+    uint64 maxTime[MAX_SQL_THREAD_ROLE] = {};               // microseconds
+    uint64 bytesIn = 0;                                     // size of the handled packets
+    uint64 bytesOut = 0;                                    // size of the packets sent while the handler ran
+
+    uint64 GetCalls() const;
+    uint64 GetTotalTime() const;
+};
+
+struct OpcodeStatsThreadCounters;
+
+/**
+ * Always on handler accounting. Every handled client packet adds its handling time and size to its
+ * opcode, under the role of the thread running the handler (world, map or network), and every packet
+ * a session sends while a handler runs on the same thread adds to the bytes out of that handler.
+ * Every thread counts into its own block, blocks are merged when the statistics are listed or reported.
+ */
+class OpcodeStats
+{
+        friend struct OpcodeStatsThreadHandle;
+
+    public:
+        static OpcodeStats& Instance();
+
+        void RecordHandler(uint16 opcode, size_t size, uint64 time);
+        void RecordSent(uint16 opcode, size_t size);
+
+        // opcodes ordered by total handler time, or by bytes sent, at most 'count'
+        void GetTopOpcodes(std::vector<OpcodeStat>& stats, uint32 count, bool byBytesOut);
+        void Reset();
+
+#ifdef BUILD_METRICS
+        // world thread, one measurement per opcode and thread role active since the last call
+        void GenerateMetrics();
+#endif
+
+    private:
+        OpcodeStats();
+
+        // merged counters of one opcode and thread role
+        struct OpcodeTotals
+        {
+            uint64 calls;
+            uint64 totalTime;
+            uint64 maxTime;
+            uint64 intervalMaxTime;                         // since the last metrics
+            uint64 bytesIn;
+            uint64 bytesOut;
+        };
+
+        OpcodeStatsThreadCounters& GetThreadCounters();
+        void RetireThreadCounters(std::shared_ptr<OpcodeStatsThreadCounters> const& counters);
+        // sums all blocks into 'totals' (NUM_MSG_TYPES * MAX_SQL_THREAD_ROLE), takes the interval maxima when asked
+        void Merge(std::vector<OpcodeTotals>& totals, bool takeIntervalMax);
+
+        std::mutex m_threadsLock;                           // guards the lists of blocks, not their counters
+        std::vector<std::shared_ptr<OpcodeStatsThreadCounters> > m_threads;
+        std::vector<OpcodeTotals> m_retired;                // counters of exited threads
+        std::atomic<uint32> m_generation;                   // bumped by Reset, blocks of an older one count as empty
+
+#ifdef BUILD_METRICS
+        struct ReportedCounters
+        {
+            uint64 calls;
+            uint64 totalTime;
+            uint64 bytesIn;
+            uint64 bytesOut;
+        };
+
+        ReportedCounters m_reported[NUM_MSG_TYPES][MAX_SQL_THREAD_ROLE];
+#endif
+};
+
+#define sOpcodeStats OpcodeStats::Instance()
+
+// times the handler of a packet, packets sent in its lifetime count as the output of the handler
+class OpcodeStatsScope
+{
+    public:
+        OpcodeStatsScope(uint16 opcode, size_t size);
+        ~OpcodeStatsScope();
+
+        OpcodeStatsScope(OpcodeStatsScope const&) = delete;
+        OpcodeStatsScope& operator=(OpcodeStatsScope const&) = delete;
+
+        // opcode of the handler running on this thread, NUM_MSG_TYPES when none
+        static uint16 GetCurrentOpcode();
+        // the handler running on this thread put its packet back to be handled again, it is counted then
+        static void SkipCurrent();
+
+    private:
+        uint16 m_opcode;
+        size_t m_size;
+        uint16 m_previous;
+        bool m_previousSkipped;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
@@ -17,6 +17,8 @@
 
 #include "PacketLog.h"
 #include "Timer.h"
+#include "Log.h"
+#include "Util.h"
 #include "WorldPacket.h"
 #include "Config/Config.h"
 #include "Globals/SharedDefines.h"
@@ -57,13 +59,106 @@ struct PacketHeader
 
 #pragma pack(pop)
 
-PacketLog::PacketLog() : _file(nullptr)
+#define PACKET_LOG_WRITE_INTERVAL   100                     // milliseconds between two writes to the file
+#define PACKET_LOG_DROP_REPORT_TIME (10 * IN_MILLISECONDS)  // at most one drop warning in this time
+
+// single producer (the logging thread), single consumer (the writer), holds whole PKT records
+class PacketLogBuffer
+{
+    public:
+        explicit PacketLogBuffer(uint32 size) : _data(size), _head(0), _tail(0), _logged(0), _dropped(0), _droppedBytes(0) {}
+
+        bool Write(PacketHeader const& header, uint8 const* payload, size_t size)
+        {
+            uint64 const length = sizeof(header) + size;
+            uint64 const head = _head.load(std::memory_order_relaxed);
+            if (head + length - _tail.load(std::memory_order_acquire) > _data.size())
+            {
+                _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                _droppedBytes.store(_droppedBytes.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+                return false;
+            }
+
+            Copy(head, reinterpret_cast<uint8 const*>(&header), sizeof(header));
+            Copy(head + sizeof(header), payload, size);
+            _head.store(head + length, std::memory_order_release);
+            _logged.store(_logged.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // file may be null, the records are discarded then
+        void Read(FILE* file)
+        {
+            uint64 const tail = _tail.load(std::memory_order_relaxed);
+            uint64 const head = _head.load(std::memory_order_acquire);
+            if (head == tail)
+                return;
+
+            if (file)
+            {
+                size_t const offset = tail % _data.size();
+                size_t const length = head - tail;
+                size_t const first = std::min(length, _data.size() - offset);
+                fwrite(&_data[offset], 1, first, file);
+                if (first < length)
+                    fwrite(&_data[0], 1, length - first, file);
+            }
+
+            _tail.store(head, std::memory_order_release);
+        }
+
+        uint64 GetLogged() const { return _logged.load(std::memory_order_relaxed); }
+        uint64 GetDropped() const { return _dropped.load(std::memory_order_relaxed); }
+        uint64 GetDroppedBytes() const { return _droppedBytes.load(std::memory_order_relaxed); }
+
+    private:
+        void Copy(uint64 position, uint8 const* source, size_t size)
+        {
+            if (!size)
+                return;
+
+            size_t const offset = position % _data.size();
+            size_t const first = std::min(size, _data.size() - offset);
+            memcpy(&_data[offset], source, first);
+            if (first < size)
+                memcpy(&_data[0], source + first, size - first);
+        }
+
+        std::vector<uint8> _data;
+        std::atomic<uint64> _head;                          // bytes ever written
+        std::atomic<uint64> _tail;                          // bytes ever read
+        std::atomic<uint64> _logged;
+        std::atomic<uint64> _dropped;
+        std::atomic<uint64> _droppedBytes;
+};
+
+static thread_local PacketLogBuffer* t_packetLogBuffer = nullptr;
+
+
+PacketLog::PacketLog() : _file(nullptr), _enabled(false), _bufferSize(0), _writerStop(false), _accountCount(0), _opcodeFilter(false),
+    _reportedDrops(0), _lastDropReport(0)
 {
+    for (std::atomic<uint32>& account : _accounts)
+        account = 0;
+    for (std::atomic<bool>& opcode : _opcodes)
+        opcode = false;
+
+#ifdef BUILD_METRICS
+    _loggedMetric = metric::counter("packetlog.packets", { { "result", "logged" } });
+    _droppedMetric = metric::counter("packetlog.packets", { { "result", "dropped" } });
+#endif
+
     std::call_once(_initializeFlag, &PacketLog::Initialize, this);
 }
 
 PacketLog::~PacketLog()
 {
+    StopWriter();
+
+    std::lock_guard<std::mutex> lock(_logPacketLock);
+    _enabled = false;
+    Drain();
+
     if (_file)
         fclose(_file);
 
@@ -85,41 +180,123 @@ void PacketLog::Initialize()
         if ((logsDir.at(logsDir.length() - 1) != '/') && (logsDir.at(logsDir.length() - 1) != '\\'))
             logsDir.push_back('/');
 
+    LoadFilters();
+    _bufferSize = std::max(sConfig.GetIntDefault("PacketLogBufferSize", 1024), 16) * 1024;
+
     std::string logname = sConfig.GetStringDefault("PacketLogFile", "");
     if (!logname.empty())
     {
-        _file = fopen((logsDir + logname).c_str(), "wb");
-
-        LogHeader header;
-        header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
-        header.FormatVersion = 0x0301;
-        header.SnifferId = 'T';
-        header.Build = buildVersion[0];
-        header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
-        std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
-        header.SniffStartUnixtime = time(nullptr);
-        header.SniffStartTicks = WorldTimer::getMSTime();
-        header.OptionalDataSize = 0;
-
-        if (CanLogPacket())
+        {
+            std::lock_guard<std::mutex> lock(_logPacketLock);
+            _file = fopen((logsDir + logname).c_str(), "wb");
+            if (!_file)
+                return;
+
+            LogHeader header;
+            header.Signature[0] = 'P'; header.Signature[1] = 'K'; header.Signature[2] = 'T';
+            header.FormatVersion = 0x0301;
+            header.SnifferId = 'T';
+            header.Build = buildVersion[0];
+            header.Locale[0] = 'e'; header.Locale[1] = 'n'; header.Locale[2] = 'U'; header.Locale[3] = 'S';
+            std::memset(header.SessionKey, 0, sizeof(header.SessionKey));
+            header.SniffStartUnixtime = time(nullptr);
+            header.SniffStartTicks = WorldTimer::getMSTime();
+            header.OptionalDataSize = 0;
+
             fwrite(&header, sizeof(header), 1, _file);
+            fflush(_file);
+            _enabled = true;
+        }
+
+        StartWriter();
     }
 }
 
 void PacketLog::Reinitialize()
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
-    if (CanLogPacket())
+    StopWriter();
     {
-        fclose(_file);
-        _file = nullptr;
+        std::lock_guard<std::mutex> lock(_logPacketLock);
+        _enabled = false;
+        Drain();
+
+        if (_file)
+        {
+            fclose(_file);
+            _file = nullptr;
+        }
     }
     Initialize();
 }
 
+void PacketLog::LoadFilters()
+{
+    uint32 count = 0;
+    for (std::string const& token : StrSplit(sConfig.GetStringDefault("PacketLogAccounts", ""), ","))
+    {
+        uint32 accountId = uint32(strtoul(token.c_str(), nullptr, 10));
+        if (!accountId)
+            continue;
+
+        if (count >= MAX_PACKET_LOG_ACCOUNTS)
+        {
+            sLog.outError("PacketLogAccounts lists more than %u accounts, the others are ignored.", MAX_PACKET_LOG_ACCOUNTS);
+            break;
+        }
+
+        _accounts[count++] = accountId;
+    }
+    _accountCount = count;
+
+    // filter is switched off while the opcodes change, it logs too much rather than too little
+    _opcodeFilter = false;
+    for (std::atomic<bool>& opcode : _opcodes)
+        opcode = false;
+
+    bool filter = false;
+    for (std::string const& token : StrSplit(sConfig.GetStringDefault("PacketLogOpcodes", ""), ","))
+    {
+        char* end = nullptr;
+        unsigned long opcode = strtoul(token.c_str(), &end, 0);
+        if (end == token.c_str() || opcode >= MAX_PACKET_LOG_OPCODES)
+        {
+            sLog.outError("PacketLogOpcodes has invalid opcode '%s', ignored.", token.c_str());
+            continue;
+        }
+
+        _opcodes[opcode] = true;
+        filter = true;
+    }
+    _opcodeFilter = filter;
+}
+
+bool PacketLog::IsLoggedAccount(uint32 accountId) const
+{
+    uint32 const count = _accountCount;
+    for (uint32 i = 0; i < count; ++i)
+        if (_accounts[i] == accountId)
+            return true;
+
+    return false;
+}
+
+PacketLogBuffer* PacketLog::GetThreadBuffer()
+{
+    if (!t_packetLogBuffer)
+    {
+        std::lock_guard<std::mutex> lock(_buffersLock);
+        _buffers.emplace_back(new PacketLogBuffer(_bufferSize));
+        t_packetLogBuffer = _buffers.back().get();
+    }
+
+    return t_packetLogBuffer;
+}
+
 void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
+    uint32 const opcode = packet.GetOpcode();
+    if (_opcodeFilter && (opcode >= MAX_PACKET_LOG_OPCODES || !_opcodes[opcode]))
+        return;
 
     PacketHeader header;
     header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
@@ -141,11 +318,121 @@ void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost:
 
     header.OptionalData.SocketPort = port;
     header.Length = packet.size() + sizeof(header.Opcode);
-    header.Opcode = packet.GetOpcode();
+    header.Opcode = opcode;
+
+    if (GetThreadBuffer()->Write(header, packet.empty() ? nullptr : packet.contents(), packet.size()))
+    {
+#ifdef BUILD_METRICS
+        _loggedMetric.add();
+#endif
+    }
+    else
+    {
+#ifdef BUILD_METRICS
+        _droppedMetric.add();
+#endif
+    }
+}
+
+void PacketLog::StartWriter()
+{
+    std::lock_guard<std::mutex> lock(_writerLock);
+    if (_writer.joinable())
+        return;
+
+    _writerStop = false;
+    _writer = std::thread(&PacketLog::WriterThread, this);
+}
+
+void PacketLog::StopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_writerLock);
+        if (!_writer.joinable())
+            return;
+
+        _writerStop = true;
+    }
 
-    fwrite(&header, sizeof(header), 1, _file);
-    if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+    _writerWakeup.notify_one();
+    _writer.join();
+}
+
+void PacketLog::WriterThread()
+{
+    std::unique_lock<std::mutex> lock(_writerLock);
+    while (!_writerStop)
+    {
+        _writerWakeup.wait_for(lock, std::chrono::milliseconds(PACKET_LOG_WRITE_INTERVAL));
+        lock.unlock();
+
+        {
+            std::lock_guard<std::mutex> fileLock(_logPacketLock);
+            Drain();
+        }
+        ReportDrops();
 
-    fflush(_file);
+        lock.lock();
+    }
+}
+
+void PacketLog::Drain()
+{
+    // buffers are never removed, threads creating their buffer must not wait for the disk
+    {
+        std::lock_guard<std::mutex> lock(_buffersLock);
+        _drainBuffers.clear();
+        for (auto const& buffer : _buffers)
+            _drainBuffers.push_back(buffer.get());
+    }
+
+    for (PacketLogBuffer* buffer : _drainBuffers)
+        buffer->Read(_file);
+
+    if (_file)
+        fflush(_file);
+}
+
+void PacketLog::ReportDrops()
+{
+    uint64 const dropped = GetDroppedCount();
+    if (dropped == _reportedDrops)
+        return;
+
+    uint32 const now = WorldTimer::getMSTime();
+    if (_lastDropReport && WorldTimer::getMSTimeDiff(_lastDropReport, now) < PACKET_LOG_DROP_REPORT_TIME)
+        return;
+
+    sLog.outError("PacketLog: " UI64FMTD " packets dropped since the last report, " UI64FMTD " in total (" UI64FMTD " bytes). Increase PacketLogBufferSize or narrow the filters.",
+                  dropped - _reportedDrops, dropped, GetDroppedBytes());
+
+    _reportedDrops = dropped;
+    _lastDropReport = now;
+}
+
+uint64 PacketLog::GetLoggedCount() const
+{
+    uint64 count = 0;
+    std::lock_guard<std::mutex> lock(_buffersLock);
+    for (auto const& buffer : _buffers)
+        count += buffer->GetLogged();
+    return count;
+}
+
+uint64 PacketLog::GetDroppedCount() const
+{
+    uint64 count = 0;
+    std::lock_guard<std::mutex> lock(_buffersLock);
+    for (auto const& buffer : _buffers)
+        count += buffer->GetDropped();
+    return count;
+}
+
+uint64 PacketLog::GetDroppedBytes() const
+{
+    uint64 count = 0;
+    std::lock_guard<std::mutex> lock(_buffersLock);
+    for (auto const& buffer : _buffers)
+        count += buffer->GetDroppedBytes();
+    return count;
 }
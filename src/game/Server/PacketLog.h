@@ -20,8 +20,17 @@
 
 #include "Common.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
 #include <boost/asio/ip/address.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 enum Direction
 {
@@ -29,14 +38,24 @@ enum Direction
     SERVER_TO_CLIENT
 };
 
+#define MAX_PACKET_LOG_ACCOUNTS     32
+#define MAX_PACKET_LOG_OPCODES      0x424                   // NUM_MSG_TYPES
+
 class WorldPacket;
+class PacketLogBuffer;
 
+/**
+ * Packets are copied into a ring buffer owned by the logging thread and written to the PKT file by
+ * a background writer, so network and map threads never wait on each other or on the disk. A packet
+ * that does not fit into the buffer of its thread is dropped and counted. Records of one thread keep
+ * their order, records of different threads are ordered by their ArrivalTicks only.
+ */
 class PacketLog
 {
     private:
         PacketLog();
         ~PacketLog();
-        std::mutex _logPacketLock;
+        std::mutex _logPacketLock;                          // file and writer thread
         std::once_flag _initializeFlag;
 
     public:
@@ -44,11 +63,50 @@ class PacketLog
 
         void Initialize();
         void Reinitialize();
-        bool CanLogPacket() const { return (_file != nullptr); }
+        bool CanLogPacket() const { return _enabled; }
         void LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port);
 
+        // sessions of these accounts are logged without .debug packetlog
+        bool IsLoggedAccount(uint32 accountId) const;
+
+        uint64 GetLoggedCount() const;
+        uint64 GetDroppedCount() const;
+        uint64 GetDroppedBytes() const;
+
     private:
+        PacketLogBuffer* GetThreadBuffer();
+        void LoadFilters();
+        void StartWriter();
+        void StopWriter();
+        void WriterThread();
+        void Drain();                                       // _logPacketLock must be held
+        void ReportDrops();
+
         FILE* _file;
+        std::atomic<bool> _enabled;
+
+        uint32 _bufferSize;                                 // bytes per logging thread
+        mutable std::mutex _buffersLock;
+        std::vector<std::unique_ptr<PacketLogBuffer>> _buffers;
+        std::vector<PacketLogBuffer*> _drainBuffers;        // Drain scratch, guarded by _logPacketLock
+
+        std::thread _writer;
+        std::mutex _writerLock;
+        std::condition_variable _writerWakeup;
+        bool _writerStop;
+
+        std::atomic<uint32> _accounts[MAX_PACKET_LOG_ACCOUNTS];
+        std::atomic<uint32> _accountCount;
+        std::atomic<bool> _opcodes[MAX_PACKET_LOG_OPCODES];
+        std::atomic<bool> _opcodeFilter;                    // only opcodes set in _opcodes are logged
+
+        uint64 _reportedDrops;
+        uint32 _lastDropReport;
+
+#ifdef BUILD_METRICS
+        metric::counter _loggedMetric;
+        metric::counter _droppedMetric;
+#endif
 };
 
 #define sPacketLog PacketLog::instance()
@@ -0,0 +1,251 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/PacketSizeStats.h"
+
+#include <algorithm>
+
+// counters of one thread, only written by it. Reset is applied by the owner once it sees the new generation.
+struct PacketSizeThreadCounters
+{
+    struct OpcodeSizes
+    {
+        std::atomic<uint64> count;
+        std::atomic<uint64> totalSize;
+        std::atomic<uint64> maxSize;
+        std::atomic<uint64> buckets[PACKET_SIZE_BUCKETS];
+        std::atomic<uint64> reallocations;
+        std::atomic<uint64> avoided;
+    };
+
+    PacketSizeThreadCounters() : generation(0) { Clear(); }
+
+    void Clear()
+    {
+        for (OpcodeSizes& sizes : opcodes)
+        {
+            sizes.count.store(0, std::memory_order_relaxed);
+            sizes.totalSize.store(0, std::memory_order_relaxed);
+            sizes.maxSize.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64>& bucket : sizes.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            sizes.reallocations.store(0, std::memory_order_relaxed);
+            sizes.avoided.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // single writer, a plain load and store instead of a locked add
+    static void Add(std::atomic<uint64>& counter, uint64 value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32> generation;
+    OpcodeSizes opcodes[NUM_MSG_TYPES];
+};
+
+// per thread handle, hands the counters over to the retired totals when the thread exits
+struct PacketSizeThreadHandle
+{
+    ~PacketSizeThreadHandle()
+    {
+        if (counters)
+            sPacketSizeStats.RetireThreadCounters(counters);
+    }
+
+    std::shared_ptr<PacketSizeThreadCounters> counters;
+};
+
+static thread_local PacketSizeThreadHandle t_packetSizeCounters;
+
+PacketSizeStats& PacketSizeStats::Instance()
+{
+    // never destroyed, packets held by other singletons are still destroyed after it at shutdown
+    static PacketSizeStats* instance = new PacketSizeStats();
+    return *instance;
+}
+
+PacketSizeStats::PacketSizeStats() : m_hintsEnabled(true), m_retired(NUM_MSG_TYPES), m_generation(1)
+{
+    for (std::atomic<uint32>& hint : m_hints)
+        hint.store(0, std::memory_order_relaxed);
+}
+
+uint32 PacketSizeStats::GetBucket(size_t size)
+{
+    uint32 bucket = 0;
+    for (size_t limit = PACKET_SIZE_MIN_BUCKET; size > limit && bucket < PACKET_SIZE_BUCKETS - 1; limit <<= 1)
+        ++bucket;
+    return bucket;
+}
+
+uint32 PacketSizeStats::CountReallocations(size_t reserved, size_t size)
+{
+    // std::vector at least doubles its capacity when it grows
+    uint32 count = 0;
+    for (size_t capacity = reserved; capacity < size; capacity = std::max(capacity * 2, size_t(1)))
+        ++count;
+    return count;
+}
+
+PacketSizeThreadCounters& PacketSizeStats::GetThreadCounters()
+{
+    if (!t_packetSizeCounters.counters)
+    {
+        t_packetSizeCounters.counters = std::make_shared<PacketSizeThreadCounters>();
+
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        t_packetSizeCounters.counters->generation.store(m_generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_threads.push_back(t_packetSizeCounters.counters);
+    }
+
+    PacketSizeThreadCounters& counters = *t_packetSizeCounters.counters;
+    uint32 const generation = m_generation.load(std::memory_order_acquire);
+    if (counters.generation.load(std::memory_order_relaxed) != generation)
+    {
+        counters.Clear();
+        counters.generation.store(generation, std::memory_order_release);
+    }
+    return counters;
+}
+
+void PacketSizeStats::RetireThreadCounters(std::shared_ptr<PacketSizeThreadCounters> const& counters)
+{
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), counters), m_threads.end());
+
+    if (counters->generation.load(std::memory_order_acquire) != m_generation.load(std::memory_order_relaxed))
+        return;
+
+    for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+    {
+        PacketSizeThreadCounters::OpcodeSizes const& sizes = counters->opcodes[opcode];
+        PacketSizeStat& retired = m_retired[opcode];
+        retired.count += sizes.count.load(std::memory_order_relaxed);
+        retired.totalSize += sizes.totalSize.load(std::memory_order_relaxed);
+        retired.maxSize = std::max(retired.maxSize, uint32(sizes.maxSize.load(std::memory_order_relaxed)));
+        for (uint32 i = 0; i < PACKET_SIZE_BUCKETS; ++i)
+            retired.buckets[i] += sizes.buckets[i].load(std::memory_order_relaxed);
+        retired.reallocations += sizes.reallocations.load(std::memory_order_relaxed);
+        retired.avoided += sizes.avoided.load(std::memory_order_relaxed);
+    }
+}
+
+void PacketSizeStats::Record(Opcodes opcode, size_t size, size_t requested, size_t reserved)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    PacketSizeThreadCounters::OpcodeSizes& sizes = GetThreadCounters().opcodes[opcode];
+    PacketSizeThreadCounters::Add(sizes.totalSize, size);
+    PacketSizeThreadCounters::Add(sizes.buckets[GetBucket(size)], 1);
+
+    if (size > sizes.maxSize.load(std::memory_order_relaxed))
+        sizes.maxSize.store(size, std::memory_order_relaxed);
+
+    if (size > reserved)
+        PacketSizeThreadCounters::Add(sizes.reallocations, CountReallocations(reserved, size));
+    if (size > requested && reserved > requested)
+        PacketSizeThreadCounters::Add(sizes.avoided, CountReallocations(requested, size) - CountReallocations(reserved, size));
+
+    uint64 const count = sizes.count.load(std::memory_order_relaxed) + 1;
+    sizes.count.store(count, std::memory_order_relaxed);
+    if (count % PACKET_SIZE_HINT_SAMPLES == 0)
+        UpdateHint(opcode);
+}
+
+void PacketSizeStats::Merge(uint32 opcode, PacketSizeStat& stat) const
+{
+    stat = m_retired[opcode];
+    stat.opcode = opcode;
+
+    uint32 const generation = m_generation.load(std::memory_order_relaxed);
+    for (auto const& counters : m_threads)
+    {
+        if (counters->generation.load(std::memory_order_acquire) != generation)
+            continue;
+
+        PacketSizeThreadCounters::OpcodeSizes const& sizes = counters->opcodes[opcode];
+        stat.count += sizes.count.load(std::memory_order_relaxed);
+        stat.totalSize += sizes.totalSize.load(std::memory_order_relaxed);
+        stat.maxSize = std::max(stat.maxSize, uint32(sizes.maxSize.load(std::memory_order_relaxed)));
+        for (uint32 i = 0; i < PACKET_SIZE_BUCKETS; ++i)
+            stat.buckets[i] += sizes.buckets[i].load(std::memory_order_relaxed);
+        stat.reallocations += sizes.reallocations.load(std::memory_order_relaxed);
+        stat.avoided += sizes.avoided.load(std::memory_order_relaxed);
+    }
+
+    stat.hint = m_hints[opcode].load(std::memory_order_relaxed);
+}
+
+void PacketSizeStats::UpdateHint(uint32 opcode)
+{
+    PacketSizeStat stat;
+    {
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        Merge(opcode, stat);
+    }
+
+    uint64 total = 0;
+    for (uint64 bucket : stat.buckets)
+        total += bucket;
+
+    if (!total)
+        return;
+
+    // upper bound of the bucket reaching the percentile, the largest packet seen when that is smaller
+    uint64 const needed = (total * PACKET_SIZE_HINT_PERCENTILE + 99) / 100;
+    uint64 seen = 0;
+    size_t hint = PACKET_SIZE_MIN_BUCKET;
+    for (uint32 i = 0; i < PACKET_SIZE_BUCKETS; ++i, hint <<= 1)
+    {
+        seen += stat.buckets[i];
+        if (seen >= needed)
+            break;
+    }
+
+    hint = std::min<size_t>(std::min<size_t>(hint, stat.maxSize), PACKET_SIZE_MAX_HINT);
+    m_hints[opcode].store(uint32(hint), std::memory_order_relaxed);
+}
+
+void PacketSizeStats::GetTopOpcodes(std::vector<PacketSizeStat>& stats, uint32 count) const
+{
+    {
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+        {
+            PacketSizeStat stat;
+            Merge(opcode, stat);
+            if (stat.count)
+                stats.push_back(stat);
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](PacketSizeStat const& a, PacketSizeStat const& b) { return a.count > b.count; });
+    if (stats.size() > count)
+        stats.resize(count);
+}
+
+void PacketSizeStats::Reset()
+{
+    // learned hints are kept, they stay valid. Thread counters are cleared by their owners.
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    m_generation.fetch_add(1, std::memory_order_release);
+    for (PacketSizeStat& retired : m_retired)
+        retired = PacketSizeStat();
+}
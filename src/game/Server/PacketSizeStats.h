@@ -0,0 +1,106 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKET_SIZE_STATS_H
+#define MANGOS_PACKET_SIZE_STATS_H
+
+#include "Common.h"
+#include "Server/Opcodes.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define PACKET_SIZE_BUCKETS         13                      // bucket i holds sizes up to 32 << i bytes, the last one everything above
+#define PACKET_SIZE_MIN_BUCKET      32
+#define PACKET_SIZE_HINT_SAMPLES    256                     // packets of an opcode between two hint updates
+#define PACKET_SIZE_HINT_PERCENTILE 95                      // the hint covers this percentage of the packets of an opcode
+#define PACKET_SIZE_MAX_HINT        0x10000                 // larger packets keep growing, a bigger reserve costs more than it saves
+
+// final sizes of the packets built for one opcode
+struct PacketSizeStat
+{
+    uint32 opcode = 0;
+    uint64 count = 0;
+    uint64 totalSize = 0;
+    uint32 maxSize = 0;
+    uint64 buckets[PACKET_SIZE_BUCKETS] = {};
+    uint64 reallocations = 0;                               // estimated, with the reserve the packet got
+    uint64 avoided = 0;                                     // estimated, the caller reserve alone would have needed these too
+    uint32 hint = 0;
+};
+
+struct PacketSizeThreadCounters;
+
+/**
+ * Learns the usual size of every outgoing packet opcode. A WorldPacket built for an opcode records
+ * its final size when it is destroyed, and gets the learned size as its initial reserve when that is
+ * larger than the reserve the caller asked for, so builders stop regrowing their buffer.
+ * Every thread counts into its own block, blocks are merged when a hint is recomputed or the
+ * statistics are listed.
+ */
+class PacketSizeStats
+{
+        friend struct PacketSizeThreadHandle;
+
+    public:
+        static PacketSizeStats& Instance();
+
+        void SetHintsEnabled(bool enabled) { m_hintsEnabled = enabled; }
+
+        // reserve for a new packet of the opcode, never less than requested
+        size_t GetReserve(Opcodes opcode, size_t requested) const
+        {
+            if (!m_hintsEnabled || opcode >= NUM_MSG_TYPES)
+                return requested;
+
+            size_t hint = m_hints[opcode].load(std::memory_order_relaxed);
+            return hint > requested ? hint : requested;
+        }
+
+        // requested is the reserve asked for by the caller, reserved the one the packet got
+        void Record(Opcodes opcode, size_t size, size_t requested, size_t reserved);
+
+        // opcodes ordered by packet count, at most 'count'
+        void GetTopOpcodes(std::vector<PacketSizeStat>& stats, uint32 count) const;
+        void Reset();
+
+    private:
+        PacketSizeStats();
+
+        static uint32 GetBucket(size_t size);
+        static uint32 CountReallocations(size_t reserved, size_t size);
+
+        PacketSizeThreadCounters& GetThreadCounters();
+        void RetireThreadCounters(std::shared_ptr<PacketSizeThreadCounters> const& counters);
+        void Merge(uint32 opcode, PacketSizeStat& stat) const;      // m_threadsLock must be held
+        void UpdateHint(uint32 opcode);
+
+        bool m_hintsEnabled;
+        std::atomic<uint32> m_hints[NUM_MSG_TYPES];
+
+        mutable std::mutex m_threadsLock;                   // guards the lists of blocks, not their counters
+        std::vector<std::shared_ptr<PacketSizeThreadCounters> > m_threads;
+        std::vector<PacketSizeStat> m_retired;              // counters of exited threads, by opcode
+        std::atomic<uint32> m_generation;                   // bumped by Reset, blocks of an older one count as empty
+};
+
+#define sPacketSizeStats PacketSizeStats::Instance()
+
+#endif
@@ -27,6 +27,7 @@
 #include "Server/Opcodes.h"
 #include "WorldPacket.h"
 #include "Server/WorldSession.h"
+#include "Server/OpcodeStats.h"
 #include "Entities/Player.h"
 #include "Globals/ObjectMgr.h"
 #include "Groups/Group.h"
@@ -219,6 +220,8 @@ void WorldSession::SendPacket(WorldPacket const& packet, bool forcedSend /*= fal
         return;
     }
 
+    sOpcodeStats.RecordSent(OpcodeStatsScope::GetCurrentOpcode(), packet.size());
+
 #ifdef MANGOS_DEBUG
 
     // Code for network use statistic
@@ -265,6 +268,7 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
     OpcodeHandler const& opHandle = opcodeTable[new_packet->GetOpcode()];
     if (opHandle.packetProcessing == PROCESS_IMMEDIATE)
     {
+        OpcodeStatsScope opcodeStats(new_packet->GetOpcode(), new_packet->size());
         (this->*opHandle.handler)(*new_packet);
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
@@ -344,6 +348,15 @@ void WorldSession::ProcessByteBufferException(WorldPacket const& packet)
     }
 }
 
+void WorldSession::DeferPacket(WorldPacket const& packet)
+{
+    OpcodeStatsScope::SkipCurrent();                        // counted when handled again
+
+    std::unique_ptr<WorldPacket> copy = std::make_unique<WorldPacket>(packet);
+    copy->rpos(0);
+    m_deferredPackets.push_back(std::move(copy));
+}
+
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(uint32 diff)
 {
@@ -355,6 +368,12 @@ bool WorldSession::Update(uint32 diff)
         std::swap(recvQueueCopy, m_recvQueue);
     }
 
+    if (!m_deferredPackets.empty())
+    {
+        recvQueueCopy.insert(recvQueueCopy.begin(), std::make_move_iterator(m_deferredPackets.begin()), std::make_move_iterator(m_deferredPackets.end()));
+        m_deferredPackets.clear();
+    }
+
     if (m_Socket && !m_Socket->IsClosed() && m_anticheat)
     {
         auto const now = WorldTimer::getMSTime();
@@ -700,6 +719,11 @@ void WorldSession::LogoutPlayer()
         if (m_playerSave)
             _player->SaveToDB();
 
+        // guild and group rows of the player held back by the write-behind window
+        CharacterDatabase.FlushDelayedUpdate("group_member", "memberGuid = " + std::to_string(_player->GetGUIDLow()));
+        if (Guild* guild = sGuildMgr.GetGuildById(_player->GetGuildId()))
+            guild->FlushMemberBankLimits(_player->GetGUIDLow());
+
         ///- Leave all channels before player delete...
         _player->CleanupChannels();
 
@@ -1155,6 +1179,8 @@ void WorldSession::SendTransferAborted(uint32 mapid, uint8 reason, uint8 arg) co
 
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet)
 {
+    OpcodeStatsScope opcodeStats(packet.GetOpcode(), packet.size());
+
     // need prevent do internal far teleports in handlers because some handlers do lot steps
     // or call code that can do far teleports in some conditions unexpectedly for generic way work code
     if (_player)
@@ -56,6 +56,7 @@ class QueryResult;
 class LoginQueryHolder;
 class CharacterHandler;
 class GMTicket;
+class Guild;
 class MovementInfo;
 class WorldSession;
 class SessionAnticheatInterface;
@@ -311,6 +312,8 @@ class WorldSession
         void KickPlayer(bool save = false, bool inPlace = false); // inplace variable needed for shutdown
 
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
+        // handle the packet again at the next update, ahead of packets received since
+        void DeferPacket(WorldPacket const& packet);
 
         void DeleteMovementPackets();
 
@@ -405,6 +408,7 @@ class WorldSession
         void SendNotInArenaTeamPacket(uint8 type) const;
         void SendPetitionShowList(ObjectGuid guid) const;
         void SendSaveGuildEmblem(uint32 msg) const;
+        bool IsGuildDataReady(Guild* guild, WorldPacket const& packet);
         void SendBattleGroundOrArenaJoinError(uint8 err) const;
 
         // Looking For Group
@@ -982,6 +986,7 @@ class WorldSession
         std::mutex m_recvQueueMapLock;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueueMap;
+        std::deque<std::unique_ptr<WorldPacket>> m_deferredPackets;    // world thread only
 
         Messager<WorldSession> m_messager;
 
@@ -207,7 +207,10 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    // received packets have their exact size, they stay out of the outgoing size statistics
+    std::unique_ptr<WorldPacket> pct(new WorldPacket());
+    pct->SetOpcode(opcode);
+    pct->reserve(validBytesRemaining);
 
     if (validBytesRemaining)
     {
@@ -506,6 +509,9 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 
     m_crypt.Init(&K);
 
+    if (sPacketLog->CanLogPacket() && sPacketLog->IsLoggedAccount(id))
+        m_loggingPackets = true;
+
     m_session = sWorld.FindSession(id);
     if (m_session)
     {
@@ -7398,6 +7398,21 @@ void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, float cone, S
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_trueCaster->GetMap(), notifier, radius);
 }
 
+GridPackedFilter MaNGOS::SpellNotifierCreatureAndPlayer::GetPackedFilter() const
+{
+    // player controlled casters add the target combat reach, cones check it through isInFront/isInBack
+    GridPackedFilter filter(i_centerX, i_centerY, i_radius);
+    if (i_push_type != PUSH_CONE)
+        return filter;
+
+    float orientation = i_castingObject->GetOrientation();
+    if (i_cone >= 0.f)
+        filter.SetCone(orientation, MapManager::NormalizeOrientation(i_cone) / 2.0f);
+    else                                                    // isInBack: outside of the front arc 2*pi - cone
+        filter.SetCone(orientation + M_PI_F, M_PI_F - MapManager::NormalizeOrientation(2 * M_PI_F + i_cone) / 2.0f);
+    return filter;
+}
+
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster) const
 {
     Player* pMember = member->GetBeneficiaryPlayer();
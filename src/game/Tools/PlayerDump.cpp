@@ -728,6 +728,8 @@ DumpReturn PlayerDumpReader::LoadDump(const std::string& file, uint32 account, s
     if (incHighest)
         sObjectMgr.m_CharGuids.Set(sObjectMgr.m_CharGuids.GetNextAfterMaxUsed() + 1);
 
+    sObjectMgr.ReloadCharacterDirectoryEntry(guid);
+
     fclose(fin);
 
     return DUMP_SUCCESS;
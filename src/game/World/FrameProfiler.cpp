@@ -0,0 +1,296 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/FrameProfiler.h"
+#include "Policies/Singleton.h"
+#include "Config/Config.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+
+INSTANTIATE_SINGLETON_1(FrameProfiler);
+
+#define FRAME_PROFILER_HISTORY_TIME     (10 * MINUTE)       // seconds a slow tick stays in the history
+#define FRAME_PROFILER_AUTO_DUMP_TIME   MINUTE              // seconds between two automatic dumps
+
+class FrameProfilerBuffer
+{
+    public:
+        explicit FrameProfilerBuffer(uint32 index) : m_index(index) {}
+
+        void Add(FrameZone const& zone)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_zones.push_back(zone);
+        }
+
+        void MoveTo(std::vector<FrameZone>& zones)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            zones.insert(zones.end(), m_zones.begin(), m_zones.end());
+            m_zones.clear();
+        }
+
+        uint32 GetIndex() const { return m_index; }
+
+    private:
+        uint32 m_index;
+        std::mutex m_lock;                                  // only contended while the world thread collects
+        std::vector<FrameZone> m_zones;
+};
+
+static thread_local FrameProfilerBuffer* t_frameBuffer = nullptr;
+static thread_local uint32 t_frameMapId = FRAME_ZONE_NO_MAP;
+static thread_local uint32 t_frameInstanceId = 0;
+
+FrameProfiler::FrameProfiler() : m_enabled(false), m_historySize(0), m_slowTickTime(0), m_epoch(std::chrono::steady_clock::now()),
+    m_inTick(false), m_worldThread(0), m_tickId(0), m_lastAutoDump(0)
+{
+}
+
+FrameProfiler::~FrameProfiler()
+{
+}
+
+void FrameProfiler::Initialize(bool enabled, uint32 historySize, uint32 slowTickTime)
+{
+    m_historySize = historySize;
+    m_slowTickTime = slowTickTime;
+    SetEnabled(enabled);
+}
+
+void FrameProfiler::SetEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled)
+        m_inTick = false;
+}
+
+FrameProfilerBuffer* FrameProfiler::GetThreadBuffer()
+{
+    if (!t_frameBuffer)
+    {
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        m_buffers.emplace_back(new FrameProfilerBuffer(uint32(m_buffers.size())));
+        t_frameBuffer = m_buffers.back().get();
+    }
+
+    return t_frameBuffer;
+}
+
+uint64 FrameProfiler::ToMicroseconds(std::chrono::steady_clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - m_epoch).count();
+}
+
+void FrameProfiler::AddZone(char const* name, uint32 mapId, uint32 instanceId, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    FrameProfilerBuffer* buffer = GetThreadBuffer();
+    uint32 const duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    buffer->Add(FrameZone{ name, mapId, instanceId, ToMicroseconds(start), duration, buffer->GetIndex() });
+}
+
+void FrameProfiler::BeginTick()
+{
+    if (!IsEnabled())
+        return;
+
+    m_inTick = true;
+    m_worldThread = GetThreadBuffer()->GetIndex();
+
+    // zones of a tick the profiler was enabled in the middle of
+    {
+        std::vector<FrameZone> stale;
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        for (auto const& buffer : m_buffers)
+            buffer->MoveTo(stale);
+    }
+
+    m_tickStart = std::chrono::steady_clock::now();
+    ++m_tickId;
+}
+
+void FrameProfiler::EndTick()
+{
+    if (!m_inTick)
+        return;
+
+    m_inTick = false;
+    std::chrono::steady_clock::time_point const tickEnd = std::chrono::steady_clock::now();
+    AddZone("World::Update", FRAME_ZONE_NO_MAP, 0, m_tickStart, tickEnd);
+
+    FrameTick tick;
+    tick.id = m_tickId;
+    tick.time = time(nullptr);
+    tick.duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(tickEnd - m_tickStart).count());
+    {
+        std::lock_guard<std::mutex> guard(m_buffersLock);
+        for (auto const& buffer : m_buffers)
+            buffer->MoveTo(tick.zones);
+    }
+
+    if (m_slowTickTime && tick.duration >= m_slowTickTime * IN_MILLISECONDS && tick.time - m_lastAutoDump >= FRAME_PROFILER_AUTO_DUMP_TIME)
+    {
+        m_lastAutoDump = tick.time;
+        std::string filename = "tick_" + std::to_string(tick.id) + ".json";
+        if (WriteTrace(filename, { &tick }))
+            sLog.outString("FrameProfiler: tick %u took %u ms, trace written to %s", tick.id, tick.duration / IN_MILLISECONDS, filename.c_str());
+    }
+
+    std::lock_guard<std::mutex> guard(m_historyLock);
+    m_history.erase(std::remove_if(m_history.begin(), m_history.end(),
+                                   [&tick](FrameTick const& old) { return old.time + FRAME_PROFILER_HISTORY_TIME < tick.time; }), m_history.end());
+
+    if (m_history.size() < m_historySize)
+        m_history.push_back(std::move(tick));
+    else if (!m_history.empty())
+    {
+        auto fastest = std::min_element(m_history.begin(), m_history.end(), [](FrameTick const& a, FrameTick const& b) { return a.duration < b.duration; });
+        if (fastest->duration < tick.duration)
+            *fastest = std::move(tick);
+    }
+}
+
+void FrameProfiler::GetSlowestTicks(std::vector<FrameTick>& ticks, uint32 count) const
+{
+    {
+        std::lock_guard<std::mutex> guard(m_historyLock);
+        ticks = m_history;
+    }
+
+    std::sort(ticks.begin(), ticks.end(), [](FrameTick const& a, FrameTick const& b) { return a.duration > b.duration; });
+    if (ticks.size() > count)
+        ticks.resize(count);
+}
+
+void FrameProfiler::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_historyLock);
+    m_history.clear();
+}
+
+bool FrameProfiler::Dump(std::string const& filename, uint32 count) const
+{
+    std::lock_guard<std::mutex> guard(m_historyLock);
+
+    std::vector<FrameTick const*> ticks;
+    for (FrameTick const& tick : m_history)
+        ticks.push_back(&tick);
+
+    std::sort(ticks.begin(), ticks.end(), [](FrameTick const* a, FrameTick const* b) { return a->duration > b->duration; });
+    if (ticks.size() > count)
+        ticks.resize(count);
+
+    return WriteTrace(filename, ticks);
+}
+
+bool FrameProfiler::WriteTrace(std::string const& filename, std::vector<FrameTick const*> const& ticks) const
+{
+    std::string logsDir = sConfig.GetStringDefault("LogsDir", "");
+    if (!logsDir.empty() && logsDir.back() != '/' && logsDir.back() != '\\')
+        logsDir.push_back('/');
+
+    FILE* file = fopen((logsDir + filename).c_str(), "w");
+    if (!file)
+    {
+        sLog.outError("FrameProfiler: could not open %s%s for writing", logsDir.c_str(), filename.c_str());
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // thread names, the map threads change between maps so they are only numbered
+    uint32 threads = 0;
+    for (FrameTick const* tick : ticks)
+        for (FrameZone const& zone : tick->zones)
+            threads = std::max(threads, zone.thread + 1);
+
+    for (uint32 thread = 0; thread < threads; ++thread)
+    {
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}},\n",
+                thread, thread == m_worldThread ? "world" : "thread", thread);
+    }
+
+    bool first = true;
+    for (FrameTick const* tick : ticks)
+    {
+        for (FrameZone const& zone : tick->zones)
+        {
+            fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":" UI64FMTD ",\"dur\":%u,\"args\":{\"tick\":%u",
+                    first ? "" : ",\n", zone.name, zone.mapId != FRAME_ZONE_NO_MAP ? "map" : "world", zone.thread, zone.start, zone.duration, tick->id);
+            if (zone.mapId != FRAME_ZONE_NO_MAP)
+                fprintf(file, ",\"map\":%u,\"instance\":%u", zone.mapId, zone.instanceId);
+            fprintf(file, "}}");
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+FrameProfileZone::FrameProfileZone(char const* name) : m_name(nullptr), m_mapId(t_frameMapId), m_instanceId(t_frameInstanceId), m_mapScope(false),
+    m_previousMapId(0), m_previousInstanceId(0)
+{
+    Open(name);
+}
+
+FrameProfileZone::FrameProfileZone(char const* name, uint32 mapId, uint32 instanceId) : m_name(nullptr), m_mapId(mapId), m_instanceId(instanceId),
+    m_mapScope(true), m_previousMapId(t_frameMapId), m_previousInstanceId(t_frameInstanceId)
+{
+    t_frameMapId = mapId;
+    t_frameInstanceId = instanceId;
+    Open(name);
+}
+
+FrameProfileZone::~FrameProfileZone()
+{
+    Close();
+
+    if (m_mapScope)
+    {
+        t_frameMapId = m_previousMapId;
+        t_frameInstanceId = m_previousInstanceId;
+    }
+}
+
+void FrameProfileZone::Open(char const* name)
+{
+    if (!sFrameProfiler.IsEnabled())
+        return;
+
+    m_name = name;
+    m_start = std::chrono::steady_clock::now();
+}
+
+void FrameProfileZone::Close()
+{
+    if (!m_name)
+        return;
+
+    sFrameProfiler.AddZone(m_name, m_mapId, m_instanceId, m_start, std::chrono::steady_clock::now());
+    m_name = nullptr;
+}
+
+void FrameProfileZone::Next(char const* name)
+{
+    Close();
+    Open(name);
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_FRAME_PROFILER_H
+#define MANGOS_FRAME_PROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define FRAME_ZONE_NO_MAP   0xFFFFFFFF                     // zone outside of a map update
+
+// one timed phase of a tick, name is a string literal
+struct FrameZone
+{
+    char const* name;
+    uint32 mapId;
+    uint32 instanceId;
+    uint64 start;                                           // microseconds since the profiler started
+    uint32 duration;                                        // microseconds
+    uint32 thread;                                          // profiler thread index
+};
+
+struct FrameTick
+{
+    uint32 id = 0;
+    time_t time = 0;
+    uint32 duration = 0;                                    // microseconds
+    std::vector<FrameZone> zones;
+};
+
+class FrameProfilerBuffer;
+
+/**
+ * Records the phases of World::Update and Map::Update while enabled. Every thread keeps the zones it
+ * timed in its own buffer, the world thread collects them at the end of the tick, after the map
+ * threads are done, and keeps the slowest ticks of the last FRAME_PROFILER_HISTORY_TIME. Ticks can
+ * be dumped as Chrome trace JSON (chrome://tracing, Perfetto), at once when one exceeds the slow tick
+ * time.
+ */
+class FrameProfiler
+{
+    public:
+        FrameProfiler();
+        ~FrameProfiler();
+
+        // world thread
+        void Initialize(bool enabled, uint32 historySize, uint32 slowTickTime);
+        void SetEnabled(bool enabled);
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        void BeginTick();
+        void EndTick();
+
+        // slowest first
+        void GetSlowestTicks(std::vector<FrameTick>& ticks, uint32 count) const;
+        void Reset();
+
+        // the slowest ticks of the history, returns false when the file could not be written
+        bool Dump(std::string const& filename, uint32 count) const;
+
+        // any thread, inside the tick
+        void AddZone(char const* name, uint32 mapId, uint32 instanceId, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    private:
+        FrameProfilerBuffer* GetThreadBuffer();
+        uint64 ToMicroseconds(std::chrono::steady_clock::time_point time) const;
+        bool WriteTrace(std::string const& filename, std::vector<FrameTick const*> const& ticks) const;
+
+        std::atomic<bool> m_enabled;
+        uint32 m_historySize;
+        uint32 m_slowTickTime;                              // milliseconds, 0 does not dump on its own
+        std::chrono::steady_clock::time_point m_epoch;
+
+        std::mutex m_buffersLock;
+        std::vector<std::unique_ptr<FrameProfilerBuffer>> m_buffers;
+
+        bool m_inTick;
+        uint32 m_worldThread;
+        uint32 m_tickId;
+        std::chrono::steady_clock::time_point m_tickStart;
+        time_t m_lastAutoDump;
+
+        mutable std::mutex m_historyLock;
+        std::vector<FrameTick> m_history;                   // unordered
+};
+
+#define sFrameProfiler MaNGOS::Singleton<FrameProfiler>::Instance()
+
+/**
+ * Times a phase for the frame profiler, from construction to destruction. Next() closes the current
+ * phase and opens the following one, so a sequence of phases needs a single zone. A zone given a map
+ * makes it the map of the zones nested in it on the same thread.
+ */
+class FrameProfileZone
+{
+    public:
+        explicit FrameProfileZone(char const* name);
+        FrameProfileZone(char const* name, uint32 mapId, uint32 instanceId);
+        ~FrameProfileZone();
+
+        FrameProfileZone(FrameProfileZone const&) = delete;
+        FrameProfileZone& operator=(FrameProfileZone const&) = delete;
+
+        void Next(char const* name);
+        void Close();                                       // ends the current phase before the end of the scope
+
+    private:
+        void Open(char const* name);
+
+        char const* m_name;                                 // nullptr while the profiler is off
+        uint32 m_mapId;
+        uint32 m_instanceId;
+        bool m_mapScope;
+        uint32 m_previousMapId;
+        uint32 m_previousInstanceId;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#endif
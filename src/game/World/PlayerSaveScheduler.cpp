@@ -0,0 +1,149 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "World/PlayerSaveScheduler.h"
+#include "Policies/Singleton.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+
+#include <algorithm>
+#include <vector>
+
+INSTANTIATE_SINGLETON_1(PlayerSaveScheduler);
+
+#define PLAYER_SAVE_GRANT_TIMEOUT   (10 * IN_MILLISECONDS)  // grant not taken by then goes back to the requests
+#define PLAYER_SAVE_CATCHUP_TIME    (MINUTE * IN_MILLISECONDS) // pending requests are worked off within this time when the database keeps up
+
+PlayerSaveScheduler::PlayerSaveScheduler() : m_credit(0.0f)
+{
+#ifdef BUILD_METRICS
+    m_grantedMetric = metric::counter("player.save.granted");
+    m_backlogMetric = metric::histogram("player.save.backlog");
+    m_dbQueueMetric = metric::histogram("db.async_queue", { { "database", "character" } });
+#endif
+}
+
+void PlayerSaveScheduler::RequestSave(ObjectGuid guid, uint32 dirtyScore)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_granted.find(guid) != m_granted.end())
+        return;
+
+    auto result = m_pending.emplace(guid, SaveRequest{ dirtyScore, 0 });
+    if (!result.second)
+        result.first->second.dirtyScore = dirtyScore;
+}
+
+bool PlayerSaveScheduler::TakeGrant(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_granted.erase(guid) != 0;
+}
+
+void PlayerSaveScheduler::Cancel(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_pending.erase(guid);
+    m_granted.erase(guid);
+}
+
+void PlayerSaveScheduler::Update(uint32 diff)
+{
+    uint32 const interval = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
+    uint32 const queueLimit = sWorld.getConfig(CONFIG_UINT32_PLAYER_SAVE_QUEUE_LIMIT);
+    size_t const queueSize = CharacterDatabase.GetAsyncQueueSize();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    for (auto itr = m_granted.begin(); itr != m_granted.end();)
+    {
+        itr->second.grantTime += diff;
+        if (itr->second.grantTime >= PLAYER_SAVE_GRANT_TIMEOUT)
+        {
+            // still unsaved since the original request, it keeps its place
+            SaveRequest request = itr->second.request;
+            request.waitTime += itr->second.grantTime;
+            m_pending.emplace(itr->first, request);
+            itr = m_granted.erase(itr);
+        }
+        else
+            ++itr;
+    }
+
+#ifdef BUILD_METRICS
+    m_backlogMetric.record(int64(m_pending.size()));
+    m_dbQueueMetric.record(int64(queueSize));
+#endif
+
+    if (m_pending.empty() || !interval)
+    {
+        m_credit = 0.0f;
+        return;
+    }
+
+    // every online player once per interval, faster while requests wait
+    float rate = float(sWorld.GetActiveSessionCount()) * diff / interval;
+    rate = std::max(rate, float(m_pending.size()) * diff / PLAYER_SAVE_CATCHUP_TIME);
+
+    if (queueLimit && queueSize >= queueLimit)
+        rate = 0.0f;
+    else if (queueLimit && queueSize >= queueLimit / 2)
+        rate *= 0.5f;
+
+    m_credit = std::min(m_credit + rate, float(m_pending.size()));
+
+    // requests waiting a full interval are granted whatever the database load, it bounds what a crash can lose
+    std::vector<std::pair<uint32, ObjectGuid>> candidates;
+    candidates.reserve(m_pending.size());
+    for (auto itr = m_pending.begin(); itr != m_pending.end();)
+    {
+        itr->second.waitTime += diff;
+        if (itr->second.waitTime >= interval)
+        {
+            m_granted.emplace(itr->first, SaveGrant{ itr->second, 0 });
+            itr = m_pending.erase(itr);
+#ifdef BUILD_METRICS
+            m_grantedMetric.add();
+#endif
+            continue;
+        }
+
+        // one point per second of waiting keeps clean players from starving
+        candidates.emplace_back(itr->second.dirtyScore + itr->second.waitTime / IN_MILLISECONDS, itr->first);
+        ++itr;
+    }
+
+    uint32 const count = std::min(uint32(m_credit), uint32(candidates.size()));
+    if (count)
+    {
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                          [](std::pair<uint32, ObjectGuid> const& a, std::pair<uint32, ObjectGuid> const& b) { return a.first > b.first; });
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            auto itr = m_pending.find(candidates[i].second);
+            m_granted.emplace(itr->first, SaveGrant{ itr->second, 0 });
+            m_pending.erase(itr);
+        }
+
+        m_credit -= count;
+#ifdef BUILD_METRICS
+        m_grantedMetric.add(count);
+#endif
+    }
+}
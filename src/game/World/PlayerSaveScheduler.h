@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PLAYER_SAVE_SCHEDULER_H
+#define MANGOS_PLAYER_SAVE_SCHEDULER_H
+
+#include "Common.h"
+#include "Entities/ObjectGuid.h"
+#include "Policies/Singleton.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * Paces player autosaves. A player whose save timer expired requests a save from its map thread,
+ * the world thread grants requests once per tick at the rate needed to save every online player
+ * once per PlayerSave.Interval, slower while the character database async queue is deep and
+ * faster while requests pile up. Requests with more unsaved changes are granted first, the granted
+ * player saves itself in its next update.
+ */
+class PlayerSaveScheduler
+{
+    public:
+        PlayerSaveScheduler();
+
+        // map threads
+        void RequestSave(ObjectGuid guid, uint32 dirtyScore);
+        bool TakeGrant(ObjectGuid guid);
+        void Cancel(ObjectGuid guid);                       // saved outside of the scheduler or logged out
+
+        // world thread
+        void Update(uint32 diff);
+
+    private:
+        struct SaveRequest
+        {
+            uint32 dirtyScore;
+            uint32 waitTime;                                // milliseconds since the request
+        };
+
+        struct SaveGrant
+        {
+            SaveRequest request;                            // as granted, requeued on timeout
+            uint32 grantTime;                               // milliseconds since the grant
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<ObjectGuid, SaveRequest> m_pending;
+        std::unordered_map<ObjectGuid, SaveGrant> m_granted;
+
+        float m_credit;                                     // saves allowed but not granted yet
+
+#ifdef BUILD_METRICS
+        metric::counter m_grantedMetric;
+        metric::histogram m_backlogMetric;
+        metric::histogram m_dbQueueMetric;
+#endif
+};
+
+#define sPlayerSaveScheduler MaNGOS::Singleton<PlayerSaveScheduler>::Instance()
+
+#endif
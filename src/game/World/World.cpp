@@ -28,6 +28,8 @@
 #include "Log.h"
 #include "Server/Opcodes.h"
 #include "Server/WorldSession.h"
+#include "Server/PacketSizeStats.h"
+#include "Server/OpcodeStats.h"
 #include "WorldPacket.h"
 #include "Entities/Player.h"
 #include "Skills/SkillExtraItems.h"
@@ -67,6 +69,8 @@
 #include "Cinematics/CinematicMgr.h"
 #include "Maps/TransportMgr.h"
 #include "Anticheat/Anticheat.hpp"
+#include "World/PlayerSaveScheduler.h"
+#include "World/FrameProfiler.h"
 
 #ifdef BUILD_AHBOT
  #include "AuctionHouseBot/AuctionHouseBot.h"
@@ -95,6 +99,7 @@ float World::m_MaxVisibleDistanceInBGArenas   = DEFAULT_VISIBILITY_BGARENAS;
 
 float  World::m_relocation_lower_limit_sq = 10.f * 10.f;
 uint32 World::m_relocation_ai_notify_delay = 1000u;
+bool   World::m_relocation_visibility_batched = true;
 
 uint32 World::m_currentMSTime = 0;
 TimePoint World::m_currentTime = TimePoint();
@@ -150,6 +155,7 @@ World::~World()
 /// Cleanups before world stop
 void World::CleanupsBeforeStop()
 {
+    sAuctionMgr.StopWorker();                        // finish pending auction expiries while mail receivers still online
     KickAll(true);                                   // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
@@ -425,6 +431,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_FLOAT_RATE_AUCTION_DEPOSIT, "Rate.Auction.Deposit", 1.0f);
     setConfig(CONFIG_FLOAT_RATE_AUCTION_CUT,     "Rate.Auction.Cut", 1.0f);
     setConfig(CONFIG_UINT32_AUCTION_DEPOSIT_MIN, "Auction.Deposit.Min", 0);
+    setConfig(CONFIG_UINT32_AUCTION_MUTATIONS_PER_TICK, "Auction.MutationsPerTick", 50);
     setConfig(CONFIG_FLOAT_RATE_HONOR, "Rate.Honor", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_AMOUNT, "Rate.Mining.Amount", 1.0f);
     setConfigPos(CONFIG_FLOAT_RATE_MINING_NEXT,   "Rate.Mining.Next", 1.0f);
@@ -471,6 +478,7 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
+    setConfig(CONFIG_UINT32_PLAYER_SAVE_QUEUE_LIMIT, "PlayerSave.QueueLimit", 200);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
 
     setConfigMin(CONFIG_UINT32_INTERVAL_GRIDCLEAN, "GridCleanUpDelay", 5 * MINUTE * IN_MILLISECONDS, MIN_GRID_DELAY);
@@ -713,6 +721,13 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_BOOL_PACKET_SIZE_HINTS, "Network.PacketSizeHints", true);
+    sPacketSizeStats.SetHintsEnabled(getConfig(CONFIG_BOOL_PACKET_SIZE_HINTS));
+
+    setConfig(CONFIG_BOOL_FRAME_PROFILER, "FrameProfiler.Enable", false);
+    setConfig(CONFIG_UINT32_FRAME_PROFILER_HISTORY, "FrameProfiler.History", 20);
+    setConfig(CONFIG_UINT32_FRAME_PROFILER_SLOW_TICK, "FrameProfiler.SlowTick", 0);
+    sFrameProfiler.Initialize(getConfig(CONFIG_BOOL_FRAME_PROFILER), getConfig(CONFIG_UINT32_FRAME_PROFILER_HISTORY), getConfig(CONFIG_UINT32_FRAME_PROFILER_SLOW_TICK));
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -734,6 +749,7 @@ void World::LoadConfigSettings(bool reload)
 
     m_relocation_ai_notify_delay = sConfig.GetIntDefault("Visibility.AIRelocationNotifyDelay", 1000u);
     m_relocation_lower_limit_sq = pow(sConfig.GetFloatDefault("Visibility.RelocationLowerLimit", 10), 2);
+    m_relocation_visibility_batched = sConfig.GetBoolDefault("Visibility.BatchRelocation", true);
 
     // Visibility on Continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
@@ -1063,6 +1079,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Spawn Groups");                 // must be after creature and GO load
     sObjectMgr.LoadSpawnGroups();
 
+    sLog.outString("Packing Static Spawn Grid Data...");    // must be after LoadSpawnGroups, it removes grouped spawns from the grid
+    sObjectMgr.PackMapObjectGuids();
+
     sLog.outString("Generating SpellTargetMgr data...\n");
     SpellTargetMgr::Initialize(); // must be after LoadSpellScriptTarget
 
@@ -1169,6 +1188,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player Corpses...");
     sObjectMgr.LoadCorpses();
 
+    sLog.outString("Loading Character Directory...");
+    sObjectMgr.LoadCharacterDirectory();
+
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
@@ -1399,6 +1421,9 @@ void World::SetInitialWorldSettings()
     sLog.outString();
 #endif
 
+    sLog.outString("Starting auction worker...");
+    sAuctionMgr.StartWorker();
+
     sLog.outString("Loading WorldState");
     sWorldState.Load();
     sLog.outString();
@@ -1406,6 +1431,16 @@ void World::SetInitialWorldSettings()
 #ifdef BUILD_METRICS
     // update metrics output every second
     m_timers[WUPDATE_METRICS].SetInterval(1 * IN_MILLISECONDS);
+
+    // starts the sender, pre-registered series record nothing before
+    metric::metric::instance();
+
+    m_updateTotalMetric = metric::histogram("world.update", { { "phase", "total" } });
+    m_updatePresessionMetric = metric::histogram("world.update", { { "phase", "presession" } });
+    m_updatePremapMetric = metric::histogram("world.update", { { "phase", "premap" } });
+    m_updateMapMetric = metric::histogram("world.update", { { "phase", "map" } });
+    m_updateSingletonsMetric = metric::histogram("world.update", { { "phase", "singletons" } });
+    m_updateCleanupMetric = metric::histogram("world.update", { { "phase", "cleanup" } });
 #endif // BUILD_METRICS
 
 
@@ -1475,6 +1510,9 @@ void World::Update(uint32 diff)
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
 
+    sFrameProfiler.BeginTick();
+    FrameProfileZone phase("World::Timers");
+
     ///- Update the different timers
     for (auto& m_timer : m_timers)
     {
@@ -1487,11 +1525,13 @@ void World::Update(uint32 diff)
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
 
+    phase.Next("World::Messager");
     GetMessager().Execute(this);
 
     ///-Update mass mailer tasks if any
     sMassMailMgr.Update();
 
+    phase.Next("World::QuestResets");
     /// Handle daily quests reset time
     if (m_gameTime > m_NextDailyQuestReset)
         ResetDailyQuests();
@@ -1505,6 +1545,7 @@ void World::Update(uint32 diff)
         ResetMonthlyQuests();
 
     /// <ul><li> Handle auctions when the timer has passed
+    phase.Next("World::Auctions");
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
         m_timers[WUPDATE_AUCTIONS].Reset();
@@ -1517,10 +1558,13 @@ void World::Update(uint32 diff)
             sObjectMgr.ReturnOrDeleteOldMails(true);
         }
 
-        ///- Handle expired auctions
+        ///- Queue expired auctions to auction worker
         sAuctionMgr.Update();
     }
 
+    ///- Apply auction changes prepared by auction worker
+    sAuctionMgr.ProcessMutations();
+
 #ifdef BUILD_AHBOT
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
@@ -1528,14 +1572,18 @@ void World::Update(uint32 diff)
         sAuctionHouseBot.Update();
         m_timers[WUPDATE_AHBOT].Reset();
     }
+    sAuctionHouseBot.ProcessOrders();
 #endif
 
     /// <li> Handle session updates
 #ifdef BUILD_METRICS
     auto preSessionTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
+    phase.Next("World::UpdateSessions");
     UpdateSessions(diff);
 
+    phase.Next("World::Uptime");
+
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
@@ -1551,13 +1599,20 @@ void World::Update(uint32 diff)
 #ifdef BUILD_METRICS
     auto preMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
+    phase.Next("MapManager::Update");
     sMapMgr.Update(diff);
+    phase.Next("PlayerSaveScheduler::Update");
+    sPlayerSaveScheduler.Update(diff);
 #ifdef BUILD_METRICS
     auto postMapTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
+    phase.Next("BattleGroundMgr::Update");
     sBattleGroundMgr.Update(diff);
+    phase.Next("OutdoorPvPMgr::Update");
     sOutdoorPvPMgr.Update(diff);
+    phase.Next("WorldState::Update");
     sWorldState.Update(diff);
+    phase.Next("World::Groups");
 #ifdef BUILD_METRICS
     auto postSingletonTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
 #endif
@@ -1580,8 +1635,11 @@ void World::Update(uint32 diff)
     }
 
     // execute callbacks from sql queries that were queued recently
+    phase.Next("World::UpdateResultQueue");
     UpdateResultQueue();
 
+    phase.Next("World::GameEvents");
+
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
@@ -1609,16 +1667,23 @@ void World::Update(uint32 diff)
 
     /// </ul>
     ///- Move all creatures with "delayed move" and remove and delete all objects with "delayed remove"
+    phase.Next("MapManager::RemoveAllObjectsInRemoveList");
     sMapMgr.RemoveAllObjectsInRemoveList();
 
     // update the instance reset times
+    phase.Next("MapPersistentStateMgr::Update");
     sMapPersistentStateMgr.Update();
 
     // And last, but not least handle the issued cli commands
+    phase.Next("World::ProcessCliCommands");
     ProcessCliCommands();
 
     // cleanup unused GridMap objects as well as VMaps
+    phase.Next("TerrainManager::Update");
     sTerrainMgr.Update(diff);
+
+    phase.Close();
+    sFrameProfiler.EndTick();
 #ifdef BUILD_METRICS
     auto updateEndTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     long long total = (updateEndTime - m_currentTime).count();
@@ -1628,13 +1693,12 @@ void World::Update(uint32 diff)
     long long singletons = (postSingletonTime - postMapTime).count();
     long long cleanup = (updateEndTime - postSingletonTime).count();
 
-    metric::measurement meas("world.update");
-    meas.add_field("total", std::to_string(total));
-    meas.add_field("presession", std::to_string(presession));
-    meas.add_field("premap", std::to_string(premap));
-    meas.add_field("map", std::to_string(map));
-    meas.add_field("singletons", std::to_string(singletons));
-    meas.add_field("cleanup", std::to_string(cleanup));
+    m_updateTotalMetric.record(total);
+    m_updatePresessionMetric.record(presession);
+    m_updatePremapMetric.record(premap);
+    m_updateMapMetric.record(map);
+    m_updateSingletonsMetric.record(singletons);
+    m_updateCleanupMetric.record(cleanup);
 #endif
 }
 
@@ -2127,6 +2191,9 @@ void World::UpdateResultQueue()
     CharacterDatabase.ProcessResultQueue();
     WorldDatabase.ProcessResultQueue();
     LoginDatabase.ProcessResultQueue();
+
+    // updates whose write-behind window passed
+    CharacterDatabase.UpdateWriteBehind();
 }
 
 void World::UpdateRealmCharCount(uint32 accountId)
@@ -2645,6 +2712,8 @@ void World::GeneratePacketMetrics()
         m_opcodeCounters[i] = 0;
     }
 
+    sOpcodeStats.GenerateMetrics();
+
     metric::measurement meas_players("world.metrics.players");
     meas_players.add_field("online", std::to_string(GetActiveSessionCount()));
     meas_players.add_field("unique", std::to_string(GetUniqueSessionCount()));
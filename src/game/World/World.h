@@ -31,6 +31,10 @@
 #include "Multithreading/Messager.h"
 #include "Globals/GraveyardManager.h"
 
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
 #include <atomic>
 #include <set>
 #include <list>
@@ -142,6 +146,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
+    CONFIG_UINT32_AUCTION_MUTATIONS_PER_TICK,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
     CONFIG_UINT32_SKILL_CHANCE_GREEN,
@@ -188,6 +193,9 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MIRRORTIMER_BREATH_MAX,
     CONFIG_UINT32_MIRRORTIMER_ENVIRONMENTAL_MAX,
     CONFIG_UINT32_MIN_LEVEL_STAT_SAVE,
+    CONFIG_UINT32_PLAYER_SAVE_QUEUE_LIMIT,
+    CONFIG_UINT32_FRAME_PROFILER_HISTORY,
+    CONFIG_UINT32_FRAME_PROFILER_SLOW_TICK,
     CONFIG_UINT32_CHARDELETE_KEEP_DAYS,
     CONFIG_UINT32_CHARDELETE_METHOD,
     CONFIG_UINT32_CHARDELETE_MIN_LEVEL,
@@ -362,6 +370,8 @@ enum eConfigBoolValues
     CONFIG_BOOL_OUTDOORPVP_TF_ENABLED,
     CONFIG_BOOL_OUTDOORPVP_NA_ENABLED,
     CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET,
+    CONFIG_BOOL_PACKET_SIZE_HINTS,
+    CONFIG_BOOL_FRAME_PROFILER,
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
@@ -607,6 +617,7 @@ class World
 
         static float GetRelocationLowerLimitSq() { return m_relocation_lower_limit_sq; }
         static uint32 GetRelocationAINotifyDelay() { return m_relocation_ai_notify_delay; }
+        static bool IsRelocationVisibilityBatched() { return m_relocation_visibility_batched; }
 
         void ProcessCliCommands();
         void QueueCliCommand(const CliCommandHolder* commandHolder) { std::lock_guard<std::mutex> guard(m_cliCommandQueueLock); m_cliCommandQueue.push_back(commandHolder); }
@@ -735,6 +746,7 @@ class World
 
         static float  m_relocation_lower_limit_sq;
         static uint32 m_relocation_ai_notify_delay;
+        static bool   m_relocation_visibility_batched;
 
         // CLI command holder to be thread safe
         std::mutex m_cliCommandQueueLock;
@@ -780,6 +792,16 @@ class World
         std::array<std::atomic<uint32>, MAX_CLASSES> m_onlineClasses;
 
         GraveyardManager m_graveyardManager;
+
+#ifdef BUILD_METRICS
+        // world.update phases in milliseconds, registered in SetInitialWorldSettings
+        metric::histogram m_updateTotalMetric;
+        metric::histogram m_updatePresessionMetric;
+        metric::histogram m_updatePremapMetric;
+        metric::histogram m_updateMapMetric;
+        metric::histogram m_updateSingletonsMetric;
+        metric::histogram m_updateCleanupMetric;
+#endif
 };
 
 extern uint32 realmID;
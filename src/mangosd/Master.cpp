@@ -135,6 +135,9 @@ int Master::Run()
     LoginDatabase.AllowAsyncTransactions();
     LogsDatabase.AllowAsyncTransactions();
 
+    // startup output stays synchronous to keep it in order with progress bars
+    sLog.StartAsyncWriter();
+
     ///- Catch termination signals
     _HookSignals();
 
@@ -318,6 +321,8 @@ int Master::Run()
         delete cliThread;
     }
 
+    sLog.StopAsyncWriter();
+
     // mark this can be killable
     m_canBeKilled = true;
 
@@ -40,6 +40,7 @@ void WorldRunnable::run()
 {
     ///- Init new SQL thread for the world database
     WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+    SetSqlThreadRole(SQL_THREAD_WORLD);
     sWorld.InitResultQueue();
 
     uint32 diffTick = WorldTimer::tick(); // initialize world timer vars
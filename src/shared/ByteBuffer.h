@@ -65,6 +65,7 @@ class ByteBuffer
 
         // copy constructor
         ByteBuffer(const ByteBuffer& buf): _rpos(buf._rpos), _wpos(buf._wpos), _storage(buf._storage) { }
+        ByteBuffer& operator=(const ByteBuffer&) = default;
 
         void clear()
         {
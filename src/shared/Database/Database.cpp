@@ -25,6 +25,7 @@
 #include <fstream>
 #include <memory>
 #include <cstdarg>
+#include <chrono>
 
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
@@ -111,6 +112,17 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    // database name is the last field of the connection string
+    std::string database = infoString;
+    std::string::size_type const nameStart = database.find_last_of(';');
+    if (nameStart != std::string::npos)
+        database.erase(0, nameStart + 1);
+
+    m_queryStats.Initialize(database, sConfig.GetBoolDefault("SyncQueryStats", false),
+                            SqlStrictMode(sConfig.GetIntDefault("SyncQueryStrict", SQL_STRICT_OFF)),
+                            sConfig.GetIntDefault("SyncQuerySlowTime", 0));
+    m_writeBehind.Initialize(database, sConfig.GetIntDefault("WriteBehindWindow", 2000));
+
     // create DB connections
 
     // setup connection pool size
@@ -180,6 +192,8 @@ void Database::HaltDelayThread()
 {
     if (!m_threadBody || !m_delayThread) return;
 
+    WriteDelayedUpdates(true);                              // queued before the delay thread drains its queue
+
     m_threadBody->Stop();                                   // Stop event
     m_delayThread->wait();                                  // Wait for flush to DB
     delete m_delayThread;                                   // This also deletes m_threadBody
@@ -299,7 +313,7 @@ QueryResult* Database::PQuery(const char* format, ...)
         return nullptr;
     }
 
-    return Query(szQuery);
+    return DoQuery(format, szQuery);
 }
 
 QueryNamedResult* Database::PQueryNamed(const char* format, ...)
@@ -318,7 +332,45 @@ QueryNamedResult* Database::PQueryNamed(const char* format, ...)
         return nullptr;
     }
 
-    return QueryNamed(szQuery);
+    return DoQueryNamed(format, szQuery);
+}
+
+QueryResult* Database::DoQuery(const char* format, const char* sql)
+{
+    SqlThreadRole const role = GetSqlThreadRole();
+    if (!m_queryStats.IsTracked(role))
+    {
+        SqlConnection::Lock guard(getQueryConnection());
+        return guard->Query(sql);
+    }
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    QueryResult* result;
+    {
+        SqlConnection::Lock guard(getQueryConnection());
+        result = guard->Query(sql);
+    }
+    m_queryStats.Record(role, format, sql, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return result;
+}
+
+QueryNamedResult* Database::DoQueryNamed(const char* format, const char* sql)
+{
+    SqlThreadRole const role = GetSqlThreadRole();
+    if (!m_queryStats.IsTracked(role))
+    {
+        SqlConnection::Lock guard(getQueryConnection());
+        return guard->QueryNamed(sql);
+    }
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    QueryNamedResult* result;
+    {
+        SqlConnection::Lock guard(getQueryConnection());
+        result = guard->QueryNamed(sql);
+    }
+    m_queryStats.Record(role, format, sql, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return result;
 }
 
 bool Database::Execute(const char* sql)
@@ -365,6 +417,74 @@ bool Database::PExecute(const char* format, ...)
     return Execute(szQuery);
 }
 
+bool Database::DelayedUpdate(const char* table, const std::string& key, const char* column, const std::string& value, const std::string* raw)
+{
+    if (!m_pAsyncConn)
+        return false;
+
+    if (!m_writeBehind.GetWindow() || !m_allowAsyncTransactions || m_currentTransaction.get())
+    {
+        // a pending older value must not overwrite this one later
+        m_writeBehind.Discard(table, key, column);
+        return PExecute("UPDATE %s SET %s = %s WHERE %s", table, column, value.c_str(), key.c_str());
+    }
+
+    m_writeBehind.Add(table, key, column, value, raw ? *raw : value);
+    return true;
+}
+
+void Database::DiscardDelayedUpdate(const char* table, const std::string& key)
+{
+    m_writeBehind.Discard(table, key);
+}
+
+void Database::UpdateWriteBehind()
+{
+    WriteDelayedUpdates(false);
+}
+
+void Database::FlushWriteBehind()
+{
+    WriteDelayedUpdates(true);
+}
+
+bool Database::FlushDelayedUpdate(const char* table, const std::string& key, const char* column, std::string* raw)
+{
+    std::vector<std::string> statements;
+    bool const found = m_writeBehind.TakeRow(table, key, statements, column, raw);
+    if (!statements.empty())
+        WriteDelayedStatements(statements);
+    return found;
+}
+
+void Database::WriteDelayedUpdates(bool force)
+{
+    std::vector<std::string> statements;
+    if (m_writeBehind.Take(statements, force))
+        WriteDelayedStatements(statements);
+}
+
+void Database::WriteDelayedStatements(std::vector<std::string> const& statements)
+{
+    if (!m_pAsyncConn)
+        return;
+
+    // a transaction of its own, so updates made together by a handler are also written together, never
+    // a part of whatever transaction the caller happens to have open on this thread
+    SqlTransaction* trans = new SqlTransaction;
+    for (std::string const& sql : statements)
+        trans->DelayExecute(new SqlPlainRequest(sql.c_str()));
+
+    if (!m_allowAsyncTransactions || !m_threadBody)
+    {
+        trans->Execute(m_pAsyncConn);
+        delete trans;
+        return;
+    }
+
+    m_threadBody->Delay(trans);
+}
+
 bool Database::DirectPExecute(const char* format, ...)
 {
     if (!format)
@@ -24,6 +24,8 @@
 #include "Database/SqlDelayThread.h"
 #include "Policies/ThreadingModel.h"
 #include "SqlPreparedStatement.h"
+#include "SqlQueryStats.h"
+#include "SqlWriteBehind.h"
 
 #include <boost/thread/tss.hpp>
 #include <atomic>
@@ -111,17 +113,8 @@ class Database
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
-        inline QueryResult* Query(const char* sql)
-        {
-            SqlConnection::Lock guard(getQueryConnection());
-            return guard->Query(sql);
-        }
-
-        inline QueryNamedResult* QueryNamed(const char* sql)
-        {
-            SqlConnection::Lock guard(getQueryConnection());
-            return guard->QueryNamed(sql);
-        }
+        inline QueryResult* Query(const char* sql) { return DoQuery(sql, sql); }
+        inline QueryNamedResult* QueryNamed(const char* sql) { return DoQueryNamed(sql, sql); }
 
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
@@ -212,9 +205,29 @@ class Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
+        // async requests not yet picked up by the delay thread
+        size_t GetAsyncQueueSize() const { return m_threadBody ? m_threadBody->GetQueueSize() : 0; }
+
         // function to ping database connections
         void Ping();
 
+        // synchronous queries issued by world, map and network threads
+        SqlQueryStats& GetQueryStats() { return m_queryStats; }
+
+        // UPDATE table SET column = value WHERE key, held back for the WriteBehindWindow and merged with other
+        // updates of the same row. Written at once inside a transaction, where it has to stay atomic with the rest.
+        // raw is the value as it reads back, for FlushDelayedUpdate, when it differs from the SQL literal.
+        bool DelayedUpdate(const char* table, const std::string& key, const char* column, const std::string& value, const std::string* raw = nullptr);
+        // the row was written or deleted by other means, drops its pending update
+        void DiscardDelayedUpdate(const char* table, const std::string& key);
+        // write pending updates whose window passed, everything on flush
+        void UpdateWriteBehind();
+        void FlushWriteBehind();
+        // queue the pending update of one row. When 'column' is a part of it, returns true and its raw value,
+        // which the row reads back as once written, so callers reading it now do not have to wait for the write.
+        bool FlushDelayedUpdate(const char* table, const std::string& key, const char* column = nullptr, std::string* raw = nullptr);
+        SqlWriteBehind const& GetWriteBehind() const { return m_writeBehind; }
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
@@ -252,6 +265,10 @@ class Database
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
+        // format identifies the statement for the query statistics
+        QueryResult* DoQuery(const char* format, const char* sql);
+        QueryNamedResult* DoQueryNamed(const char* format, const char* sql);
+
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
         std::atomic_long m_nQueryCounter;  // counter for connection selection
@@ -285,5 +302,11 @@ class Database
         bool m_logSQL;
         std::string m_logsDir;
         uint32 m_pingIntervallms;
+
+        SqlQueryStats m_queryStats;
+        SqlWriteBehind m_writeBehind;
+
+        void WriteDelayedUpdates(bool force);
+        void WriteDelayedStatements(std::vector<std::string> const& statements);
 };
 #endif
@@ -39,6 +39,7 @@ class SqlDelayThread : public MaNGOS::Runnable
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
         std::atomic<bool> m_running;
+        std::atomic<size_t> m_queueSize;
 
         // process all enqueued requests
         void ProcessRequests();
@@ -52,9 +53,13 @@ class SqlDelayThread : public MaNGOS::Runnable
         {
             std::lock_guard<std::mutex> guard(m_queueMutex);
             m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            m_queueSize.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
 
+        ///< Number of statements, transactions and queries not executed yet, including the batch in progress
+        size_t GetQueueSize() const { return m_queueSize.load(std::memory_order_relaxed); }
+
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
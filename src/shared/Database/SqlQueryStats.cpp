@@ -0,0 +1,215 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlQueryStats.h"
+#include "Log.h"
+#include "Errors.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#define MAX_SQL_STAT_TEXT 512
+
+static thread_local SqlThreadRole s_sqlThreadRole = SQL_THREAD_OTHER;
+
+SqlThreadRole GetSqlThreadRole()
+{
+    return s_sqlThreadRole;
+}
+
+void SetSqlThreadRole(SqlThreadRole role)
+{
+    s_sqlThreadRole = role;
+}
+
+char const* GetSqlThreadRoleName(SqlThreadRole role)
+{
+    switch (role)
+    {
+        case SQL_THREAD_WORLD:   return "world";
+        case SQL_THREAD_MAP:     return "map";
+        case SQL_THREAD_NETWORK: return "network";
+        default:                 return "other";
+    }
+}
+
+uint64 SqlQueryStat::GetCalls() const
+{
+    uint64 total = 0;
+    for (uint64 count : calls)
+        total += count;
+    return total;
+}
+
+void SqlQueryStats::Initialize(std::string const& database, bool enabled, SqlStrictMode strictMode, uint32 slowTime)
+{
+    m_database = database;
+    m_enabled = enabled;
+    m_strictMode = strictMode;
+    m_slowTime = slowTime;
+
+#ifdef BUILD_METRICS
+    for (uint32 role = SQL_THREAD_WORLD; role < MAX_SQL_THREAD_ROLE; ++role)
+        m_timeMetric[role] = metric::histogram("db.sync_query", { { "database", database }, { "thread", GetSqlThreadRoleName(SqlThreadRole(role)) } });
+#endif
+}
+
+// literals and printf placeholders become '?', so all executions of one statement share a text
+std::string SqlQueryStats::Normalize(char const* sql)
+{
+    std::string text;
+    text.reserve(128);
+
+    for (char const* c = sql; *c && text.size() < MAX_SQL_STAT_TEXT; ++c)
+    {
+        if (*c == '\'' || *c == '"')
+        {
+            char const quote = *c;
+            while (c[1] && c[1] != quote)
+            {
+                if (c[1] == '\\' && c[2])
+                    ++c;
+                ++c;
+            }
+            if (c[1])
+                ++c;
+            text += '?';
+        }
+        else if (*c == '%' && c[1] == '%')
+        {
+            ++c;
+            text += '%';
+        }
+        else if (*c == '%' && c[1])
+        {
+            while (c[1] && !strchr("diouxXeEfgGcsp", c[1]))
+                ++c;
+            if (c[1])
+                ++c;
+            text += '?';
+        }
+        else if (isdigit(uint8(*c)) && (text.empty() || !(isalnum(uint8(text.back())) || text.back() == '_')))
+        {
+            while (isalnum(uint8(c[1])) || c[1] == '.')
+                ++c;
+            text += '?';
+        }
+        else
+            text += *c;
+    }
+
+    return text;
+}
+
+// FNV-1a
+uint32 SqlQueryStats::Hash(std::string const& sql)
+{
+    uint32 hash = 2166136261u;
+    for (char c : sql)
+    {
+        hash ^= uint8(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+SqlQueryStat& SqlQueryStats::GetStatement(std::string&& sql)
+{
+    uint32 const hash = Hash(sql);
+    auto bounds = m_statements.equal_range(hash);
+    for (auto itr = bounds.first; itr != bounds.second; ++itr)
+        if (itr->second.sql == sql)
+            return itr->second;
+
+    SqlQueryStat& statement = m_statements.emplace(hash, SqlQueryStat())->second;
+    statement.sql = std::move(sql);
+    statement.hash = hash;
+    return statement;
+}
+
+void SqlQueryStats::Record(SqlThreadRole role, char const* format, char const* sql, uint64 time)
+{
+#ifdef BUILD_METRICS
+    m_timeMetric[role].record(int64(time));
+#endif
+
+    bool const slow = m_slowTime && time >= uint64(m_slowTime) * 1000;
+    bool const strict = role == SQL_THREAD_MAP && m_strictMode != SQL_STRICT_OFF;
+    if (!m_enabled && !strict && !slow)
+        return;
+
+    std::string text = Normalize(format);
+    uint32 const hash = Hash(text);
+    bool firstFromMap = false;
+    if (m_enabled || strict)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        SqlQueryStat& statement = GetStatement(std::move(text));
+        ++statement.calls[role];
+        statement.totalTime += time;
+        statement.maxTime = std::max(statement.maxTime, time);
+
+        if (role == SQL_THREAD_MAP && !statement.reported)
+        {
+            statement.reported = true;
+            firstFromMap = true;
+        }
+    }
+
+    if (slow)
+        sLog.outError("SQL: synchronous query on %s thread took %u ms (%s, statement %08X): %s",
+                      GetSqlThreadRoleName(role), uint32(time / 1000), m_database.c_str(), hash, sql);
+
+    if (!strict)
+        return;
+
+    switch (m_strictMode)
+    {
+        case SQL_STRICT_LOG:
+            if (firstFromMap)
+                sLog.outError("SQL: synchronous query from map thread (%s, statement %08X): %s", m_database.c_str(), hash, sql);
+            break;
+        case SQL_STRICT_ASSERT:
+            sLog.outError("SQL: synchronous query from map thread (%s, statement %08X): %s", m_database.c_str(), hash, sql);
+            MANGOS_ASSERT(false && "synchronous query from map thread");
+            break;
+        default:
+            break;
+    }
+}
+
+void SqlQueryStats::GetTopStatements(std::vector<SqlQueryStat>& statements, uint32 count) const
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        statements.reserve(m_statements.size());
+        for (auto const& itr : m_statements)
+            statements.push_back(itr.second);
+    }
+
+    std::sort(statements.begin(), statements.end(), [](SqlQueryStat const& a, SqlQueryStat const& b) { return a.totalTime > b.totalTime; });
+    if (statements.size() > count)
+        statements.resize(count);
+}
+
+void SqlQueryStats::Reset()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_statements.clear();
+}
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __SQLQUERYSTATS_H
+#define __SQLQUERYSTATS_H
+
+#include "Common.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// what the calling thread is used for, only game threads have their synchronous queries tracked
+enum SqlThreadRole
+{
+    SQL_THREAD_OTHER    = 0,                                // startup, loaders, CLI, DB workers
+    SQL_THREAD_WORLD    = 1,
+    SQL_THREAD_MAP      = 2,
+    SQL_THREAD_NETWORK  = 3,
+};
+
+#define MAX_SQL_THREAD_ROLE 4
+
+enum SqlStrictMode
+{
+    SQL_STRICT_OFF      = 0,
+    SQL_STRICT_LOG      = 1,                                // log first synchronous query of every statement from a map thread
+    SQL_STRICT_ASSERT   = 2,                                // assert on any synchronous query from a map thread
+};
+
+SqlThreadRole GetSqlThreadRole();
+void SetSqlThreadRole(SqlThreadRole role);
+char const* GetSqlThreadRoleName(SqlThreadRole role);
+
+// switches the role of the current thread for the lifetime of the scope
+class SqlThreadRoleGuard
+{
+    public:
+        explicit SqlThreadRoleGuard(SqlThreadRole role) : m_previous(GetSqlThreadRole()) { SetSqlThreadRole(role); }
+        ~SqlThreadRoleGuard() { SetSqlThreadRole(m_previous); }
+
+        SqlThreadRoleGuard(SqlThreadRoleGuard const&) = delete;
+        SqlThreadRoleGuard& operator=(SqlThreadRoleGuard const&) = delete;
+
+    private:
+        SqlThreadRole m_previous;
+};
+
+// one statement, the format string of the query with literals stripped. Call sites issuing the same
+// statement share it.
+struct SqlQueryStat
+{
+    std::string sql;
+    uint32 hash = 0;
+    uint64 calls[MAX_SQL_THREAD_ROLE] = {};
+    uint64 totalTime = 0;                                   // microseconds
+    uint64 maxTime = 0;                                     // microseconds
+    bool reported = false;                                  // strict mode already logged this statement
+
+    uint64 GetCalls() const;
+};
+
+class SqlQueryStats
+{
+    public:
+        SqlQueryStats() : m_enabled(false), m_strictMode(SQL_STRICT_OFF), m_slowTime(0) {}
+
+        void Initialize(std::string const& database, bool enabled, SqlStrictMode strictMode, uint32 slowTime);
+
+        // true when a synchronous query from a thread of this role must be timed
+        bool IsTracked(SqlThreadRole role) const { return role != SQL_THREAD_OTHER && (m_enabled || m_strictMode != SQL_STRICT_OFF || m_slowTime); }
+
+        // format is the statement as written at the call site, sql the statement sent to the server,
+        // time in microseconds. Applies strict mode, which may not return for map threads.
+        void Record(SqlThreadRole role, char const* format, char const* sql, uint64 time);
+
+        // statements ordered by total time spent in them, at most 'count'
+        void GetTopStatements(std::vector<SqlQueryStat>& statements, uint32 count) const;
+        void Reset();
+
+        std::string const& GetDatabaseName() const { return m_database; }
+        bool IsEnabled() const { return m_enabled; }
+
+    private:
+        static std::string Normalize(char const* sql);
+        static uint32 Hash(std::string const& sql);
+
+        SqlQueryStat& GetStatement(std::string&& sql);      // m_lock must be held
+
+        std::string m_database;
+        bool m_enabled;
+        SqlStrictMode m_strictMode;
+        uint32 m_slowTime;                                  // milliseconds, 0 never logs
+
+        mutable std::mutex m_lock;
+        std::unordered_multimap<uint32, SqlQueryStat> m_statements;   // by Hash of the text, colliding texts are kept apart
+
+#ifdef BUILD_METRICS
+        metric::histogram m_timeMetric[MAX_SQL_THREAD_ROLE];     // microseconds
+#endif
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlWriteBehind.h"
+
+void SqlWriteBehind::Initialize(std::string const& database, uint32 window)
+{
+    m_window = window;
+
+#ifdef BUILD_METRICS
+    m_writtenMetric = metric::counter("db.write_behind", { { "database", database }, { "result", "written" } });
+    m_elidedMetric = metric::counter("db.write_behind", { { "database", database }, { "result", "elided" } });
+#endif
+}
+
+void SqlWriteBehind::Add(std::string const& table, std::string const& key, std::string const& column, std::string const& value, std::string const& raw)
+{
+    ++m_updates;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_pending.empty())
+        m_windowStart = std::chrono::steady_clock::now();
+
+    auto result = m_pending.emplace(RowKey(table, key), ColumnValues());
+    PendingValue& pending = result.first->second[column];
+    pending.value = value;
+    pending.raw = raw;
+
+    // merged into the statement of an already pending row
+    if (!result.second)
+    {
+        ++m_elided;
+#ifdef BUILD_METRICS
+        m_elidedMetric.add();
+#endif
+    }
+}
+
+void SqlWriteBehind::Discard(std::string const& table, std::string const& key, std::string const& column)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    auto itr = m_pending.find(RowKey(table, key));
+    if (itr == m_pending.end())
+        return;
+
+    if (!column.empty())
+    {
+        itr->second.erase(column);
+        if (!itr->second.empty())
+            return;
+    }
+
+    m_pending.erase(itr);
+    ++m_elided;
+#ifdef BUILD_METRICS
+    m_elidedMetric.add();
+#endif
+}
+
+bool SqlWriteBehind::Take(std::vector<std::string>& statements, bool force)
+{
+    PendingRows rows;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_pending.empty())
+            return false;
+
+        if (!force && std::chrono::steady_clock::now() - m_windowStart < std::chrono::milliseconds(m_window))
+            return false;
+
+        rows.swap(m_pending);
+    }
+
+    statements.reserve(statements.size() + rows.size());
+    for (auto const& row : rows)
+        statements.push_back(BuildUpdate(row.first, row.second));
+
+    m_written += rows.size();
+#ifdef BUILD_METRICS
+    m_writtenMetric.add(int64(rows.size()));
+#endif
+    return true;
+}
+
+bool SqlWriteBehind::TakeRow(std::string const& table, std::string const& key, std::vector<std::string>& statements,
+                             char const* column, std::string* raw)
+{
+    ColumnValues columns;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        auto itr = m_pending.find(RowKey(table, key));
+        if (itr == m_pending.end())
+            return false;
+
+        columns.swap(itr->second);
+        m_pending.erase(itr);
+    }
+
+    statements.push_back(BuildUpdate(RowKey(table, key), columns));
+
+    bool found = true;
+    if (column)
+    {
+        auto itr = columns.find(column);
+        found = itr != columns.end();
+        if (found && raw)
+            *raw = itr->second.raw;
+    }
+
+    ++m_written;
+#ifdef BUILD_METRICS
+    m_writtenMetric.add();
+#endif
+    return found;
+}
+
+std::string SqlWriteBehind::BuildUpdate(RowKey const& row, ColumnValues const& columns)
+{
+    std::string sql = "UPDATE " + row.first + " SET ";
+    for (auto itr = columns.begin(); itr != columns.end(); ++itr)
+    {
+        if (itr != columns.begin())
+            sql += ", ";
+        sql += itr->first + " = " + itr->second.value;
+    }
+    sql += " WHERE " + row.second;
+    return sql;
+}
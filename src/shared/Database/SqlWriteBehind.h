@@ -0,0 +1,97 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __SQLWRITEBEHIND_H
+#define __SQLWRITEBEHIND_H
+
+#include "Common.h"
+
+#ifdef BUILD_METRICS
+#include "Metric/Registry.h"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Holds back single column updates for the write-behind window. Updates of the same row are merged,
+ * a column updated again only keeps its last value, and all pending rows are written together once
+ * the window of the oldest one passed. A row is identified by its table and the WHERE condition of
+ * the update, so all callers updating a row must build the condition the same way.
+ */
+class SqlWriteBehind
+{
+    public:
+        SqlWriteBehind() : m_window(0), m_updates(0), m_written(0), m_elided(0) {}
+
+        void Initialize(std::string const& database, uint32 window);
+
+        // milliseconds, 0 writes every update at once
+        uint32 GetWindow() const { return m_window; }
+
+        // value is an SQL literal, raw the value it reads back as when that differs (quoted and escaped strings)
+        void Add(std::string const& table, std::string const& key, std::string const& column, std::string const& value, std::string const& raw);
+
+        // the row, or one column of it, was written or deleted by other means, its pending update is obsolete
+        void Discard(std::string const& table, std::string const& key, std::string const& column = std::string());
+
+        // one UPDATE per pending row once the window passed, or at once when forced
+        bool Take(std::vector<std::string>& statements, bool force);
+        // the UPDATE of one pending row regardless of the window, and the raw value of 'column' if it is a part of it
+        bool TakeRow(std::string const& table, std::string const& key, std::vector<std::string>& statements,
+                     char const* column = nullptr, std::string* raw = nullptr);
+
+        uint64 GetUpdates() const { return m_updates; }
+        uint64 GetWritten() const { return m_written; }
+        uint64 GetElided() const { return m_elided; }
+
+    private:
+        typedef std::pair<std::string, std::string> RowKey;                 // table, WHERE condition
+        struct PendingValue
+        {
+            std::string value;                                              // SQL literal
+            std::string raw;
+        };
+
+        typedef std::map<std::string, PendingValue> ColumnValues;
+        typedef std::map<RowKey, ColumnValues> PendingRows;
+
+        static std::string BuildUpdate(RowKey const& row, ColumnValues const& columns);
+
+        uint32 m_window;
+
+        std::mutex m_lock;
+        PendingRows m_pending;
+        std::chrono::steady_clock::time_point m_windowStart;                // first row pending since the last write
+
+        std::atomic<uint64> m_updates;
+        std::atomic<uint64> m_written;                                      // statements sent
+        std::atomic<uint64> m_elided;                                       // statements saved by merging or discarding
+
+#ifdef BUILD_METRICS
+        metric::counter m_writtenMetric;
+        metric::counter m_elidedMetric;
+#endif
+};
+
+#endif
@@ -24,6 +24,9 @@
 #include "ByteBuffer.h"
 #include "ProgressBar.h"
 
+#include <algorithm>
+#include <csignal>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <thread>
@@ -31,6 +34,12 @@
 
 #include <boost/stacktrace.hpp>
 
+#if PLATFORM == PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 INSTANTIATE_SINGLETON_1(Log);
 
 LogFilterData logFilterData[LOG_FILTER_COUNT] =
@@ -67,13 +76,308 @@ enum LogType
 
 const int LogType_count = int(LogError) + 1;
 
+// what a record is and where it goes besides console and main log file
+enum LogRecordType
+{
+    LOG_RECORD_WRAP = 0,                                    // ring buffer padding up to the buffer end
+    LOG_RECORD_STRING,
+    LOG_RECORD_ERROR,
+    LOG_RECORD_ERROR_DB,
+    LOG_RECORD_ERROR_EVENTAI,
+    LOG_RECORD_ERROR_SCRIPTLIB,
+    LOG_RECORD_COMMAND,
+    LOG_RECORD_CHAR,
+    LOG_RECORD_CHAR_DUMP,
+    LOG_RECORD_WORLD_PACKET,
+    LOG_RECORD_RA,
+    LOG_RECORD_CUSTOM,
+    LOG_RECORD_TRACE
+};
+
+enum LogRecordFlags
+{
+    LOG_RECORD_FLAG_CONSOLE = 0x01,
+    LOG_RECORD_FLAG_STDERR  = 0x02,
+    LOG_RECORD_FLAG_LOGFILE = 0x04
+};
+
+#define LOG_FORMAT_BUFFER_SIZE      2048                    // stack buffer, longer messages are formatted on the heap
+#define LOG_ASYNC_WRITE_INTERVAL    50                      // ms between writer passes when nobody wakes it up
+
+struct LogRecordHeader
+{
+    LogRecordHeader() : sequence(0), time(0), account(0), length(0), type(LOG_RECORD_WRAP), flags(0), color(0) {}
+    LogRecordHeader(LogRecordType _type, LogType _color, uint8 _flags) : sequence(0), time(0), account(0), length(0), type(_type), flags(_flags), color(_color) {}
+
+    uint64 sequence;                                        // global order across thread buffers
+    time_t time;                                            // taken at submit, not at write
+    uint32 account;                                         // per account gm log
+    uint32 length;                                          // text length without terminating zero
+    uint8 type;
+    uint8 flags;
+    uint8 color;
+};
+
+struct LogRecordEntry
+{
+    LogRecordHeader header;
+    char const* text;
+};
+
+static size_t const LOG_RECORD_ALIGN = alignof(LogRecordHeader);
+
+// Byte ring of variable sized records with one producer (the owning thread) and one consumer
+// (whoever holds Log::m_worldLogMtx). Records stay in place until Release so the consumer can
+// write them without copying. A full buffer drops the record and counts it instead of blocking.
+class LogRingBuffer
+{
+    public:
+        explicit LogRingBuffer(size_t capacity) :
+            m_dropped(0), m_orphaned(false), m_buffer(capacity & ~(LOG_RECORD_ALIGN - 1)), m_head(0), m_tail(0) {}
+
+        static size_t RecordSize(size_t length) { return (sizeof(LogRecordHeader) + length + 1 + LOG_RECORD_ALIGN - 1) & ~(LOG_RECORD_ALIGN - 1); }
+
+        // a record up to half the capacity always fits into an empty buffer whatever the wrap position
+        bool CanHold(size_t length) const { return RecordSize(length) <= m_buffer.size() / 2; }
+        bool IsHalfFull() const { return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed) >= m_buffer.size() / 2; }
+        bool IsEmpty() const { return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_relaxed); }
+
+        bool Push(LogRecordHeader const& record, char const* text)
+        {
+            size_t const capacity = m_buffer.size();
+            size_t const need = RecordSize(record.length);
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            size_t const head = m_head.load(std::memory_order_acquire);
+
+            size_t offset = tail % capacity;
+            size_t const toEnd = capacity - offset;
+            size_t const skip = toEnd < need ? toEnd : 0;
+
+            if (tail + skip + need - head > capacity)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (skip)
+            {
+                // too short tails are skipped by the consumer without a marker
+                if (skip >= sizeof(LogRecordHeader))
+                {
+                    LogRecordHeader wrap;
+                    memcpy(&m_buffer[offset], &wrap, sizeof(wrap));
+                }
+                tail += skip;
+                offset = 0;
+            }
+
+            memcpy(&m_buffer[offset], &record, sizeof(record));
+            memcpy(&m_buffer[offset + sizeof(record)], text, record.length);
+            m_buffer[offset + sizeof(record) + record.length] = '\0';
+
+            m_tail.store(tail + need, std::memory_order_release);
+            return true;
+        }
+
+        // appends all published records, returns the position to Release once they are written
+        size_t Peek(std::vector<LogRecordEntry>& records) const
+        {
+            return Visit([&records](LogRecordEntry const& entry) { records.push_back(entry); });
+        }
+
+        // calls visitor for every published record in order, returns the position to Release once they are written
+        template<typename Visitor>
+        size_t Visit(Visitor visitor) const
+        {
+            size_t const capacity = m_buffer.size();
+            size_t head = m_head.load(std::memory_order_relaxed);
+            size_t const tail = m_tail.load(std::memory_order_acquire);
+
+            while (head != tail)
+            {
+                size_t const offset = head % capacity;
+                size_t const toEnd = capacity - offset;
+                if (toEnd < sizeof(LogRecordHeader))
+                {
+                    head += toEnd;
+                    continue;
+                }
+
+                LogRecordEntry entry;
+                memcpy(&entry.header, &m_buffer[offset], sizeof(entry.header));
+                if (entry.header.type == LOG_RECORD_WRAP)
+                {
+                    head += toEnd;
+                    continue;
+                }
+
+                entry.text = &m_buffer[offset + sizeof(LogRecordHeader)];
+                visitor(entry);
+                head += RecordSize(entry.header.length);
+            }
+
+            return head;
+        }
+
+        void Release(size_t head) { m_head.store(head, std::memory_order_release); }
+
+        std::atomic<uint32> m_dropped;
+        std::atomic<bool> m_orphaned;                       // owning thread exited
+
+    private:
+        std::vector<char> m_buffer;
+        std::atomic<size_t> m_head;                         // consumer position, never wraps
+        std::atomic<size_t> m_tail;                         // producer position, never wraps
+};
+
+// per thread handle, the buffer itself is shared with the writer so it can still be drained after the thread exits
+struct LogThreadBuffer
+{
+    ~LogThreadBuffer()
+    {
+        if (buffer)
+            buffer->m_orphaned.store(true, std::memory_order_release);
+    }
+
+    std::shared_ptr<LogRingBuffer> buffer;
+};
+
+static thread_local LogThreadBuffer t_logBuffer;
+
+// descriptors for FlushOnCrash, taken while the files are opened since fileno is not async-signal-safe
+static int s_crashConsoleFds[2] = { -1, -1 };               // stdout, stderr
+static int s_crashLogFd = -1;                               // main log file
+static int s_crashRecordFds[LOG_RECORD_TRACE + 1];          // per record type file, -1 when not open
+
+static int CrashFd(FILE* file)
+{
+#if PLATFORM == PLATFORM_WINDOWS
+    return file ? _fileno(file) : -1;
+#else
+    return file ? fileno(file) : -1;
+#endif
+}
+
+static void CrashWrite(int fd, char const* data, size_t length)
+{
+    while (fd >= 0 && length)
+    {
+#if PLATFORM == PLATFORM_WINDOWS
+        int written = _write(fd, data, unsigned(length));
+#else
+        ssize_t written = write(fd, data, length);
+#endif
+        if (written <= 0)
+            return;
+        data += written;
+        length -= size_t(written);
+    }
+}
+
+// "YYYY-MM-DD HH:MM:SS UTC " without localtime, which may lock and allocate
+static size_t CrashTimestamp(char* out, time_t t)
+{
+    int64 const seconds = int64(t);
+    int64 days = seconds / DAY;
+    int64 rest = seconds % DAY;
+    if (rest < 0)
+    {
+        rest += DAY;
+        --days;
+    }
+
+    // civil date from days since 1970-01-01
+    days += 719468;
+    int64 const era = (days >= 0 ? days : days - 146096) / 146097;
+    int64 const dayOfEra = days - era * 146097;
+    int64 const yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64 const dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64 const mp = (5 * dayOfYear + 2) / 153;
+    int64 const day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int64 const month = mp < 10 ? mp + 3 : mp - 9;
+    int64 const year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    int64 const fields[] = { year, month, day, rest / HOUR, rest % HOUR / MINUTE, rest % MINUTE };
+    int const widths[] = { 4, 2, 2, 2, 2, 2 };
+    char const separators[] = { '-', '-', ' ', ':', ':', ' ' };
+
+    size_t length = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        int64 value = fields[i];
+        for (int digit = widths[i] - 1; digit >= 0; --digit)
+        {
+            out[length + digit] = char('0' + value % 10);
+            value /= 10;
+        }
+        length += widths[i];
+        out[length++] = separators[i];
+    }
+
+    memcpy(out + length, "UTC ", 4);
+    return length + 4;
+}
+
+#if PLATFORM != PLATFORM_WINDOWS
+static void LogCrashSignalHandler(int s)
+{
+    sLog.FlushOnCrash();
+
+    // let the default action produce the core dump
+    signal(s, SIG_DFL);
+    raise(s);
+}
+#endif
+
 Log::Log() :
     raLogfile(nullptr), logfile(nullptr), gmLogfile(nullptr), charLogfile(nullptr), dberLogfile(nullptr),
-    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr)
+    eventAiErLogfile(nullptr), scriptErrLogFile(nullptr), worldLogfile(nullptr), customLogFile(nullptr), m_colored(false), m_includeTime(false), m_gmlog_per_account(false), m_scriptLibName(nullptr),
+    m_asyncEnabled(false), m_asyncBufferSize(0), m_async(false), m_asyncStop(false), m_asyncSequence(0)
 {
     Initialize();
 }
 
+Log::~Log()
+{
+    StopAsyncWriter();
+
+    if (logfile != nullptr)
+        fclose(logfile);
+    logfile = nullptr;
+
+    if (gmLogfile != nullptr)
+        fclose(gmLogfile);
+    gmLogfile = nullptr;
+
+    if (charLogfile != nullptr)
+        fclose(charLogfile);
+    charLogfile = nullptr;
+
+    if (dberLogfile != nullptr)
+        fclose(dberLogfile);
+    dberLogfile = nullptr;
+
+    if (eventAiErLogfile != nullptr)
+        fclose(eventAiErLogfile);
+    eventAiErLogfile = nullptr;
+
+    if (scriptErrLogFile != nullptr)
+        fclose(scriptErrLogFile);
+    scriptErrLogFile = nullptr;
+
+    if (raLogfile != nullptr)
+        fclose(raLogfile);
+    raLogfile = nullptr;
+
+    if (worldLogfile != nullptr)
+        fclose(worldLogfile);
+    worldLogfile = nullptr;
+
+    if (customLogFile != nullptr)
+        fclose(customLogFile);
+    customLogFile = nullptr;
+}
+
 void Log::InitColors(const std::string& str)
 {
     if (str.empty())
@@ -285,6 +589,10 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // Async writer settings, the writer itself is started by the server once it is up
+    m_asyncEnabled = sConfig.GetBoolDefault("LogAsync", true);
+    m_asyncBufferSize = std::max(sConfig.GetIntDefault("LogAsyncBufferSize", 64), 4) * 1024;
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -315,9 +623,8 @@ FILE* Log::openGmlogPerAccount(uint32 account)
     return fopen(namebuf, "a");
 }
 
-void Log::outTimestamp(FILE* file)
+void Log::outTimestamp(FILE* file, time_t t)
 {
-    time_t t = time(nullptr);
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -328,9 +635,8 @@ void Log::outTimestamp(FILE* file)
     fprintf(file, "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
 }
 
-void Log::outTime() const
+void Log::outTime(time_t t) const
 {
-    time_t t = time(nullptr);
     tm* aTm = localtime(&t);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
@@ -359,18 +665,8 @@ std::string Log::GetTimestampStr()
 
 void Log::outString()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stdout);
+    LogRecordHeader record(LOG_RECORD_STRING, LogNormal, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_LOGFILE);
+    Submit(record, "");
 }
 
 void Log::outString(const char* str, ...)
@@ -378,38 +674,12 @@ void Log::outString(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
-
-    if (m_includeTime)
-        outTime();
+    LogRecordHeader record(LOG_RECORD_STRING, LogNormal, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_LOGFILE);
 
     va_list ap;
-
     va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
+    SubmitFormatted(record, str, ap);
     va_end(ap);
-
-    if (m_colored)
-        ResetColor(true);
-
-    printf("\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-
-        fflush(logfile);
-    }
-
-    fflush(stdout);
 }
 
 void Log::outError(const char* err, ...)
@@ -417,64 +687,18 @@ void Log::outError(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
+    LogRecordHeader record(LOG_RECORD_ERROR, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
 
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    SubmitFormatted(record, err, ap);
     va_end(ap);
-
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
-
-    fflush(stderr);
 }
 
 void Log::outErrorDb()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
-
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
-
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
-
-    fflush(stderr);
+    LogRecordHeader record(LOG_RECORD_ERROR_DB, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
+    Submit(record, "");
 }
 
 void Log::outErrorDb(const char* err, ...)
@@ -482,492 +706,602 @@ void Log::outErrorDb(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
-
-    if (m_includeTime)
-        outTime();
+    LogRecordHeader record(LOG_RECORD_ERROR_DB, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
 
     va_list ap;
-
     va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    SubmitFormatted(record, err, ap);
     va_end(ap);
+}
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+void Log::outErrorEventAI()
+{
+    LogRecordHeader record(LOG_RECORD_ERROR_EVENTAI, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
+    Submit(record, "");
+}
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
+void Log::outErrorEventAI(const char* err, ...)
+{
+    if (!err)
+        return;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    LogRecordHeader record(LOG_RECORD_ERROR_EVENTAI, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, err);
+    SubmitFormatted(record, err, ap);
+    va_end(ap);
+}
 
-    if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
+void Log::outBasic(const char* str, ...)
+{
+    if (!str)
+        return;
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
-        va_end(ap);
+    LogRecordHeader record(LOG_RECORD_STRING, LogDetails, 0);
+    if (m_logLevel >= LOG_LVL_BASIC)
+        record.flags |= LOG_RECORD_FLAG_CONSOLE;
+    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
+        record.flags |= LOG_RECORD_FLAG_LOGFILE;
 
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
+    if (!record.flags)
+        return;
 
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
 }
 
-void Log::outErrorEventAI()
+void Log::outDetail(const char* str, ...)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    if (!str)
+        return;
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+    LogRecordHeader record(LOG_RECORD_STRING, LogDetails, 0);
+    if (m_logLevel >= LOG_LVL_DETAIL)
+        record.flags |= LOG_RECORD_FLAG_CONSOLE;
+    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
+        record.flags |= LOG_RECORD_FLAG_LOGFILE;
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    if (!record.flags)
+        return;
 
-    fflush(stderr);
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
 }
 
-void Log::outErrorEventAI(const char* err, ...)
+void Log::outDebug(const char* str, ...)
 {
-    if (!err)
+    if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    LogRecordHeader record(LOG_RECORD_STRING, LogDebug, 0);
+    if (m_logLevel >= LOG_LVL_DEBUG)
+        record.flags |= LOG_RECORD_FLAG_CONSOLE;
+    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
+        record.flags |= LOG_RECORD_FLAG_LOGFILE;
 
-    if (m_includeTime)
-        outTime();
+    if (!record.flags)
+        return;
 
     va_list ap;
-
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
     va_end(ap);
+}
 
-    if (m_colored)
-        ResetColor(false);
-
-    fprintf(stderr, "\n");
+void Log::outCommand(uint32 account, const char* str, ...)
+{
+    if (!str)
+        return;
 
-    if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
+    LogRecordHeader record(LOG_RECORD_COMMAND, LogDetails, 0);
+    record.account = account;
+    if (m_logLevel >= LOG_LVL_DETAIL)
+        record.flags |= LOG_RECORD_FLAG_CONSOLE;
+    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
+        record.flags |= LOG_RECORD_FLAG_LOGFILE;
 
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+    if (!record.flags && !m_gmlog_per_account && !gmLogfile)
+        return;
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
+}
 
-    if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
+void Log::outChar(const char* str, ...)
+{
+    if (!str || !charLogfile)
+        return;
 
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
-        va_end(ap);
+    LogRecordHeader record(LOG_RECORD_CHAR, LogNormal, 0);
 
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
+}
 
-    fflush(stderr);
+void Log::outErrorScriptLib()
+{
+    LogRecordHeader record(LOG_RECORD_ERROR_SCRIPTLIB, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
+    Submit(record, "");
 }
 
-void Log::outBasic(const char* str, ...)
+void Log::outErrorScriptLib(const char* err, ...)
 {
-    if (!str)
+    if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_BASIC)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+    LogRecordHeader record(LOG_RECORD_ERROR_SCRIPTLIB, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
 
-        if (m_includeTime)
-            outTime();
+    va_list ap;
+    va_start(ap, err);
+    SubmitFormatted(record, err, ap);
+    va_end(ap);
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
+{
+    if (!worldLogfile)
+        return;
 
-        if (m_colored)
-            ResetColor(true);
+    char header[256];
+    int headerLength = snprintf(header, sizeof(header), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+                                incoming ? "CLIENT" : "SERVER",
+                                socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    if (headerLength < 0)
+        return;
 
-        printf("\n");
-    }
+    std::string dump(header, std::min(size_t(headerLength), sizeof(header) - 1));
+    dump.reserve(dump.size() + packet.size() * 3 + packet.size() / 16 + 3);
 
-    if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
+    static char const hex[] = "0123456789ABCDEF";
+    size_t p = 0;
+    while (p < packet.size())
     {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
+        for (size_t j = 0; j < 16 && p < packet.size(); ++j)
+        {
+            uint8 byte = packet[p++];
+            dump += hex[byte >> 4];
+            dump += hex[byte & 0x0F];
+            dump += ' ';
+        }
+
+        dump += '\n';
     }
 
-    fflush(stdout);
+    dump += "\n\n";
+
+    LogRecordHeader record(LOG_RECORD_WORLD_PACKET, LogNormal, 0);
+    record.length = uint32(dump.size());
+    Submit(record, dump.c_str());
 }
 
-void Log::outDetail(const char* str, ...)
+void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    if (!str)
+    if (!charLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+    char header[256];
+    snprintf(header, sizeof(header), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
 
-        if (m_includeTime)
-            outTime();
+    std::string dump(header);
+    dump.append(str);
+    dump.append("\n== END DUMP ==\n");
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    LogRecordHeader record(LOG_RECORD_CHAR_DUMP, LogNormal, 0);
+    record.length = uint32(dump.size());
+    Submit(record, dump.c_str());
+}
 
-        if (m_colored)
-            ResetColor(true);
+void Log::outRALog(const char* str, ...)
+{
+    if (!str || !raLogfile)
+        return;
 
-        printf("\n");
-    }
+    LogRecordHeader record(LOG_RECORD_RA, LogNormal, 0);
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
-    {
-        outTimestamp(logfile);
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
+}
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+void Log::outCustomLog(const char* str, ...)
+{
+    if (!str || !customLogFile)
+        return;
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
-    }
+    LogRecordHeader record(LOG_RECORD_CUSTOM, LogNormal, 0);
 
-    fflush(stdout);
+    va_list ap;
+    va_start(ap, str);
+    SubmitFormatted(record, str, ap);
+    va_end(ap);
 }
 
-void Log::outDebug(const char* str, ...)
+void Log::SubmitFormatted(LogRecordHeader& record, char const* format, va_list ap)
 {
-    if (!str)
-        return;
+    char buffer[LOG_FORMAT_BUFFER_SIZE];
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DEBUG)
-    {
-        if (m_colored)
-            SetColor(true, m_colors[LogDebug]);
+    va_list copy;
+    va_copy(copy, ap);
+    int length = vsnprintf(buffer, sizeof(buffer), format, copy);
+    va_end(copy);
 
-        if (m_includeTime)
-            outTime();
-
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+    if (length < 0)
+        return;
 
-        if (m_colored)
-            ResetColor(true);
+    record.length = uint32(length);
 
-        printf("\n");
+    if (size_t(length) < sizeof(buffer))
+    {
+        Submit(record, buffer);
+        return;
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
+    std::string text(length + 1, '\0');
+    vsnprintf(&text[0], text.size(), format, ap);
+    Submit(record, text.c_str());
+}
+
+void Log::Submit(LogRecordHeader& record, char const* text)
+{
+    record.time = time(nullptr);
+
+    if (m_async.load(std::memory_order_acquire))
     {
-        outTimestamp(logfile);
+        LogRingBuffer* buffer = GetThreadBuffer();
 
-        va_list ap;
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        va_end(ap);
+        // records larger than half a buffer are rare (packet and char dumps) and written directly
+        if (buffer->CanHold(record.length))
+        {
+            record.sequence = m_asyncSequence.fetch_add(1, std::memory_order_relaxed);
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+            // errors are worth an immediate writer pass, everything else waits for the next interval
+            // unless the buffer gets tight
+            if (buffer->Push(record, text) && ((record.flags & LOG_RECORD_FLAG_STDERR) || buffer->IsHalfFull()))
+                m_asyncWakeCondition.notify_one();
+            return;
+        }
     }
 
-    fflush(stdout);
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    WriteRecord(record, text);
+    FlushFiles();
 }
 
-void Log::outCommand(uint32 account, const char* str, ...)
+// must be called with m_worldLogMtx held
+void Log::WriteRecord(LogRecordHeader const& record, char const* text)
 {
-    if (!str)
-        return;
-
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_logLevel >= LOG_LVL_DETAIL)
+    if (record.flags & LOG_RECORD_FLAG_CONSOLE)
     {
-        if (m_colored)
-            SetColor(true, m_colors[LogDetails]);
+        bool stdout_stream = !(record.flags & LOG_RECORD_FLAG_STDERR);
+        FILE* stream = stdout_stream ? stdout : stderr;
+        bool colored = m_colored && record.length;
+
+        if (colored)
+            SetColor(stdout_stream, m_colors[record.color]);
 
         if (m_includeTime)
-            outTime();
+            outTime(record.time);
 
-        va_list ap;
-        va_start(ap, str);
-        vutf8printf(stdout, str, &ap);
-        va_end(ap);
+        utf8printf(stream, "%s", text);
 
-        if (m_colored)
-            ResetColor(true);
+        if (colored)
+            ResetColor(stdout_stream);
 
-        printf("\n");
+        fprintf(stream, "\n");
     }
 
-    if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
+    if (logfile && (record.flags & LOG_RECORD_FLAG_LOGFILE))
     {
-        va_list ap;
-        outTimestamp(logfile);
-        va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
-        va_end(ap);
-        fflush(logfile);
-    }
+        outTimestamp(logfile, record.time);
 
-    if (m_gmlog_per_account)
-    {
-        if (FILE* per_file = openGmlogPerAccount(account))
+        switch (record.type)
         {
-            va_list ap;
-            outTimestamp(per_file);
-            va_start(ap, str);
-            vfprintf(per_file, str, ap);
-            fprintf(per_file, "\n");
-            va_end(ap);
-            fclose(per_file);
+            case LOG_RECORD_ERROR:
+            case LOG_RECORD_ERROR_DB:
+                fprintf(logfile, "ERROR:%s\n", text);
+                break;
+            case LOG_RECORD_ERROR_EVENTAI:
+                fprintf(logfile, record.length ? "ERROR CreatureEventAI: %s\n" : "ERROR CreatureEventAI%s\n", text);
+                break;
+            case LOG_RECORD_ERROR_SCRIPTLIB:
+                if (m_scriptLibName)
+                    fprintf(logfile, "<%s ERROR>: %s\n", m_scriptLibName, text);
+                else
+                    fprintf(logfile, "<Scripting Library ERROR>: %s\n", text);
+                break;
+            default:
+                fprintf(logfile, "%s\n", text);
+                break;
         }
     }
-    else if (gmLogfile)
+
+    FILE* file = nullptr;
+    bool timestamp = true;
+    bool newline = true;
+
+    switch (record.type)
     {
-        va_list ap;
-        outTimestamp(gmLogfile);
-        va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
-        va_end(ap);
-        fflush(gmLogfile);
+        case LOG_RECORD_ERROR_DB:
+            file = dberLogfile;
+            break;
+        case LOG_RECORD_ERROR_EVENTAI:
+            file = eventAiErLogfile;
+            break;
+        case LOG_RECORD_ERROR_SCRIPTLIB:
+            file = scriptErrLogFile;
+            break;
+        case LOG_RECORD_COMMAND:
+            if (m_gmlog_per_account)
+            {
+                if (FILE* per_file = openGmlogPerAccount(record.account))
+                {
+                    outTimestamp(per_file, record.time);
+                    fprintf(per_file, "%s\n", text);
+                    fclose(per_file);
+                }
+                return;
+            }
+            file = gmLogfile;
+            break;
+        case LOG_RECORD_CHAR:
+            file = charLogfile;
+            break;
+        case LOG_RECORD_CHAR_DUMP:
+            file = charLogfile;
+            timestamp = false;
+            newline = false;
+            break;
+        case LOG_RECORD_WORLD_PACKET:
+            file = worldLogfile;
+            newline = false;
+            break;
+        case LOG_RECORD_RA:
+            file = raLogfile;
+            break;
+        case LOG_RECORD_CUSTOM:
+            file = customLogFile;
+            break;
+        case LOG_RECORD_TRACE:
+            file = customLogFile;
+            timestamp = false;
+            break;
+        default:
+            break;
     }
 
-    fflush(stdout);
-}
-
-void Log::outChar(const char* str, ...)
-{
-    if (!str)
+    if (!file)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (charLogfile)
-    {
-        va_list ap;
-        outTimestamp(charLogfile);
-        va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
-        va_end(ap);
-        fflush(charLogfile);
-    }
+    if (timestamp)
+        outTimestamp(file, record.time);
+
+    fprintf(file, newline ? "%s\n" : "%s", text);
 }
 
-void Log::outErrorScriptLib()
+// must be called with m_worldLogMtx held
+void Log::FlushFiles()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-
-    fprintf(stderr, "\n");
+    FILE* files[] = { stdout, stderr, logfile, gmLogfile, charLogfile, dberLogfile, eventAiErLogfile, scriptErrLogFile, raLogfile, worldLogfile, customLogFile };
+    for (FILE* file : files)
+        if (file)
+            fflush(file);
+}
 
-    if (logfile)
+LogRingBuffer* Log::GetThreadBuffer()
+{
+    if (!t_logBuffer.buffer)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
-    }
+        t_logBuffer.buffer = std::make_shared<LogRingBuffer>(m_asyncBufferSize);
 
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
+        std::lock_guard<std::mutex> guard(m_asyncBuffersMtx);
+        m_asyncBuffers.push_back(t_logBuffer.buffer);
     }
 
-    fflush(stderr);
+    return t_logBuffer.buffer.get();
 }
 
-void Log::outErrorScriptLib(const char* err, ...)
+void Log::StartAsyncWriter()
 {
-    if (!err)
+    if (!m_asyncEnabled || m_asyncWriter.joinable())
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    CacheCrashFds();
 
-    if (m_includeTime)
-        outTime();
+    m_asyncStop.store(false, std::memory_order_release);
+    m_asyncWriter = std::thread(&Log::AsyncWriterLoop, this);
+    m_async.store(true, std::memory_order_release);
 
-    va_list ap;
+#if PLATFORM != PLATFORM_WINDOWS
+    // queued output is the most interesting part of a crash, windows flushes from WheatyExceptionReport
+    signal(SIGSEGV, LogCrashSignalHandler);
+    signal(SIGBUS, LogCrashSignalHandler);
+    signal(SIGFPE, LogCrashSignalHandler);
+    signal(SIGILL, LogCrashSignalHandler);
+    signal(SIGABRT, LogCrashSignalHandler);
+#endif
+}
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+void Log::StopAsyncWriter()
+{
+    if (!m_asyncWriter.joinable())
+        return;
 
-    if (m_colored)
-        ResetColor(false);
+    // new records go the synchronous way from here, the writer drains what is left before it exits
+    m_async.store(false, std::memory_order_release);
+    m_asyncStop.store(true, std::memory_order_release);
+    m_asyncWakeCondition.notify_one();
+    m_asyncWriter.join();
 
-    fprintf(stderr, "\n");
+    // records pushed by threads that saw the async flag just before it was cleared
+    Flush();
+}
 
-    if (logfile)
+void Log::AsyncWriterLoop()
+{
+    while (!m_asyncStop.load(std::memory_order_acquire))
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-
-        va_start(ap, err);
-        vfprintf(logfile, err, ap);
-        va_end(ap);
+        {
+            std::unique_lock<std::mutex> lock(m_asyncWakeMtx);
+            m_asyncWakeCondition.wait_for(lock, std::chrono::milliseconds(LOG_ASYNC_WRITE_INTERVAL));
+        }
 
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        Flush();
     }
 
-    if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
-        va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
-        va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
+    Flush();
+}
 
-    fflush(stderr);
+void Log::Flush()
+{
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    DrainBuffers();
 }
 
-void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
+void Log::FlushOnCrash()
 {
-    if (!worldLogfile)
+    // called from signal handlers, the crashing thread may hold either lock itself, so never block
+    // on them. When the writer or a registering thread holds a lock the pending records are lost
+    // rather than risking a deadlock of the crash path. Only write(2) on the descriptors cached by
+    // CacheCrashFds is used, no stdio, localtime or allocation; what stdio still buffers is lost.
+    if (!m_worldLogMtx.try_lock())
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!m_asyncBuffersMtx.try_lock())
+    {
+        m_worldLogMtx.unlock();
+        return;
+    }
 
-    outTimestamp(worldLogfile);
+    // records are written per thread in order, without the cross thread sort of DrainBuffers
+    for (auto const& buffer : m_asyncBuffers)
+    {
+        size_t head = buffer->Visit([](LogRecordEntry const& entry)
+        {
+            LogRecordHeader const& record = entry.header;
+            bool const newline = record.type != LOG_RECORD_WORLD_PACKET && record.type != LOG_RECORD_CHAR_DUMP;
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+            char timestamp[32];
+            size_t const timestampLength = CrashTimestamp(timestamp, record.time);
 
-    size_t p = 0;
-    while (p < packet.size())
-    {
-        for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+            if (record.flags & LOG_RECORD_FLAG_CONSOLE)
+            {
+                int const fd = s_crashConsoleFds[(record.flags & LOG_RECORD_FLAG_STDERR) ? 1 : 0];
+                CrashWrite(fd, entry.text, record.length);
+                CrashWrite(fd, "\n", 1);
+            }
+
+            if (record.flags & LOG_RECORD_FLAG_LOGFILE)
+            {
+                CrashWrite(s_crashLogFd, timestamp, timestampLength);
+                CrashWrite(s_crashLogFd, entry.text, record.length);
+                CrashWrite(s_crashLogFd, "\n", 1);
+            }
 
-        fprintf(worldLogfile, "\n");
+            // per account gm logs are opened per record, their fd stays -1
+            if (record.type > LOG_RECORD_TRACE)
+                return;
+
+            int const fd = s_crashRecordFds[record.type];
+            if (newline)
+                CrashWrite(fd, timestamp, timestampLength);
+            CrashWrite(fd, entry.text, record.length);
+            if (newline)
+                CrashWrite(fd, "\n", 1);
+        });
+        buffer->Release(head);
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    m_asyncBuffersMtx.unlock();
+    m_worldLogMtx.unlock();
 }
 
-void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
+// must be called with m_worldLogMtx held or before the async writer starts
+void Log::CacheCrashFds()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    s_crashConsoleFds[0] = CrashFd(stdout);
+    s_crashConsoleFds[1] = CrashFd(stderr);
+    s_crashLogFd = CrashFd(logfile);
+
+    for (int& fd : s_crashRecordFds)
+        fd = -1;
+
+    s_crashRecordFds[LOG_RECORD_ERROR_DB] = CrashFd(dberLogfile);
+    s_crashRecordFds[LOG_RECORD_ERROR_EVENTAI] = CrashFd(eventAiErLogfile);
+    s_crashRecordFds[LOG_RECORD_ERROR_SCRIPTLIB] = CrashFd(scriptErrLogFile);
+    s_crashRecordFds[LOG_RECORD_COMMAND] = m_gmlog_per_account ? -1 : CrashFd(gmLogfile);
+    s_crashRecordFds[LOG_RECORD_CHAR] = CrashFd(charLogfile);
+    s_crashRecordFds[LOG_RECORD_CHAR_DUMP] = CrashFd(charLogfile);
+    s_crashRecordFds[LOG_RECORD_WORLD_PACKET] = CrashFd(worldLogfile);
+    s_crashRecordFds[LOG_RECORD_RA] = CrashFd(raLogfile);
+    s_crashRecordFds[LOG_RECORD_CUSTOM] = CrashFd(customLogFile);
+    s_crashRecordFds[LOG_RECORD_TRACE] = CrashFd(customLogFile);
+}
 
-    if (charLogfile)
+// must be called with m_worldLogMtx held
+void Log::DrainBuffers()
+{
     {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
+        std::lock_guard<std::mutex> guard(m_asyncBuffersMtx);
+        m_drainBuffers = m_asyncBuffers;
     }
-}
 
-void Log::outRALog(const char* str, ...)
-{
-    if (!str)
+    if (m_drainBuffers.empty())
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (raLogfile)
+    m_drainRecords.clear();
+    m_drainHeads.clear();
+
+    uint32 dropped = 0;
+    for (auto& buffer : m_drainBuffers)
     {
-        va_list ap;
-        outTimestamp(raLogfile);
-        va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
-        va_end(ap);
-        fflush(raLogfile);
+        dropped += buffer->m_dropped.exchange(0, std::memory_order_relaxed);
+        m_drainHeads.push_back(buffer->Peek(m_drainRecords));
     }
 
-    fflush(stdout);
-}
+    // restore the submit order across threads
+    std::sort(m_drainRecords.begin(), m_drainRecords.end(), [](LogRecordEntry const& a, LogRecordEntry const& b)
+    {
+        return a.header.sequence < b.header.sequence;
+    });
 
-void Log::outCustomLog(const char* str, ...)
-{
-    if (!str)
-        return;
+    if (dropped)
+    {
+        char text[128];
+        LogRecordHeader record(LOG_RECORD_ERROR, LogError, LOG_RECORD_FLAG_CONSOLE | LOG_RECORD_FLAG_STDERR | LOG_RECORD_FLAG_LOGFILE);
+        record.time = time(nullptr);
+        record.length = uint32(snprintf(text, sizeof(text), "Log: %u messages dropped, per thread log buffers are full (LogAsyncBufferSize)", dropped));
+        WriteRecord(record, text);
+    }
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (customLogFile)
+    for (auto const& entry : m_drainRecords)
+        WriteRecord(entry.header, entry.text);
+
+    for (size_t i = 0; i < m_drainBuffers.size(); ++i)
+        m_drainBuffers[i]->Release(m_drainHeads[i]);
+
+    if (dropped || !m_drainRecords.empty())
+        FlushFiles();
+
+    // forget buffers of exited threads once they are written out
     {
-        va_list ap;
-        outTimestamp(customLogFile);
-        va_start(ap, str);
-        vfprintf(customLogFile, str, ap);
-        fprintf(customLogFile, "\n");
-        va_end(ap);
-        fflush(customLogFile);
+        std::lock_guard<std::mutex> guard(m_asyncBuffersMtx);
+        m_asyncBuffers.erase(std::remove_if(m_asyncBuffers.begin(), m_asyncBuffers.end(), [](std::shared_ptr<LogRingBuffer> const& buffer)
+        {
+            return buffer->m_orphaned.load(std::memory_order_acquire) && buffer->IsEmpty();
+        }), m_asyncBuffers.end());
     }
 
-    fflush(stdout);
+    m_drainBuffers.clear();
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -995,6 +1329,8 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
+    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
     m_scriptLibName = libName;
 
     if (scriptErrLogFile)
@@ -1003,12 +1339,14 @@ void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
     if (!fname)
     {
         scriptErrLogFile = nullptr;
+        CacheCrashFds();
         return;
     }
 
     std::string fileName = m_logsDir;
     fileName.append(fname);
     scriptErrLogFile = fopen(fileName.c_str(), "a");
+    CacheCrashFds();
 }
 
 void outstring_log()
@@ -1107,14 +1445,14 @@ void script_error_log(const char* str, ...)
 
 void Log::traceLog()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (customLogFile)
-    {
-        fprintf(customLogFile, "%s\n", GetTraceLog().data());
-        fflush(customLogFile);
-    }
+    if (!customLogFile)
+        return;
+
+    std::string trace = GetTraceLog();
 
-    fflush(stdout);
+    LogRecordHeader record(LOG_RECORD_TRACE, LogNormal, 0);
+    record.length = uint32(trace.size());
+    Submit(record, trace.c_str());
 }
 
 // has to be in a locked enviroment on linux
@@ -22,10 +22,19 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 class Config;
 class ByteBuffer;
+class LogRingBuffer;
+struct LogRecordHeader;
+struct LogRecordEntry;
 
 enum LogLevel
 {
@@ -97,44 +106,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         friend class MaNGOS::OperatorNew<Log>;
         Log();
 
-        ~Log()
-        {
-            if (logfile != nullptr)
-                fclose(logfile);
-            logfile = nullptr;
-
-            if (gmLogfile != nullptr)
-                fclose(gmLogfile);
-            gmLogfile = nullptr;
-
-            if (charLogfile != nullptr)
-                fclose(charLogfile);
-            charLogfile = nullptr;
-
-            if (dberLogfile != nullptr)
-                fclose(dberLogfile);
-            dberLogfile = nullptr;
-
-            if (eventAiErLogfile != nullptr)
-                fclose(eventAiErLogfile);
-            eventAiErLogfile = nullptr;
-
-            if (scriptErrLogFile != nullptr)
-                fclose(scriptErrLogFile);
-            scriptErrLogFile = nullptr;
-
-            if (raLogfile != nullptr)
-                fclose(raLogfile);
-            raLogfile = nullptr;
-
-            if (worldLogfile != nullptr)
-                fclose(worldLogfile);
-            worldLogfile = nullptr;
-
-            if (customLogFile != nullptr)
-                fclose(customLogFile);
-            customLogFile = nullptr;
-        }
+        ~Log();
     public:
         void Initialize();
         void InitColors(const std::string& str);
@@ -176,8 +148,8 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         void SetLogFileLevel(char* level);
         void SetColor(bool stdout_stream, Color color);
         void ResetColor(bool stdout_stream);
-        void outTime() const;
-        static void outTimestamp(FILE* file);
+        void outTime(time_t t) const;
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
         bool HasLogFilter(uint32 filter) const { return (m_logFilter & filter) != 0; }
         void SetLogFilter(LogFilters filter, bool on) { if (on) m_logFilter |= filter; else m_logFilter &= ~filter; }
@@ -193,7 +165,24 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         void traceLog();
 
+        // Asynchronous output: callers only format into their own thread's ring buffer and
+        // a single writer thread drains all of them to the console and files
+        void StartAsyncWriter();
+        void StopAsyncWriter();
+        void Flush();                                       // write everything queued so far
+        void FlushOnCrash();                                // best effort Flush for crash handlers
+
     private:
+        void Submit(LogRecordHeader& record, char const* text);
+        void SubmitFormatted(LogRecordHeader& record, char const* format, va_list ap);
+        void WriteRecord(LogRecordHeader const& record, char const* text);
+        void FlushFiles();
+        void CacheCrashFds();
+
+        LogRingBuffer* GetThreadBuffer();
+        void AsyncWriterLoop();
+        void DrainBuffers();
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -230,6 +219,24 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         std::string m_gmlog_filename_format;
 
         char const* m_scriptLibName;
+
+        // async writer control
+        bool m_asyncEnabled;
+        uint32 m_asyncBufferSize;
+        std::atomic<bool> m_async;
+        std::atomic<bool> m_asyncStop;
+        std::atomic<uint64> m_asyncSequence;
+        std::thread m_asyncWriter;
+        std::mutex m_asyncWakeMtx;
+        std::condition_variable m_asyncWakeCondition;
+
+        std::mutex m_asyncBuffersMtx;                       // guards registration only
+        std::vector<std::shared_ptr<LogRingBuffer> > m_asyncBuffers;
+
+        // reused by DrainBuffers, guarded by m_worldLogMtx
+        std::vector<std::shared_ptr<LogRingBuffer> > m_drainBuffers;
+        std::vector<size_t> m_drainHeads;
+        std::vector<LogRecordEntry> m_drainRecords;
 };
 
 #define sLog MaNGOS::Singleton<Log>::Instance()
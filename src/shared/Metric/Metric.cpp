@@ -84,6 +84,8 @@ metric::metric::~metric()
     if (!m_enabled)
         return;
 
+    registry::set_enabled(false);
+
     m_writeService.post([&] {
         m_sendTimer->cancel();
     });
@@ -100,6 +102,8 @@ void metric::metric::initialize()
     if (!(m_enabled = sConfig.GetBoolDefault("Metric.Enable", false)))
         return;
 
+    registry::set_enabled(true);
+
     m_connectionInfo = {
         sConfig.GetStringDefault("Metric.Address", "127.0.0.1"),
         sConfig.GetIntDefault("Metric.Port", 8086),
@@ -202,7 +206,12 @@ void metric::metric::send()
         std::swap(measurements, m_measurementQueue);
     }
 
-    sLog.outDetail("Sending %zu measurements!", measurements.size());
+    // pre-registered series are aggregated here, once per send interval
+    std::stringstream payload;
+    auto now = std::chrono::system_clock::now();
+    uint32 collected = registry::instance().collect(payload, std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count());
+
+    sLog.outDetail("Sending %zu measurements and %u series!", measurements.size(), collected);
 
     using boost::asio::ip::tcp;
 
@@ -236,10 +245,9 @@ void metric::metric::send()
         return;
     }
 
-    std::stringstream payload;
     for (auto const& measurement : measurements)
     {
-        if (&measurement != &measurements.front())
+        if (collected || &measurement != &measurements.front())
             payload << "\n";
 
         payload << *measurement;
@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "Measurement.h"
+#include "Registry.h"
 #include "Common.h"
 
 struct MetricConnectionInfo
@@ -105,6 +106,31 @@ namespace metric
             std::chrono::high_resolution_clock::time_point m_startTime;
     };
 
+    // reports only scopes that took at least threshold; tags and extra fields are built in that case only,
+    // so frequently executed code does not pay for formatting them
+    template <class precision, class Describe>
+    class slow_duration
+    {
+        public:
+            slow_duration(char const* name, int64 threshold, Describe describe)
+                : m_name(name), m_threshold(threshold), m_describe(std::move(describe)), m_startTime(std::chrono::high_resolution_clock::now())
+            {}
+
+            ~slow_duration();
+
+        private:
+            char const* m_name;
+            int64 m_threshold;
+            Describe m_describe;
+            std::chrono::high_resolution_clock::time_point m_startTime;
+    };
+
+    template <class precision, class Describe>
+    slow_duration<precision, Describe> make_slow_duration(char const* name, int64 threshold, Describe describe)
+    {
+        return slow_duration<precision, Describe>(name, threshold, std::move(describe));
+    }
+
     class metric
     {
         public:
@@ -139,6 +165,25 @@ namespace metric
             void prepare_send(const boost::system::error_code& ec);
             void send();
     };
+
+    template <class precision, class Describe>
+    slow_duration<precision, Describe>::~slow_duration()
+    {
+        if (!registry::enabled())
+            return;
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = static_cast<int64>(std::chrono::duration_cast<precision>(endTime - m_startTime).count());
+        if (duration < m_threshold)
+            return;
+
+        std::map<std::string, std::string> tags;
+        std::map<std::string, boost::any> fields;
+        m_describe(tags, fields);
+        fields["duration"] = duration;
+
+        metric::instance().report(m_name, fields, tags);
+    }
 }
 
 #endif // MANGOSSERVER_METRIC_H
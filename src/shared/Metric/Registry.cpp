@@ -0,0 +1,287 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "Log.h"
+#include "Registry.h"
+
+std::atomic<bool> metric::registry::s_enabled(false);
+
+namespace
+{
+    struct thread_slots_holder
+    {
+        ~thread_slots_holder()
+        {
+            if (slots)
+                slots->orphaned.store(true, std::memory_order_release);
+        }
+
+        std::shared_ptr<metric::thread_slots> slots;
+    };
+
+    thread_local thread_slots_holder t_slots;
+
+    // line protocol: commas and spaces in measurement names, commas, spaces and equal signs in tags
+    void escape(std::string& out, std::string const& value, bool tag)
+    {
+        for (char c : value)
+        {
+            if (c == ',' || c == ' ' || (tag && c == '='))
+                out += '\\';
+            out += c;
+        }
+    }
+}
+
+metric::thread_slots::thread_slots() : orphaned(false)
+{
+    for (auto& chunk : chunks)
+        chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+metric::thread_slots::~thread_slots()
+{
+    for (auto& chunk : chunks)
+        delete[] chunk.load(std::memory_order_relaxed);
+}
+
+metric::slot_value* metric::thread_slots::allocate_chunk(uint32 index)
+{
+    slot_value* chunk = new slot_value[CHUNK_SLOTS];
+    for (uint32 i = 0; i < CHUNK_SLOTS; ++i)
+        chunk[i].store(0, std::memory_order_relaxed);
+
+    chunks[index].store(chunk, std::memory_order_release);
+    return chunk;
+}
+
+metric::registry& metric::registry::instance()
+{
+    // never destroyed, handles owned by other singletons release their series during exit
+    static registry* instance = new registry();
+    return *instance;
+}
+
+metric::thread_slots& metric::registry::local()
+{
+    if (!t_slots.slots)
+        instance().register_thread();
+
+    return *t_slots.slots;
+}
+
+metric::thread_slots* metric::registry::register_thread()
+{
+    t_slots.slots = std::make_shared<thread_slots>();
+
+    std::lock_guard<std::mutex> guard(m_threadsLock);
+    m_threads.push_back(t_slots.slots);
+    return t_slots.slots.get();
+}
+
+uint32 metric::registry::acquire(series_kind kind, std::string const& name, std::map<std::string, std::string> const& tags)
+{
+    std::string key;
+    escape(key, name, false);
+    for (auto const& tag : tags)
+    {
+        key += ',';
+        escape(key, tag.first, true);
+        key += '=';
+        escape(key, tag.second, true);
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_interned.find(key);
+    if (itr != m_interned.end())
+    {
+        series& existing = m_series[itr->second];
+        if (existing.kind != kind)
+        {
+            sLog.outError("metric::registry::acquire %s is already registered with another kind", key.c_str());
+            return INVALID_SLOT;
+        }
+
+        ++existing.refs;
+        return itr->second;
+    }
+
+    uint32 slot = allocate_slots(kind == SERIES_HISTOGRAM ? HISTOGRAM_SLOTS : 1);
+    if (slot == INVALID_SLOT)
+    {
+        sLog.outError("metric::registry::acquire out of slots, %s will not be recorded", key.c_str());
+        return INVALID_SLOT;
+    }
+
+    m_interned[key] = slot;
+    m_series[slot] = { key, kind, slot, 1 };
+    return slot;
+}
+
+void metric::registry::release(uint32 slot)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_series.find(slot);
+    if (itr != m_series.end() && itr->second.refs)
+        --itr->second.refs;                                 // slots are freed by collect after the final values went out
+}
+
+uint32 metric::registry::allocate_slots(uint32 count)
+{
+    std::vector<uint32>& freeSlots = count == 1 ? m_freeCounterSlots : m_freeHistogramSlots;
+    if (!freeSlots.empty())
+    {
+        uint32 slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    // a series never straddles two chunks, the rest of the chunk is left to counters
+    if (m_nextSlot % CHUNK_SLOTS + count > CHUNK_SLOTS)
+    {
+        while (m_nextSlot % CHUNK_SLOTS)
+            m_freeCounterSlots.push_back(m_nextSlot++);
+    }
+
+    if (m_nextSlot + count > MAX_SLOTS)
+        return INVALID_SLOT;
+
+    uint32 slot = m_nextSlot;
+    m_nextSlot += count;
+    return slot;
+}
+
+int64 metric::registry::percentile(int64 const* buckets, int64 count, int64 max, double quantile)
+{
+    int64 target = std::max(int64(1), int64(std::ceil(quantile * count)));
+    int64 seen = 0;
+    for (uint32 i = 0; i < HISTOGRAM_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+        {
+            // upper bound of the bucket, bucket i holds values [2^(i-1), 2^i - 1]
+            int64 upper = i ? (int64(1) << i) - 1 : 0;
+            return std::min(upper, max);
+        }
+    }
+
+    return max;
+}
+
+uint32 metric::registry::collect(std::stringstream& out, uint64 timestamp)
+{
+    std::vector<std::shared_ptr<thread_slots>> threads;
+    {
+        std::lock_guard<std::mutex> guard(m_threadsLock);
+        threads = m_threads;
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    // sum what every thread added since the last collect
+    m_totals.assign(m_nextSlot, 0);
+
+    std::vector<bool> finished(threads.size(), false);
+    for (size_t t = 0; t < threads.size(); ++t)
+    {
+        thread_slots& slots = *threads[t];
+        finished[t] = slots.orphaned.load(std::memory_order_acquire);
+
+        if (slots.reported.size() < m_nextSlot)
+            slots.reported.resize(m_nextSlot, 0);
+
+        for (auto const& itr : m_series)
+        {
+            series const& s = itr.second;
+            uint32 count = s.kind == SERIES_HISTOGRAM ? HISTOGRAM_SLOTS : 1;
+
+            slot_value* chunk = slots.chunks[s.slot / CHUNK_SLOTS].load(std::memory_order_acquire);
+            if (!chunk)
+                continue;
+
+            for (uint32 i = s.slot; i < s.slot + count; ++i)
+            {
+                slot_value& value = chunk[i % CHUNK_SLOTS];
+                if (s.kind == SERIES_HISTOGRAM && i == s.slot + HISTOGRAM_SLOT_MAX)
+                {
+                    m_totals[i] = std::max(m_totals[i], value.exchange(0, std::memory_order_relaxed));
+                    continue;
+                }
+
+                int64 current = value.load(std::memory_order_relaxed);
+                m_totals[i] += current - slots.reported[i];
+                slots.reported[i] = current;
+            }
+        }
+    }
+
+    uint32 lines = 0;
+    for (auto itr = m_series.begin(); itr != m_series.end();)
+    {
+        series const& s = itr->second;
+        int64 const* totals = &m_totals[s.slot];
+
+        if (s.kind == SERIES_COUNTER)
+        {
+            out << (lines ? "\n" : "") << s.key << " value=" << totals[0] << "i " << timestamp;
+            ++lines;
+        }
+        else if (int64 count = totals[HISTOGRAM_SLOT_COUNT])
+        {
+            int64 max = totals[HISTOGRAM_SLOT_MAX];
+            int64 const* buckets = totals + HISTOGRAM_SLOT_BUCKETS;
+
+            out << (lines ? "\n" : "") << s.key
+                << " count=" << count << "i"
+                << ",sum=" << totals[HISTOGRAM_SLOT_SUM] << "i"
+                << ",max=" << max << "i"
+                << ",p50=" << percentile(buckets, count, max, 0.50) << "i"
+                << ",p95=" << percentile(buckets, count, max, 0.95) << "i"
+                << ",p99=" << percentile(buckets, count, max, 0.99) << "i"
+                << " " << timestamp;
+            ++lines;
+        }
+
+        // released series are dropped once their last values are out
+        if (!s.refs)
+        {
+            std::vector<uint32>& freeSlots = s.kind == SERIES_HISTOGRAM ? m_freeHistogramSlots : m_freeCounterSlots;
+            freeSlots.push_back(s.slot);
+            m_interned.erase(s.key);
+            itr = m_series.erase(itr);
+        }
+        else
+            ++itr;
+    }
+
+    // everything an exited thread recorded has been summed above
+    {
+        std::lock_guard<std::mutex> threadsGuard(m_threadsLock);
+        for (size_t t = 0; t < threads.size(); ++t)
+            if (finished[t])
+                m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), threads[t]), m_threads.end());
+    }
+
+    return lines;
+}
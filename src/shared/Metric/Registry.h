@@ -0,0 +1,214 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_METRIC_REGISTRY_H
+#define MANGOSSERVER_METRIC_REGISTRY_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+
+// Pre-registered metric series. Name and tags are resolved once when a handle is created, after
+// that recording only touches a per thread slot array: no locks, no atomics read-modify-write and
+// no allocations. The metric sender thread sums all thread slots once per interval and emits line
+// protocol for every live series.
+namespace metric
+{
+    enum series_kind
+    {
+        SERIES_COUNTER,
+        SERIES_HISTOGRAM
+    };
+
+    // histogram slots: count, sum, max and one log2 bucket per bit of the recorded value
+    static constexpr uint32 HISTOGRAM_BUCKETS      = 32;
+    static constexpr uint32 HISTOGRAM_SLOT_COUNT   = 0;
+    static constexpr uint32 HISTOGRAM_SLOT_SUM     = 1;
+    static constexpr uint32 HISTOGRAM_SLOT_MAX     = 2;
+    static constexpr uint32 HISTOGRAM_SLOT_BUCKETS = 3;
+    static constexpr uint32 HISTOGRAM_SLOTS        = HISTOGRAM_SLOT_BUCKETS + HISTOGRAM_BUCKETS;
+
+    static constexpr uint32 CHUNK_SLOTS = 512;            // per thread storage is allocated in chunks on first use
+    static constexpr uint32 MAX_CHUNKS  = 64;
+    static constexpr uint32 MAX_SLOTS   = CHUNK_SLOTS * MAX_CHUNKS;
+    static constexpr uint32 INVALID_SLOT = 0xFFFFFFFF;
+
+    typedef std::atomic<int64> slot_value;
+
+    // written by the owning thread only, read by the aggregator
+    struct thread_slots
+    {
+        thread_slots();
+        ~thread_slots();
+
+        slot_value& get(uint32 slot)
+        {
+            slot_value* chunk = chunks[slot / CHUNK_SLOTS].load(std::memory_order_acquire);
+            if (!chunk)
+                chunk = allocate_chunk(slot / CHUNK_SLOTS);
+            return chunk[slot % CHUNK_SLOTS];
+        }
+
+        slot_value* allocate_chunk(uint32 index);
+
+        std::atomic<slot_value*> chunks[MAX_CHUNKS];
+        std::vector<int64> reported;                        // aggregator only, totals already emitted
+        std::atomic<bool> orphaned;                         // owning thread exited
+    };
+
+    class registry
+    {
+        public:
+            static registry& instance();
+
+            static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+            static void set_enabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+            uint32 acquire(series_kind kind, std::string const& name, std::map<std::string, std::string> const& tags);
+            void release(uint32 slot);
+
+            // appends one line protocol entry per live series, returns the number of entries
+            uint32 collect(std::stringstream& out, uint64 timestamp);
+
+            static thread_slots& local();
+
+        private:
+            struct series
+            {
+                std::string key;                            // interned name and tag set, line protocol escaped
+                series_kind kind;
+                uint32 slot;
+                uint32 refs;
+            };
+
+            uint32 allocate_slots(uint32 count);
+            thread_slots* register_thread();
+            static int64 percentile(int64 const* buckets, int64 count, int64 max, double quantile);
+
+            std::mutex m_lock;
+            std::unordered_map<std::string, uint32> m_interned;  // key -> first slot
+            std::map<uint32, series> m_series;                  // first slot -> series, ordered output
+            std::vector<uint32> m_freeCounterSlots;
+            std::vector<uint32> m_freeHistogramSlots;
+            uint32 m_nextSlot = 0;
+
+            std::mutex m_threadsLock;
+            std::vector<std::shared_ptr<thread_slots>> m_threads;
+
+            std::vector<int64> m_totals;                        // collect scratch, guarded by m_lock
+
+            static std::atomic<bool> s_enabled;
+    };
+
+    // monotonically increasing sum reported as its increase over the interval
+    class counter
+    {
+        public:
+            counter() : m_slot(INVALID_SLOT) {}
+            counter(std::string const& name, std::map<std::string, std::string> const& tags = {})
+                : m_slot(registry::instance().acquire(SERIES_COUNTER, name, tags)) {}
+            ~counter() { if (m_slot != INVALID_SLOT) registry::instance().release(m_slot); }
+
+            counter(counter&& other) noexcept : m_slot(other.m_slot) { other.m_slot = INVALID_SLOT; }
+            counter& operator=(counter&& other) noexcept { std::swap(m_slot, other.m_slot); return *this; }
+            counter(counter const&) = delete;
+            counter& operator=(counter const&) = delete;
+
+            void add(int64 value = 1) const
+            {
+                if (m_slot == INVALID_SLOT || !registry::enabled())
+                    return;
+
+                slot_value& slot = registry::local().get(m_slot);
+                slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+        private:
+            uint32 m_slot;
+    };
+
+    // distribution of non negative values, reported as count, sum, max and p50/p95/p99 per interval
+    class histogram
+    {
+        public:
+            histogram() : m_slot(INVALID_SLOT) {}
+            histogram(std::string const& name, std::map<std::string, std::string> const& tags = {})
+                : m_slot(registry::instance().acquire(SERIES_HISTOGRAM, name, tags)) {}
+            ~histogram() { if (m_slot != INVALID_SLOT) registry::instance().release(m_slot); }
+
+            histogram(histogram&& other) noexcept : m_slot(other.m_slot) { other.m_slot = INVALID_SLOT; }
+            histogram& operator=(histogram&& other) noexcept { std::swap(m_slot, other.m_slot); return *this; }
+            histogram(histogram const&) = delete;
+            histogram& operator=(histogram const&) = delete;
+
+            void record(int64 value) const
+            {
+                if (m_slot == INVALID_SLOT || !registry::enabled())
+                    return;
+
+                if (value < 0)
+                    value = 0;
+
+                uint32 bucket = 0;
+                for (uint64 v = uint64(value); v && bucket < HISTOGRAM_BUCKETS - 1; v >>= 1)
+                    ++bucket;
+
+                thread_slots& slots = registry::local();
+                increment(slots.get(m_slot + HISTOGRAM_SLOT_COUNT), 1);
+                increment(slots.get(m_slot + HISTOGRAM_SLOT_SUM), value);
+                increment(slots.get(m_slot + HISTOGRAM_SLOT_BUCKETS + bucket), 1);
+
+                // reset by the aggregator every interval, a concurrent reset may lose one sample's max
+                slot_value& max = slots.get(m_slot + HISTOGRAM_SLOT_MAX);
+                if (max.load(std::memory_order_relaxed) < value)
+                    max.store(value, std::memory_order_relaxed);
+            }
+
+        private:
+            static void increment(slot_value& slot, int64 value) { slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed); }
+
+            uint32 m_slot;
+    };
+
+    // records the lifetime of the scope into a histogram
+    template <class precision>
+    class scoped_timer
+    {
+        public:
+            explicit scoped_timer(histogram const& target) : m_target(target), m_startTime(std::chrono::steady_clock::now()) {}
+            ~scoped_timer()
+            {
+                auto elapsed = std::chrono::duration_cast<precision>(std::chrono::steady_clock::now() - m_startTime).count();
+                m_target.record(static_cast<int64>(elapsed));
+            }
+
+        private:
+            histogram const& m_target;
+            std::chrono::steady_clock::time_point m_startTime;
+    };
+}
+
+#endif // MANGOSSERVER_METRIC_REGISTRY_H
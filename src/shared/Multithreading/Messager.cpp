@@ -1 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
 #include "Messager.h"
+
+namespace
+{
+    struct SharedFreeNodes
+    {
+        std::atomic<MessageNode*> head { nullptr };
+
+        ~SharedFreeNodes()
+        {
+            MessageNode* node = head.exchange(nullptr);
+            while (node)
+            {
+                MessageNode* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+    };
+
+    SharedFreeNodes& GetSharedFreeNodes()
+    {
+        static SharedFreeNodes nodes;
+        return nodes;
+    }
+
+    void PushFreeNodes(MessageNode* first, MessageNode* last)
+    {
+        std::atomic<MessageNode*>& head = GetSharedFreeNodes().head;
+        MessageNode* oldHead = head.load(std::memory_order_relaxed);
+        do
+            last->next = oldHead;
+        while (!head.compare_exchange_weak(oldHead, first, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    struct ThreadFreeNodes
+    {
+        MessageNode* head = nullptr;
+
+        ~ThreadFreeNodes()
+        {
+            if (!head)
+                return;
+
+            MessageNode* last = head;
+            while (last->next)
+                last = last->next;
+            PushFreeNodes(head, last);
+        }
+    };
+
+    thread_local ThreadFreeNodes t_freeNodes;
+}
+
+MessageNode* MessageNodePool::Allocate()
+{
+    // only whole lists are taken from the shared stack, so popping is not prone to ABA
+    if (!t_freeNodes.head)
+        t_freeNodes.head = GetSharedFreeNodes().head.exchange(nullptr, std::memory_order_acquire);
+
+    if (MessageNode* node = t_freeNodes.head)
+    {
+        t_freeNodes.head = node->next;
+        return node;
+    }
+
+    return new MessageNode;
+}
+
+void MessageNodePool::Release(MessageNode* first, MessageNode* last)
+{
+    PushFreeNodes(first, last);
+}
@@ -19,34 +19,131 @@
 #ifndef MANGOS_MESSAGER_H
 #define MANGOS_MESSAGER_H
 
-#include <vector>
-#include <mutex>
-#include <functional>
+#include "Platform/Define.h"
 
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Intrusive queue entry of a Messager, the message functor is kept inline when it fits
+struct MessageNode
+{
+    static constexpr size_t INLINE_SIZE = 40;
+
+    MessageNode* next;
+    void (*invoke)(MessageNode* node, void* object);
+    void (*destroy)(MessageNode* node);
+    alignas(void*) unsigned char storage[INLINE_SIZE];
+};
+
+// Nodes are shared by all messagers and never freed, producers take them from a thread local cache refilled from the nodes executed messagers give back
+namespace MessageNodePool
+{
+    MessageNode* Allocate();
+    void Release(MessageNode* first, MessageNode* last);
+}
+
+/*
+  Lock free multi producer single consumer message queue. Producers push onto an intrusive stack, Execute takes the
+  whole stack at once and runs it in posting order, so messages added while executing run on the next Execute.
+*/
 template <class T>
 class Messager
 {
     public:
-        void AddMessage(const std::function<void(T*)>& message)
+        Messager() : m_head(nullptr), m_posted(0), m_executed(0), m_maxExecuted(0) {}
+        Messager(Messager const&) = delete;
+        Messager& operator=(Messager const&) = delete;
+
+        ~Messager()
         {
-            std::lock_guard<std::mutex> guard(m_messageMutex);
-            m_messageVector.push_back(message);
+            MessageNode* node = m_head.exchange(nullptr, std::memory_order_acquire);
+            while (node)
+            {
+                MessageNode* next = node->next;
+                node->destroy(node);
+                delete node;
+                node = next;
+            }
         }
-        void Execute(T* object)
+
+        template <class F>
+        void AddMessage(F&& message)
         {
-            std::vector<std::function<void(T*)>> messageVectorCopy;
+            typedef typename std::decay<F>::type Functor;
+            typedef std::integral_constant<bool, sizeof(Functor) <= MessageNode::INLINE_SIZE && alignof(Functor) <= alignof(void*)> FitsInline;
+
+            MessageNode* node = MessageNodePool::Allocate();
+            Store<Functor>(node, std::forward<F>(message), FitsInline());
+
+            MessageNode* head = m_head.load(std::memory_order_relaxed);
+            do
+                node->next = head;
+            while (!m_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+
+            m_posted.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // returns the number of executed messages
+        uint32 Execute(T* object)
+        {
+            MessageNode* node = m_head.exchange(nullptr, std::memory_order_acquire);
+            if (!node)
+                return 0;
+
+            // the stack holds the latest message first
+            MessageNode* last = node;
+            MessageNode* first = nullptr;
+            while (node)
+            {
+                MessageNode* next = node->next;
+                node->next = first;
+                first = node;
+                node = next;
+            }
+
+            uint32 count = 0;
+            for (node = first; node; node = node->next, ++count)
             {
-                std::lock_guard<std::mutex> guard(m_messageMutex);
-                std::swap(m_messageVector, messageVectorCopy);
+                node->invoke(node, object);
+                node->destroy(node);
             }
-            for (auto& message : messageVectorCopy)
-                message(object);
 
-            messageVectorCopy.clear();
+            MessageNodePool::Release(first, last);
+
+            m_executed.fetch_add(count, std::memory_order_relaxed);
+            if (count > m_maxExecuted.load(std::memory_order_relaxed))
+                m_maxExecuted.store(count, std::memory_order_relaxed);
+            return count;
         }
+
+        // traffic counters, can be read from any thread
+        uint64 GetPostedCount() const { return m_posted.load(std::memory_order_relaxed); }
+        uint64 GetExecutedCount() const { return m_executed.load(std::memory_order_relaxed); }
+        uint32 GetMaxExecuteCount() const { return m_maxExecuted.load(std::memory_order_relaxed); }
+
     private:
-        std::vector<std::function<void(T*)>> m_messageVector;
-        std::mutex m_messageMutex;  
+        template <class Functor, class F>
+        static void Store(MessageNode* node, F&& message, std::true_type /*inline*/)
+        {
+            new (node->storage) Functor(std::forward<F>(message));
+            node->invoke = [](MessageNode* node, void* object) { (*reinterpret_cast<Functor*>(node->storage))(static_cast<T*>(object)); };
+            node->destroy = [](MessageNode* node) { reinterpret_cast<Functor*>(node->storage)->~Functor(); };
+        }
+
+        template <class Functor, class F>
+        static void Store(MessageNode* node, F&& message, std::false_type /*inline*/)
+        {
+            new (node->storage) Functor*(new Functor(std::forward<F>(message)));
+            node->invoke = [](MessageNode* node, void* object) { (**reinterpret_cast<Functor**>(node->storage))(static_cast<T*>(object)); };
+            node->destroy = [](MessageNode* node) { delete *reinterpret_cast<Functor**>(node->storage); };
+        }
+
+        std::atomic<MessageNode*> m_head;
+        std::atomic<uint64> m_posted;
+        std::atomic<uint64> m_executed;
+        std::atomic<uint32> m_maxExecuted;                  // most messages run by a single Execute
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -20,6 +20,7 @@
 #define __NETWORK_THREAD_HPP_
 
 #include "Socket.hpp"
+#include "Database/SqlQueryStats.h"
 
 #include <boost/asio.hpp>
 
@@ -44,7 +45,7 @@ namespace MaNGOS
             std::thread m_serviceThread;
 
         public:
-            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { boost::system::error_code ec; this->m_service.run(ec); })
+            NetworkThread() : m_work(new boost::asio::io_service::work(m_service)), m_serviceThread([this] { SetSqlThreadRole(SQL_THREAD_NETWORK); boost::system::error_code ec; this->m_service.run(ec); })
             {
                 m_serviceThread.detach();
             }
@@ -16,6 +16,7 @@
 #include "WheatyExceptionReport.h"
 #include "revision.h"
 #include "common.h"
+#include "Log.h"
 #define CrashFolder _T("Crashes")
 //#pragma comment(linker, "/defaultlib:dbghelp.lib")
 
@@ -109,6 +110,9 @@ LONG WINAPI WheatyExceptionReport::WheatyUnhandledExceptionFilter(
         m_hReportFile = nullptr;
     }
 
+    // write out log messages still queued for the async log writer
+    sLog.FlushOnCrash();
+
     if (m_previousFilter)
         return m_previousFilter(pExceptionInfo);
     return EXCEPTION_EXECUTE_HANDLER/*EXCEPTION_CONTINUE_SEARCH*/;
@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "ByteBuffer.h"
 #include "Server/Opcodes.h"
+#include "Server/PacketSizeStats.h"
 #include <chrono>
 
 // Note: m_opcode and size stored in platfom dependent format
@@ -30,23 +31,41 @@ class WorldPacket : public ByteBuffer
 {
     public:
         // just container for later use
-        WorldPacket()                                       : ByteBuffer(0), m_opcode(MSG_NULL_ACTION)
+        WorldPacket()                                       : ByteBuffer(0), m_opcode(MSG_NULL_ACTION), m_requestedSize(0), m_reservedSize(0), m_sizeCounted(false)
         {
         }
-        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(res), m_opcode(opcode) { }
-        // copy constructor
-        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode)
+        explicit WorldPacket(Opcodes opcode, size_t res = 200) : ByteBuffer(0), m_opcode(opcode),
+            m_requestedSize(res), m_reservedSize(sPacketSizeStats.GetReserve(opcode, res)), m_sizeCounted(true)
+        {
+            _storage.reserve(m_reservedSize);
+        }
+        // copy constructor, only the original counts for the size statistics
+        WorldPacket(const WorldPacket& packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_requestedSize(0), m_reservedSize(0), m_sizeCounted(false)
         {
         }
         WorldPacket(const WorldPacket& packet, std::chrono::steady_clock::time_point receivedTime) : ByteBuffer(packet), 
-            m_opcode(packet.m_opcode), m_receivedTime(receivedTime)
+            m_opcode(packet.m_opcode), m_receivedTime(receivedTime), m_requestedSize(0), m_reservedSize(0), m_sizeCounted(false)
+        {
+        }
+        ~WorldPacket() { RecordSize(); }
+
+        WorldPacket& operator=(const WorldPacket& packet)
         {
+            RecordSize();
+            ByteBuffer::operator=(packet);
+            m_opcode = packet.m_opcode;
+            m_receivedTime = packet.m_receivedTime;
+            return *this;
         }
 
         void Initialize(Opcodes opcode, size_t newres = 200)
         {
+            RecordSize();
             clear();
-            _storage.reserve(newres);
+            m_requestedSize = newres;
+            m_reservedSize = sPacketSizeStats.GetReserve(opcode, newres);
+            m_sizeCounted = true;
+            _storage.reserve(m_reservedSize);
             m_opcode = opcode;
         }
 
@@ -58,7 +77,18 @@ class WorldPacket : public ByteBuffer
         void SetReceivedTime(std::chrono::steady_clock::time_point receivedTime) { m_receivedTime = receivedTime; }
 
     protected:
+        // packets built for an opcode feed the size statistics once, when they are done
+        void RecordSize()
+        {
+            if (m_sizeCounted)
+                sPacketSizeStats.Record(m_opcode, size(), m_requestedSize, m_reservedSize);
+            m_sizeCounted = false;
+        }
+
         Opcodes m_opcode;
         std::chrono::steady_clock::time_point m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
+        size_t m_requestedSize;                             // reserve asked for by the builder
+        size_t m_reservedSize;                              // reserve the packet got
+        bool m_sizeCounted;
 };
 #endif